@@ -8,20 +8,39 @@ function(add_shader_library TARGET)
     elseif (ARG_HLSL)
         set(GLSLC_LANG hlsl)
     endif()
+    # O glslc lista os arquivos incluídos num depfile, para que
+    # mudar um .glsl recompile os shaders que o incluem. Antes do
+    # CMake 3.20 só o Ninja lê depfiles; nos outros geradores,
+    # cada shader depende de todos os .glsl da sua pasta.
+    if (CMAKE_GENERATOR MATCHES "Ninja" OR
+        CMAKE_VERSION VERSION_GREATER_EQUAL 3.20)
+        set(USE_DEPFILE TRUE)
+    endif()
     foreach(SHADER ${ARG_SOURCES})
         get_filename_component(FILENAME ${SHADER} NAME)
         set(OUTPUT_SHADER ${CMAKE_CURRENT_BINARY_DIR}/${FILENAME}.spv)
         set(COMPILED_SHADERS ${COMPILED_SHADERS} ${OUTPUT_SHADER})
         set(COMPILED_SHADERS ${COMPILED_SHADERS} PARENT_SCOPE)
+        if (USE_DEPFILE)
+            set(DEPENDENCIES DEPFILE ${OUTPUT_SHADER}.d)
+            set(DEPFILE_FLAGS -MD -MF ${OUTPUT_SHADER}.d)
+        else()
+            get_filename_component(SHADER_DIR ${SHADER} DIRECTORY)
+            file(GLOB INCLUDES ${SHADER_DIR}/*.glsl)
+            set(DEPENDENCIES DEPENDS ${INCLUDES})
+            set(DEPFILE_FLAGS)
+        endif()
         add_custom_command(
             OUTPUT ${OUTPUT_SHADER}
             DEPENDS ${SHADER}
+            ${DEPENDENCIES}
             COMMENT "Compiling shader '${OUTPUT_SHADER}'"
             COMMAND
                 ${GLSLC_EXECUTABLE}
                 $<$<BOOL:${ARG_ENV}>:--target-env=${ARG_ENV}>
                 $<$<BOOL:${ARG_FORMAT}>:-mfmt=${ARG_FORMAT}>
                 $<$<BOOL:${GLSLC_LANG}>:-x${GLSLC_LANG}>
+                ${DEPFILE_FLAGS}
                 -o ${OUTPUT_SHADER}
                 ${SHADER}
         )
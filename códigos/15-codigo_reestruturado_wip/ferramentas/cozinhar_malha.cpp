@@ -0,0 +1,68 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "importador_obj.hpp"
+#include "malha_cozida.hpp"
+#include "meshlets.hpp"
+#include "otimizacao_de_malha.hpp"
+#include "simplificacao_de_malha.hpp"
+
+// Uso: cozinhar_malha <entrada.obj> <saida.malha>
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Uso: " << argv[0]
+                  << " <entrada.obj> <saida.malha>"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        std::vector<smv::Vertice> vertices;
+        std::vector<uint32_t> indices;
+        smv::importarObj(argv[1], vertices, indices);
+
+        smv::imprimirEstatisticasDeCache(
+            "Antes da otimização",
+            smv::analisarCacheDeVertices(indices,
+                                         vertices.size()));
+        smv::otimizarMalha(vertices, indices);
+        smv::imprimirEstatisticasDeCache(
+            "Depois da otimização",
+            smv::analisarCacheDeVertices(indices,
+                                         vertices.size()));
+
+        auto niveis = smv::juntarNiveis(
+            smv::gerarNiveisDeDetalhe(vertices, indices),
+            indices);
+        // O motor escolhe o nível menos detalhado com erro
+        // aceitável, então um nível com o erro do seguinte
+        // nunca seria usado.
+        for (size_t i = 2; i < niveis.size(); i++) {
+            if (niveis[i].erro <= niveis[i - 1].erro) {
+                throw std::logic_error(
+                    "O erro do nível " + std::to_string(i) +
+                    " não é maior que o do anterior.");
+            }
+        }
+        auto meshlets =
+            smv::gerarMeshlets(vertices, indices, niveis);
+        for (size_t i = 0; i < niveis.size(); i++) {
+            std::cout << "Nível " << i << ": "
+                      << niveis[i].numIndices / 3
+                      << " triângulos, erro " << niveis[i].erro
+                      << ", " << niveis[i].numMeshlets
+                      << " meshlets" << std::endl;
+        }
+
+        smv::escreverMalhaCozida(argv[2], vertices, indices,
+                                 niveis, meshlets);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#pragma GCC diagnostic pop
+
+#include "compressao_bc.hpp"
+#include "textura_ktx2.hpp"
+
+namespace {
+struct Imagem {
+    std::vector<uint8_t> texels;
+    uint32_t largura;
+    uint32_t altura;
+};
+
+float srgbParaLinear(float valor) {
+    return valor <= 0.04045f
+               ? valor / 12.92f
+               : std::pow((valor + 0.055f) / 1.055f, 2.4f);
+}
+
+uint8_t linearParaSrgb(float valor) {
+    float srgb = valor <= 0.0031308f
+                     ? valor * 12.92f
+                     : 1.055f * std::pow(valor, 1.0f / 2.4f) -
+                           0.055f;
+    return static_cast<uint8_t>(
+        std::clamp(srgb * 255.0f + 0.5f, 0.0f, 255.0f));
+}
+
+// Reduz à metade com um filtro de caixa 2x2. A cor é somada em
+// espaço linear, senão os níveis menores escurecem.
+Imagem reduzir(const Imagem& imagem) {
+    static const auto kLinear = [] {
+        std::array<float, 256> tabela;
+        for (size_t i = 0; i < tabela.size(); i++) {
+            tabela[i] = srgbParaLinear(static_cast<float>(i) /
+                                       255.0f);
+        }
+        return tabela;
+    }();
+
+    Imagem reduzida;
+    reduzida.largura = std::max(imagem.largura / 2, 1u);
+    reduzida.altura = std::max(imagem.altura / 2, 1u);
+    reduzida.texels.resize(size_t{reduzida.largura} *
+                           reduzida.altura * 4);
+    for (uint32_t y = 0; y < reduzida.altura; y++) {
+        for (uint32_t x = 0; x < reduzida.largura; x++) {
+            std::array<float, 4> soma{};
+            for (uint32_t dy = 0; dy < 2; dy++) {
+                for (uint32_t dx = 0; dx < 2; dx++) {
+                    uint32_t ox = std::min(2 * x + dx,
+                                           imagem.largura - 1);
+                    uint32_t oy = std::min(2 * y + dy,
+                                           imagem.altura - 1);
+                    const uint8_t* texel =
+                        &imagem.texels[(size_t{oy} *
+                                            imagem.largura +
+                                        ox) *
+                                       4];
+                    for (size_t c = 0; c < 3; c++) {
+                        soma[c] += kLinear[texel[c]];
+                    }
+                    soma[3] += static_cast<float>(texel[3]);
+                }
+            }
+            uint8_t* destino =
+                &reduzida.texels[(size_t{y} * reduzida.largura +
+                                  x) *
+                                 4];
+            for (size_t c = 0; c < 3; c++) {
+                destino[c] = linearParaSrgb(soma[c] / 4.0f);
+            }
+            destino[3] = static_cast<uint8_t>(
+                std::lround(soma[3] / 4.0f));
+        }
+    }
+    return reduzida;
+}
+
+vk::Format formatoPeloNome(const std::string& nome) {
+    if (nome == "bc1") {
+        return vk::Format::eBc1RgbSrgbBlock;
+    }
+    if (nome == "bc3") {
+        return vk::Format::eBc3SrgbBlock;
+    }
+    if (nome == "bc7") {
+        return vk::Format::eBc7SrgbBlock;
+    }
+    throw std::runtime_error("Formato desconhecido '" + nome +
+                             "'.");
+}
+}  // namespace
+
+// Uso: cozinhar_textura <entrada> <saida.ktx2> [bc1|bc3|bc7]
+int main(int argc, char** argv) {
+    if (argc != 3 && argc != 4) {
+        std::cerr << "Uso: " << argv[0]
+                  << " <entrada> <saida.ktx2> [bc1|bc3|bc7]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        auto formato = formatoPeloNome(argc == 4 ? argv[3]
+                                                 : "bc7");
+
+        int largura, altura, _canais;
+        stbi_uc* pixels = stbi_load(argv[1], &largura, &altura,
+                                    &_canais, STBI_rgb_alpha);
+        if (pixels == nullptr) {
+            throw std::runtime_error(
+                std::string("Não foi possível carregar a "
+                            "imagem '") +
+                argv[1] + "'.");
+        }
+        Imagem imagem;
+        imagem.largura = static_cast<uint32_t>(largura);
+        imagem.altura = static_cast<uint32_t>(altura);
+        imagem.texels.assign(
+            pixels, pixels + size_t{imagem.largura} *
+                                 imagem.altura * 4);
+        stbi_image_free(pixels);
+
+        // A cadeia inteira, até o nível de 1x1.
+        std::vector<std::vector<uint8_t>> niveis;
+        size_t bytesDescomprimidos = 0;
+        for (Imagem nivel = imagem;; nivel = reduzir(nivel)) {
+            niveis.push_back(
+                smv::comprimirBc(formato, nivel.texels.data(),
+                                 nivel.largura, nivel.altura));
+            bytesDescomprimidos += nivel.texels.size();
+            if (nivel.largura == 1 && nivel.altura == 1) {
+                break;
+            }
+        }
+
+        smv::escreverTexturaKtx2(argv[2], formato,
+                                 imagem.largura, imagem.altura,
+                                 niveis);
+
+        size_t bytesComprimidos = 0;
+        for (const auto& nivel : niveis) {
+            bytesComprimidos += nivel.size();
+        }
+        std::cout << niveis.size() << " níveis, "
+                  << bytesDescomprimidos << " bytes em RGBA8, "
+                  << bytesComprimidos << " bytes comprimidos"
+                  << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
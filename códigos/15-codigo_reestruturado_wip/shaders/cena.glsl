@@ -0,0 +1,46 @@
+// A cena desenhada pela GPU: os objetos e a tabela das malhas
+// do pool, lidos pelo passe que escolhe os desenhos e pelos
+// shaders de vértices. Os desenhos escolhidos pela CPU leem as
+// instâncias do quadro. O layout é o de app.hpp.
+
+struct NivelDaMalha {
+  uint primeiroIndice;
+  uint numIndices;
+  float erro;
+  uint primeiroMeshlet;
+  uint numMeshlets;
+};
+
+struct MalhaDaCena {
+  vec4 escalaDaPosicao;
+  vec4 minimoDaPosicao;
+  vec4 dequantizacaoDaCoordTex;
+  // Centro e raio, no espaço da malha.
+  vec4 esfera;
+  uint primeiroIndice;
+  int deslocamentoDeVertice;
+  uint indices16;
+  uint numNiveis;
+  NivelDaMalha niveis[8];
+};
+
+struct Instancia {
+  mat4 modelo;
+  vec4 tonalidade;
+  uint malha;
+  uint material;
+  uint reservado0;
+  uint reservado1;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer Objetos {
+  Instancia objetos[];
+};
+
+layout(std430, set = 1, binding = 1) readonly buffer Malhas {
+  MalhaDaCena malhas[];
+};
+
+layout(std430, set = 1, binding = 4) readonly buffer Instancias {
+  Instancia instancias[];
+};
@@ -0,0 +1,47 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+// Passe prévio de profundidade. Só lê o fluxo de posições e
+// calcula gl_Position exatamente como shader.vert.
+layout(location = 0) in vec3 posicao;
+
+layout(push_constant) uniform Constantes {
+  mat4 modelo;
+  vec4 escalaDaPosicao;
+  vec4 minimoDaPosicao;
+  vec4 dequantizacaoDaCoordTex;
+}
+constantes;
+
+layout(binding = 0) uniform OBU {
+  mat4 visao;
+  mat4 projecao;
+}
+obu;
+
+layout(constant_id = 0) const bool kCenaNaGpu = false;
+#include "cena.glsl"
+
+invariant gl_Position;
+
+void main() {
+  Instancia instancia;
+  if (kCenaNaGpu) {
+    instancia = objetos[gl_InstanceIndex];
+  } else {
+    instancia = instancias[gl_InstanceIndex];
+  }
+  mat4 modelo = instancia.modelo * constantes.modelo;
+  vec4 escalaDaPosicao = constantes.escalaDaPosicao;
+  vec4 minimoDaPosicao = constantes.minimoDaPosicao;
+  if (kCenaNaGpu) {
+    uint m = instancia.malha;
+    escalaDaPosicao = malhas[m].escalaDaPosicao;
+    minimoDaPosicao = malhas[m].minimoDaPosicao;
+  }
+  vec3 posicaoNaMalha =
+      posicao * escalaDaPosicao.xyz + minimoDaPosicao.xyz;
+
+  gl_Position = obu.projecao * obu.visao * modelo *
+                vec4(posicaoNaMalha, 1.0);
+}
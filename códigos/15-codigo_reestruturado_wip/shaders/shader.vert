@@ -1,10 +1,18 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
 layout(location = 0) in vec3 posicao;
 layout(location = 1) in vec3 cor;
 layout(location = 2) in vec2 coordTex;
 
-layout(push_constant) uniform Constantes { mat4 modelo; }
+// Os vértices compactos chegam normalizados e voltam à escala
+// da malha com a dequantização. Nos completos ela é neutra.
+layout(push_constant) uniform Constantes {
+  mat4 modelo;
+  vec4 escalaDaPosicao;
+  vec4 minimoDaPosicao;
+  vec4 dequantizacaoDaCoordTex;
+}
 constantes;
 
 layout(binding = 0) uniform OBU {
@@ -13,12 +21,43 @@ layout(binding = 0) uniform OBU {
 }
 obu;
 
+// A transformação e a tonalidade de cada instância vêm do
+// buffer de instâncias do quadro. Na cena desenhada pela GPU,
+// elas vêm do objeto na primeira instância do comando
+// indireto, e a dequantização vem da malha dele. As push
+// constants trazem a transformação da cena.
+layout(constant_id = 0) const bool kCenaNaGpu = false;
+#include "cena.glsl"
+
 layout(location = 0) out vec3 fragCor;
 layout(location = 1) out vec2 fragCoordTex;
 
+// Tem de bater exatamente com a profundidade do passe prévio.
+invariant gl_Position;
+
 void main() {
-  fragCor = cor;
-  fragCoordTex = coordTex;
-  gl_Position =
-      obu.projecao * obu.visao * constantes.modelo * vec4(posicao, 1.0);
+  Instancia instancia;
+  if (kCenaNaGpu) {
+    instancia = objetos[gl_InstanceIndex];
+  } else {
+    instancia = instancias[gl_InstanceIndex];
+  }
+  mat4 modelo = instancia.modelo * constantes.modelo;
+  vec4 escalaDaPosicao = constantes.escalaDaPosicao;
+  vec4 minimoDaPosicao = constantes.minimoDaPosicao;
+  vec4 dequantizacaoDaCoordTex = constantes.dequantizacaoDaCoordTex;
+  if (kCenaNaGpu) {
+    uint m = instancia.malha;
+    escalaDaPosicao = malhas[m].escalaDaPosicao;
+    minimoDaPosicao = malhas[m].minimoDaPosicao;
+    dequantizacaoDaCoordTex = malhas[m].dequantizacaoDaCoordTex;
+  }
+  vec3 posicaoNaMalha =
+      posicao * escalaDaPosicao.xyz + minimoDaPosicao.xyz;
+
+  fragCor = cor * instancia.tonalidade.rgb;
+  fragCoordTex = coordTex * dequantizacaoDaCoordTex.xy +
+                 dequantizacaoDaCoordTex.zw;
+  gl_Position = obu.projecao * obu.visao * modelo *
+                vec4(posicaoNaMalha, 1.0);
 }
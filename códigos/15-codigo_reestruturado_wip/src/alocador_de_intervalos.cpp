@@ -0,0 +1,196 @@
+#include "alocador_de_intervalos.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace smv {
+EstatisticasDeIntervalos& EstatisticasDeIntervalos::operator+=(
+    const EstatisticasDeIntervalos& outras) {
+    tamanhoTotal += outras.tamanhoTotal;
+    bytesUsados += outras.bytesUsados;
+    bytesLivres += outras.bytesLivres;
+    maiorIntervaloLivre = std::max(maiorIntervaloLivre,
+                                   outras.maiorIntervaloLivre);
+    numIntervalosUsados += outras.numIntervalosUsados;
+    numIntervalosLivres += outras.numIntervalosLivres;
+    return *this;
+}
+
+AlocadorDeIntervalos::AlocadorDeIntervalos(
+    uint64_t tamanho,
+    uint64_t granularidade)
+    : tamanho_(tamanho),
+      granularidade_(std::max<uint64_t>(granularidade, 1)) {
+    regioes_[0] = Regiao{tamanho, 0, true};
+    livresPorTamanho_.emplace(tamanho, 0);
+}
+
+std::optional<uint64_t> AlocadorDeIntervalos::alocar(
+    uint64_t tamanho,
+    uint64_t alinhamento,
+    uint32_t categoria) {
+    if (tamanho == 0) {
+        return {};
+    }
+    alinhamento = std::max<uint64_t>(alinhamento, 1);
+
+    // Menor intervalo livre em que a alocação cabe depois de
+    // aplicar o alinhamento e a granularidade.
+    for (auto candidato =
+             livresPorTamanho_.lower_bound(tamanho);
+         candidato != livresPorTamanho_.end(); candidato++) {
+        auto regiao = regioes_.find(candidato->second);
+        auto deslocamento =
+            encaixar(regiao, tamanho, alinhamento, categoria);
+        if (!deslocamento.has_value()) {
+            continue;
+        }
+
+        uint64_t inicio = regiao->first;
+        uint64_t fim = inicio + regiao->second.tamanho;
+        uint64_t fimAlocado = deslocamento.value() + tamanho;
+
+        livresPorTamanho_.erase(candidato);
+        regioes_.erase(regiao);
+        if (deslocamento.value() > inicio) {
+            inserirLivre(inicio, deslocamento.value() - inicio);
+        }
+        regioes_[deslocamento.value()] =
+            Regiao{tamanho, categoria, false};
+        if (fimAlocado < fim) {
+            inserirLivre(fimAlocado, fim - fimAlocado);
+        }
+
+        bytesUsados_ += tamanho;
+        numOcupados_++;
+        return deslocamento;
+    }
+
+    return {};
+}
+
+std::optional<uint64_t> AlocadorDeIntervalos::encaixar(
+    Regioes::const_iterator regiao,
+    uint64_t tamanho,
+    uint64_t alinhamento,
+    uint32_t categoria) const {
+    uint64_t inicio = regiao->first;
+    uint64_t fim = inicio + regiao->second.tamanho;
+    uint64_t deslocamento =
+        alinharParaCima(inicio, alinhamento);
+
+    if (regiao != regioes_.begin()) {
+        const auto& anterior = *std::prev(regiao);
+        uint64_t ultimoByteAnterior =
+            anterior.first + anterior.second.tamanho - 1;
+        if (anterior.second.categoria != categoria &&
+            mesmaPagina(ultimoByteAnterior, deslocamento)) {
+            deslocamento = alinharParaCima(
+                alinharParaCima(deslocamento, granularidade_),
+                alinhamento);
+        }
+    }
+
+    if (deslocamento + tamanho > fim) {
+        return {};
+    }
+
+    auto proxima = std::next(regiao);
+    if (proxima != regioes_.end() &&
+        proxima->second.categoria != categoria &&
+        mesmaPagina(deslocamento + tamanho - 1,
+                    proxima->first)) {
+        return {};
+    }
+
+    return deslocamento;
+}
+
+bool AlocadorDeIntervalos::mesmaPagina(uint64_t a,
+                                       uint64_t b) const {
+    return a / granularidade_ == b / granularidade_;
+}
+
+void AlocadorDeIntervalos::liberar(uint64_t deslocamento) {
+    auto regiao = regioes_.find(deslocamento);
+    if (regiao == regioes_.end() || regiao->second.livre) {
+        throw std::logic_error(
+            "Liberação de um intervalo que não está alocado.");
+    }
+
+    uint64_t inicio = regiao->first;
+    uint64_t tamanho = regiao->second.tamanho;
+    bytesUsados_ -= tamanho;
+    numOcupados_--;
+
+    auto proxima = std::next(regiao);
+    if (proxima != regioes_.end() && proxima->second.livre) {
+        tamanho += proxima->second.tamanho;
+        removerLivre(proxima->first, proxima->second.tamanho);
+        regioes_.erase(proxima);
+    }
+
+    if (regiao != regioes_.begin()) {
+        auto anterior = std::prev(regiao);
+        if (anterior->second.livre) {
+            inicio = anterior->first;
+            tamanho += anterior->second.tamanho;
+            removerLivre(anterior->first,
+                         anterior->second.tamanho);
+            regioes_.erase(anterior);
+        }
+    }
+
+    regioes_.erase(deslocamento);
+    inserirLivre(inicio, tamanho);
+}
+
+void AlocadorDeIntervalos::inserirLivre(uint64_t deslocamento,
+                                        uint64_t tamanho) {
+    // Regiões livres não têm categoria, para que não
+    // imponham granularidade às vizinhas.
+    regioes_[deslocamento] =
+        Regiao{tamanho, kSemCategoria, true};
+    livresPorTamanho_.emplace(tamanho, deslocamento);
+}
+
+void AlocadorDeIntervalos::removerLivre(uint64_t deslocamento,
+                                        uint64_t tamanho) {
+    auto [comeco, fim] = livresPorTamanho_.equal_range(tamanho);
+    for (auto i = comeco; i != fim; i++) {
+        if (i->second == deslocamento) {
+            livresPorTamanho_.erase(i);
+            return;
+        }
+    }
+}
+
+EstatisticasDeIntervalos AlocadorDeIntervalos::estatisticas()
+    const {
+    EstatisticasDeIntervalos estatisticas;
+    estatisticas.tamanhoTotal = tamanho_;
+    estatisticas.bytesUsados = bytesUsados_;
+    estatisticas.bytesLivres = tamanho_ - bytesUsados_;
+    estatisticas.numIntervalosUsados = numOcupados_;
+    estatisticas.numIntervalosLivres =
+        static_cast<uint32_t>(livresPorTamanho_.size());
+    if (!livresPorTamanho_.empty()) {
+        estatisticas.maiorIntervaloLivre =
+            livresPorTamanho_.rbegin()->first;
+    }
+    return estatisticas;
+}
+
+std::vector<AlocadorDeIntervalos::Intervalo>
+AlocadorDeIntervalos::intervalosOcupados() const {
+    std::vector<Intervalo> intervalos;
+    intervalos.reserve(numOcupados_);
+    for (const auto& [deslocamento, regiao] : regioes_) {
+        if (!regiao.livre) {
+            intervalos.push_back({deslocamento, regiao.tamanho,
+                                  regiao.categoria});
+        }
+    }
+    return intervalos;
+}
+}  // namespace smv
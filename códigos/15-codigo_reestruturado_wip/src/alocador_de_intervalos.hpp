@@ -0,0 +1,94 @@
+#ifndef SMV_ALOCADOR_DE_INTERVALOS_HPP
+#define SMV_ALOCADOR_DE_INTERVALOS_HPP
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace smv {
+struct EstatisticasDeIntervalos {
+    uint64_t tamanhoTotal = 0;
+    uint64_t bytesUsados = 0;
+    uint64_t bytesLivres = 0;
+    uint64_t maiorIntervaloLivre = 0;
+    uint32_t numIntervalosUsados = 0;
+    uint32_t numIntervalosLivres = 0;
+
+    // 0 quando todo o espaço livre é contíguo, tendendo a 1
+    // quando está espalhado em vários pedaços pequenos.
+    float fragmentacao() const {
+        if (bytesLivres == 0) {
+            return 0.0f;
+        }
+        return 1.0f - static_cast<float>(maiorIntervaloLivre) /
+                          static_cast<float>(bytesLivres);
+    }
+
+    EstatisticasDeIntervalos& operator+=(
+        const EstatisticasDeIntervalos& outras);
+};
+
+// Sub-aloca intervalos de um espaço linear usando uma lista
+// livre ordenada com escolha do menor intervalo adequado e
+// junção de vizinhos na liberação.
+//
+// Intervalos de categorias diferentes nunca dividem uma
+// mesma "página" de tamanho `granularidade`, o que permite
+// respeitar o bufferImageGranularity da Vulkan.
+class AlocadorDeIntervalos {
+  public:
+    struct Intervalo {
+        uint64_t deslocamento;
+        uint64_t tamanho;
+        uint32_t categoria;
+    };
+
+    explicit AlocadorDeIntervalos(uint64_t tamanho,
+                                  uint64_t granularidade = 1);
+
+    std::optional<uint64_t> alocar(uint64_t tamanho,
+                                   uint64_t alinhamento,
+                                   uint32_t categoria = 0);
+    void liberar(uint64_t deslocamento);
+
+    bool vazio() const { return numOcupados_ == 0; }
+    uint64_t tamanho() const { return tamanho_; }
+    EstatisticasDeIntervalos estatisticas() const;
+    std::vector<Intervalo> intervalosOcupados() const;
+
+  private:
+    static constexpr uint32_t kSemCategoria = UINT32_MAX;
+
+    struct Regiao {
+        uint64_t tamanho;
+        uint32_t categoria;
+        bool livre;
+    };
+    using Regioes = std::map<uint64_t, Regiao>;
+
+    std::optional<uint64_t> encaixar(
+        Regioes::const_iterator regiao,
+        uint64_t tamanho,
+        uint64_t alinhamento,
+        uint32_t categoria) const;
+    bool mesmaPagina(uint64_t a, uint64_t b) const;
+    void inserirLivre(uint64_t deslocamento, uint64_t tamanho);
+    void removerLivre(uint64_t deslocamento, uint64_t tamanho);
+
+    uint64_t tamanho_;
+    uint64_t granularidade_;
+    uint64_t bytesUsados_ = 0;
+    uint32_t numOcupados_ = 0;
+    Regioes regioes_;
+    std::multimap<uint64_t, uint64_t> livresPorTamanho_;
+};
+
+inline uint64_t alinharParaCima(uint64_t valor,
+                                uint64_t alinhamento) {
+    return (valor + alinhamento - 1) / alinhamento *
+           alinhamento;
+}
+}  // namespace smv
+
+#endif
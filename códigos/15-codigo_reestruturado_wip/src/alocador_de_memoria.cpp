@@ -0,0 +1,274 @@
+#include "alocador_de_memoria.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace smv {
+struct BlocoDeMemoria {
+    BlocoDeMemoria(vk::DeviceMemory memoria,
+                   void* mapeamento,
+                   vk::DeviceSize tamanho,
+                   vk::DeviceSize granularidade)
+        : memoria(memoria),
+          mapeamento(mapeamento),
+          intervalos(tamanho, granularidade) {}
+
+    vk::DeviceMemory memoria;
+    void* mapeamento;
+    AlocadorDeIntervalos intervalos;
+};
+
+void AlocadorDeMemoria::iniciar(
+    vk::PhysicalDevice dispositivoFisico,
+    vk::Device dispositivo,
+    OrcamentoDeMemoria& orcamento) {
+    dispositivo_ = dispositivo;
+    orcamento_ = &orcamento;
+    propriedades_ = dispositivoFisico.getMemoryProperties();
+    granularidade_ = dispositivoFisico.getProperties()
+                         .limits.bufferImageGranularity;
+}
+
+void AlocadorDeMemoria::destruir() {
+    for (uint32_t tipo = 0; tipo < blocos_.size(); tipo++) {
+        for (auto&& bloco : blocos_[tipo]) {
+            liberarMemoria(bloco->memoria,
+                           bloco->intervalos.tamanho(), tipo);
+        }
+        blocos_[tipo].clear();
+    }
+}
+
+Alocacao AlocadorDeMemoria::alocar(
+    const vk::MemoryRequirements& requisitos,
+    uint32_t tipoDeMemoria,
+    bool recursoLinear) {
+    Alocacao alocacao;
+    alocacao.tamanho = requisitos.size;
+    alocacao.tipoDeMemoria = tipoDeMemoria;
+    uint32_t heap = orcamento_->heapDoTipo(tipoDeMemoria);
+
+    vk::DeviceSize tamanhoDoBloco =
+        this->tamanhoDoBloco(tipoDeMemoria);
+
+    // Recursos grandes desperdiçariam boa parte de um bloco,
+    // então recebem uma alocação só para eles.
+    if (requisitos.size > tamanhoDoBloco / 2) {
+        alocacao.memoria =
+            alocarMemoria(requisitos.size, tipoDeMemoria);
+        alocacao.mapeamento =
+            mapearSeVisivel(alocacao.memoria, tipoDeMemoria);
+        alocacoesDedicadas_[tipoDeMemoria]++;
+        bytesDedicados_[tipoDeMemoria] += requisitos.size;
+        orcamento_->somarUsoDeRecursos(heap, requisitos.size);
+        return alocacao;
+    }
+
+    // Buffers e imagens com tiling ótimo não podem dividir
+    // uma página de bufferImageGranularity.
+    uint32_t categoria = recursoLinear ? 0 : 1;
+
+    auto& blocosDoTipo = blocos_[tipoDeMemoria];
+    while (alocacao.bloco == nullptr) {
+        for (auto&& bloco : blocosDoTipo) {
+            auto deslocamento = bloco->intervalos.alocar(
+                requisitos.size, requisitos.alignment,
+                categoria);
+            if (deslocamento.has_value()) {
+                alocacao.bloco = bloco.get();
+                alocacao.deslocamento = deslocamento.value();
+                break;
+            }
+        }
+        if (alocacao.bloco != nullptr) {
+            break;
+        }
+
+        // Antes de crescer além do orçamento, tentamos abrir
+        // espaço nos blocos existentes despejando recursos.
+        if (!orcamento_->cabe(heap, tamanhoDoBloco) &&
+            orcamento_->despejarMenosUsado(heap)) {
+            continue;
+        }
+
+        vk::DeviceMemory memoria =
+            alocarMemoria(tamanhoDoBloco, tipoDeMemoria);
+        blocosDoTipo.push_back(std::make_unique<BlocoDeMemoria>(
+            memoria, mapearSeVisivel(memoria, tipoDeMemoria),
+            tamanhoDoBloco, granularidade_));
+
+        alocacao.bloco = blocosDoTipo.back().get();
+        alocacao.deslocamento =
+            alocacao.bloco->intervalos
+                .alocar(requisitos.size, requisitos.alignment,
+                        categoria)
+                .value();
+    }
+
+    alocacao.memoria = alocacao.bloco->memoria;
+    if (alocacao.bloco->mapeamento != nullptr) {
+        alocacao.mapeamento =
+            static_cast<char*>(alocacao.bloco->mapeamento) +
+            alocacao.deslocamento;
+    }
+
+    orcamento_->somarUsoDeRecursos(heap, requisitos.size);
+    return alocacao;
+}
+
+void AlocadorDeMemoria::liberar(Alocacao& alocacao) {
+    if (!alocacao.memoria) {
+        return;
+    }
+
+    orcamento_->subtrairUsoDeRecursos(
+        orcamento_->heapDoTipo(alocacao.tipoDeMemoria),
+        alocacao.tamanho);
+
+    if (alocacao.bloco == nullptr) {
+        liberarMemoria(alocacao.memoria, alocacao.tamanho,
+                       alocacao.tipoDeMemoria);
+        alocacoesDedicadas_[alocacao.tipoDeMemoria]--;
+        bytesDedicados_[alocacao.tipoDeMemoria] -=
+            alocacao.tamanho;
+        alocacao = {};
+        return;
+    }
+
+    alocacao.bloco->intervalos.liberar(alocacao.deslocamento);
+
+    // Blocos vazios são devolvidos ao driver, mas sempre
+    // mantemos um por tipo para evitar alocar e liberar a
+    // cada recurso temporário.
+    auto& blocosDoTipo = blocos_[alocacao.tipoDeMemoria];
+    if (alocacao.bloco->intervalos.vazio() &&
+        blocosDoTipo.size() > 1) {
+        auto bloco = std::find_if(
+            blocosDoTipo.begin(), blocosDoTipo.end(),
+            [&alocacao](const auto& b) {
+                return b.get() == alocacao.bloco;
+            });
+        liberarMemoria((*bloco)->memoria,
+                       (*bloco)->intervalos.tamanho(),
+                       alocacao.tipoDeMemoria);
+        blocosDoTipo.erase(bloco);
+    }
+
+    alocacao = {};
+}
+
+EstatisticasDeMemoria AlocadorDeMemoria::estatisticas() const {
+    EstatisticasDeMemoria total;
+    for (uint32_t i = 0; i < propriedades_.memoryTypeCount;
+         i++) {
+        auto doTipo = estatisticas(i);
+        total.numBlocos += doTipo.numBlocos;
+        total.numAlocacoesDedicadas +=
+            doTipo.numAlocacoesDedicadas;
+        total.bytesDedicados += doTipo.bytesDedicados;
+        total.blocos += doTipo.blocos;
+    }
+    return total;
+}
+
+EstatisticasDeMemoria AlocadorDeMemoria::estatisticas(
+    uint32_t tipoDeMemoria) const {
+    EstatisticasDeMemoria estatisticas;
+    const auto& blocosDoTipo = blocos_[tipoDeMemoria];
+    estatisticas.numBlocos =
+        static_cast<uint32_t>(blocosDoTipo.size());
+    estatisticas.numAlocacoesDedicadas =
+        alocacoesDedicadas_[tipoDeMemoria];
+    estatisticas.bytesDedicados =
+        bytesDedicados_[tipoDeMemoria];
+    for (auto&& bloco : blocosDoTipo) {
+        estatisticas.blocos +=
+            bloco->intervalos.estatisticas();
+    }
+    return estatisticas;
+}
+
+void AlocadorDeMemoria::imprimirEstatisticas() const {
+    for (uint32_t i = 0; i < propriedades_.memoryTypeCount;
+         i++) {
+        auto e = estatisticas(i);
+        if (e.numBlocos == 0 && e.numAlocacoesDedicadas == 0) {
+            continue;
+        }
+
+        std::cout << "Tipo de memória " << i << ": "
+                  << e.numBlocos << " blocos, "
+                  << e.blocos.bytesUsados << "/"
+                  << e.blocos.tamanhoTotal
+                  << " bytes usados em "
+                  << e.blocos.numIntervalosUsados
+                  << " alocações, fragmentação "
+                  << e.blocos.fragmentacao() << ", "
+                  << e.numAlocacoesDedicadas
+                  << " alocações dedicadas ("
+                  << e.bytesDedicados << " bytes)" << std::endl;
+    }
+}
+
+vk::DeviceMemory AlocadorDeMemoria::alocarMemoria(
+    vk::DeviceSize tamanho,
+    uint32_t tipoDeMemoria) {
+    uint32_t heap = orcamento_->heapDoTipo(tipoDeMemoria);
+    while (!orcamento_->cabe(heap, tamanho) &&
+           orcamento_->despejarMenosUsado(heap)) {
+    }
+
+    vk::MemoryAllocateInfo infoAlloc;
+    infoAlloc.allocationSize = tamanho;
+    infoAlloc.memoryTypeIndex = tipoDeMemoria;
+
+    // O orçamento é só uma estimativa, então o driver ainda
+    // pode recusar a alocação.
+    while (true) {
+        try {
+            vk::DeviceMemory memoria =
+                dispositivo_.allocateMemory(infoAlloc);
+            orcamento_->registrarAlocacao(heap, tamanho);
+            return memoria;
+        } catch (const vk::OutOfDeviceMemoryError&) {
+            if (!orcamento_->despejarMenosUsado(heap)) {
+                throw;
+            }
+        }
+    }
+}
+
+void AlocadorDeMemoria::liberarMemoria(
+    vk::DeviceMemory memoria,
+    vk::DeviceSize tamanho,
+    uint32_t tipoDeMemoria) {
+    dispositivo_.freeMemory(memoria);
+    orcamento_->registrarLiberacao(
+        orcamento_->heapDoTipo(tipoDeMemoria), tamanho);
+}
+
+void* AlocadorDeMemoria::mapearSeVisivel(
+    vk::DeviceMemory memoria,
+    uint32_t tipoDeMemoria) {
+    auto propriedades =
+        propriedades_.memoryTypes[tipoDeMemoria].propertyFlags;
+    if (!(propriedades &
+          vk::MemoryPropertyFlagBits::eHostVisible)) {
+        return nullptr;
+    }
+
+    return dispositivo_.mapMemory(memoria, 0, VK_WHOLE_SIZE);
+}
+
+vk::DeviceSize AlocadorDeMemoria::tamanhoDoBloco(
+    uint32_t tipoDeMemoria) const {
+    uint32_t heap =
+        propriedades_.memoryTypes[tipoDeMemoria].heapIndex;
+    vk::DeviceSize tamanhoDoHeap =
+        propriedades_.memoryHeaps[heap].size;
+
+    // Heaps pequenos (como a janela BAR de 256 MiB) não
+    // comportam vários blocos do tamanho máximo.
+    return std::min(kTamanhoMaximoDoBloco, tamanhoDoHeap / 8);
+}
+}  // namespace smv
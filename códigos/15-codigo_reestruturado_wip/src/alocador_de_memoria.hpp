@@ -0,0 +1,87 @@
+#ifndef SMV_ALOCADOR_DE_MEMORIA_HPP
+#define SMV_ALOCADOR_DE_MEMORIA_HPP
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "alocador_de_intervalos.hpp"
+#include "orcamento_de_memoria.hpp"
+
+namespace smv {
+struct BlocoDeMemoria;
+
+struct Alocacao {
+    vk::DeviceMemory memoria;
+    vk::DeviceSize deslocamento = 0;
+    vk::DeviceSize tamanho = 0;
+    uint32_t tipoDeMemoria = 0;
+    // Endereço já deslocado quando a memória é visível pelo
+    // hospedeiro, já que os blocos ficam sempre mapeados.
+    void* mapeamento = nullptr;
+    // Nulo quando a alocação é dedicada.
+    BlocoDeMemoria* bloco = nullptr;
+};
+
+struct EstatisticasDeMemoria {
+    uint32_t numBlocos = 0;
+    uint32_t numAlocacoesDedicadas = 0;
+    vk::DeviceSize bytesDedicados = 0;
+    EstatisticasDeIntervalos blocos;
+};
+
+// Reserva blocos grandes de cada tipo de memória e
+// sub-aloca buffers e imagens dentro deles, em vez de gastar
+// um vkAllocateMemory por recurso.
+//
+// Toda memória alocada é informada ao orçamento, que pode
+// despejar recursos para abrir espaço antes de uma alocação.
+class AlocadorDeMemoria {
+  public:
+    void iniciar(vk::PhysicalDevice dispositivoFisico,
+                 vk::Device dispositivo,
+                 OrcamentoDeMemoria& orcamento);
+    void destruir();
+
+    Alocacao alocar(const vk::MemoryRequirements& requisitos,
+                    uint32_t tipoDeMemoria,
+                    bool recursoLinear);
+    void liberar(Alocacao& alocacao);
+
+    EstatisticasDeMemoria estatisticas() const;
+    EstatisticasDeMemoria estatisticas(
+        uint32_t tipoDeMemoria) const;
+    void imprimirEstatisticas() const;
+
+  private:
+    vk::DeviceMemory alocarMemoria(vk::DeviceSize tamanho,
+                                   uint32_t tipoDeMemoria);
+    void liberarMemoria(vk::DeviceMemory memoria,
+                        vk::DeviceSize tamanho,
+                        uint32_t tipoDeMemoria);
+    void* mapearSeVisivel(vk::DeviceMemory memoria,
+                          uint32_t tipoDeMemoria);
+    vk::DeviceSize tamanhoDoBloco(
+        uint32_t tipoDeMemoria) const;
+
+    static constexpr vk::DeviceSize kTamanhoMaximoDoBloco =
+        64ull * 1024 * 1024;
+
+    vk::Device dispositivo_;
+    OrcamentoDeMemoria* orcamento_ = nullptr;
+    vk::PhysicalDeviceMemoryProperties propriedades_;
+    vk::DeviceSize granularidade_ = 1;
+
+    std::array<std::vector<std::unique_ptr<BlocoDeMemoria>>,
+               VK_MAX_MEMORY_TYPES>
+        blocos_;
+    std::array<uint32_t, VK_MAX_MEMORY_TYPES>
+        alocacoesDedicadas_{};
+    std::array<vk::DeviceSize, VK_MAX_MEMORY_TYPES>
+        bytesDedicados_{};
+};
+}  // namespace smv
+
+#endif
@@ -0,0 +1,134 @@
+#include "anel_de_preparo.hpp"
+
+#include <limits>
+#include <tuple>
+
+namespace smv {
+void AnelDePreparo::iniciar(vk::Device dispositivo,
+                            vk::Buffer buffer,
+                            void* mapeamento,
+                            vk::DeviceSize capacidade) {
+    dispositivo_ = dispositivo;
+    buffer_ = buffer;
+    mapeamento_ = static_cast<char*>(mapeamento);
+    capacidade_ = capacidade;
+}
+
+void AnelDePreparo::destruir() {
+    for (auto&& lote : lotesEmExecucao_) {
+        dispositivo_.destroyFence(lote.cerca);
+    }
+    lotesEmExecucao_.clear();
+    for (auto&& cerca : cercasLivres_) {
+        dispositivo_.destroyFence(cerca);
+    }
+    cercasLivres_.clear();
+}
+
+std::optional<FatiaDePreparo> AnelDePreparo::reservar(
+    vk::DeviceSize tamanho,
+    vk::DeviceSize alinhamento) {
+    auto deslocamento = buscarEspaco(tamanho, alinhamento);
+    if (!deslocamento.has_value()) {
+        return {};
+    }
+
+    cabeca_ = deslocamento.value() + tamanho;
+    vazio_ = false;
+    possuiPendentes_ = true;
+
+    return FatiaDePreparo{buffer_, deslocamento.value(),
+                          tamanho,
+                          mapeamento_ + deslocamento.value()};
+}
+
+std::optional<FatiaDePreparo> AnelDePreparo::reservarEsperando(
+    vk::DeviceSize tamanho,
+    vk::DeviceSize alinhamento) {
+    while (true) {
+        auto fatia = reservar(tamanho, alinhamento);
+        if (fatia.has_value() || lotesEmExecucao_.empty()) {
+            return fatia;
+        }
+
+        std::ignore = dispositivo_.waitForFences(
+            lotesEmExecucao_.front().cerca, false,
+            std::numeric_limits<uint64_t>::max());
+        reciclar();
+    }
+}
+
+std::optional<vk::DeviceSize> AnelDePreparo::buscarEspaco(
+    vk::DeviceSize tamanho,
+    vk::DeviceSize alinhamento) const {
+    if (tamanho > capacidade_) {
+        return {};
+    }
+
+    if (vazio_) {
+        return 0;
+    }
+
+    vk::DeviceSize deslocamento =
+        (cabeca_ + alinhamento - 1) / alinhamento * alinhamento;
+
+    if (cabeca_ > cauda_) {
+        if (deslocamento + tamanho <= capacidade_) {
+            return deslocamento;
+        }
+        // Descarta o final do buffer e recomeça do início.
+        if (tamanho <= cauda_) {
+            return 0;
+        }
+    } else if (cabeca_ < cauda_) {
+        if (deslocamento + tamanho <= cauda_) {
+            return deslocamento;
+        }
+    }
+
+    return {};
+}
+
+vk::Fence AnelDePreparo::fecharLote() {
+    if (!possuiPendentes_) {
+        return nullptr;
+    }
+
+    vk::Fence cerca = obterCerca();
+    lotesEmExecucao_.push_back({cerca, cabeca_});
+    possuiPendentes_ = false;
+
+    return cerca;
+}
+
+void AnelDePreparo::reciclar() {
+    while (!lotesEmExecucao_.empty()) {
+        auto& lote = lotesEmExecucao_.front();
+        if (dispositivo_.getFenceStatus(lote.cerca) !=
+            vk::Result::eSuccess) {
+            break;
+        }
+
+        cauda_ = lote.fim;
+        dispositivo_.resetFences(lote.cerca);
+        cercasLivres_.push_back(lote.cerca);
+        lotesEmExecucao_.pop_front();
+    }
+
+    if (lotesEmExecucao_.empty() && !possuiPendentes_) {
+        cabeca_ = 0;
+        cauda_ = 0;
+        vazio_ = true;
+    }
+}
+
+vk::Fence AnelDePreparo::obterCerca() {
+    if (cercasLivres_.empty()) {
+        return dispositivo_.createFence(vk::FenceCreateInfo{});
+    }
+
+    vk::Fence cerca = cercasLivres_.back();
+    cercasLivres_.pop_back();
+    return cerca;
+}
+}  // namespace smv
@@ -0,0 +1,83 @@
+#ifndef SMV_ANEL_DE_PREPARO_HPP
+#define SMV_ANEL_DE_PREPARO_HPP
+
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+namespace smv {
+struct FatiaDePreparo {
+    vk::Buffer buffer;
+    vk::DeviceSize deslocamento = 0;
+    vk::DeviceSize tamanho = 0;
+    void* dados = nullptr;
+};
+
+// Buffer de preparo único, mapeado permanentemente, do qual
+// os envios para a GPU reservam fatias em ordem circular.
+//
+// As fatias reservadas desde o último `fecharLote` só voltam
+// a ficar disponíveis quando a cerca devolvida por ele for
+// sinalizada, ou seja, quando a submissão que as consome
+// terminar.
+class AnelDePreparo {
+  public:
+    void iniciar(vk::Device dispositivo,
+                 vk::Buffer buffer,
+                 void* mapeamento,
+                 vk::DeviceSize capacidade);
+    void destruir();
+
+    std::optional<FatiaDePreparo> reservar(
+        vk::DeviceSize tamanho,
+        vk::DeviceSize alinhamento = 16);
+    // Como `reservar`, mas espera lotes já submetidos
+    // terminarem quando falta espaço. Só falha se nem o
+    // anel vazio comportar a fatia.
+    std::optional<FatiaDePreparo> reservarEsperando(
+        vk::DeviceSize tamanho,
+        vk::DeviceSize alinhamento = 16);
+
+    // Devolve a cerca que a submissão das fatias pendentes
+    // deve sinalizar, ou nula se não houver fatias
+    // pendentes.
+    vk::Fence fecharLote();
+    void reciclar();
+
+    bool possuiPendentes() const { return possuiPendentes_; }
+    vk::DeviceSize capacidade() const { return capacidade_; }
+    // Maior fatia que sempre cabe num anel vazio, usada para
+    // dividir envios grandes em pedaços.
+    vk::DeviceSize maiorFatia() const {
+        return capacidade_ / 2;
+    }
+
+  private:
+    struct Lote {
+        vk::Fence cerca;
+        vk::DeviceSize fim;
+    };
+
+    std::optional<vk::DeviceSize> buscarEspaco(
+        vk::DeviceSize tamanho,
+        vk::DeviceSize alinhamento) const;
+    vk::Fence obterCerca();
+
+    vk::Device dispositivo_;
+    vk::Buffer buffer_;
+    char* mapeamento_ = nullptr;
+    vk::DeviceSize capacidade_ = 0;
+
+    vk::DeviceSize cabeca_ = 0;
+    vk::DeviceSize cauda_ = 0;
+    bool vazio_ = true;
+    bool possuiPendentes_ = false;
+
+    std::deque<Lote> lotesEmExecucao_;
+    std::vector<vk::Fence> cercasLivres_;
+};
+}  // namespace smv
+
+#endif
@@ -0,0 +1,4671 @@
+#ifndef SMV_APP_HPP
+#define SMV_APP_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_RADIANS
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#include <stb_image.h>
+#pragma GCC diagnostic pop
+
+#include <vulkan/vulkan.hpp>
+
+#include "alocador_de_intervalos.hpp"
+#include "alocador_de_memoria.hpp"
+#include "anel_de_preparo.hpp"
+#include "arena_de_uniformes.hpp"
+#include "carregador_de_recursos.hpp"
+#include "compressao_bc.hpp"
+#include "contexto_de_envio.hpp"
+#include "descarte_de_frustum.hpp"
+#include "fila_de_destruicao.hpp"
+#include "importador_obj.hpp"
+#include "indices_de_malha.hpp"
+#include "malha_cozida.hpp"
+#include "meshlets.hpp"
+#include "orcamento_de_memoria.hpp"
+#include "otimizacao_de_malha.hpp"
+#include "pool_de_alvos.hpp"
+#include "pool_de_geometria.hpp"
+#include "simplificacao_de_malha.hpp"
+#include "textura_ktx2.hpp"
+#include "vertice.hpp"
+#include "vertice_compacto.hpp"
+#include "vigia_de_arquivos.hpp"
+
+namespace smv {
+struct OBU {
+    alignas(16) glm::mat4 visao;
+    alignas(16) glm::mat4 projecao;
+};
+
+struct PushConstants {
+    glm::mat4 modelo;
+    Dequantizacao dequantizacao;
+};
+
+// Uma malha com os vértices já separados nos fluxos do pool,
+// pronta para ser copiada para ele. Os índices trazem todos os
+// níveis de detalhe.
+struct MalhaPreparada {
+    std::vector<std::vector<char>> fluxos;
+    Dequantizacao dequantizacao;
+    uint32_t numVertices;
+    std::vector<char> indices;
+    uint32_t numIndices;
+    vk::IndexType tipoDeIndice;
+    std::vector<NivelDaMalha> niveis;
+    std::vector<Meshlet> meshlets;
+    glm::vec4 esfera;
+};
+
+// Os níveis de uma textura prontos para o envio. Eles apontam
+// para o arquivo mapeado ou para os texels decodificados, que
+// ficam aqui junto deles.
+struct TexturaPreparada {
+    vk::Format formato;
+    uint32_t bytesPorBloco;
+    uint32_t ladoDoBloco;
+    // Só o nível 0 foi preparado, e o resto da cadeia é gerado
+    // na GPU quando o formato permite.
+    bool gerarMipmaps;
+    std::vector<NivelDeImagem> niveis;
+    TexturaKtx2 arquivo;
+    std::vector<std::vector<uint8_t>> texels;
+};
+
+// Os shaders e as pipelines criadas com eles, que são trocados
+// juntos quando os shaders são recarregados. As gráficas da
+// cena são as variantes que leem os objetos escolhidos pela
+// GPU. A pirâmide só existe com a cena na GPU.
+struct ConjuntoDeShaders {
+    vk::ShaderModule vertices;
+    vk::ShaderModule fragmentos;
+    vk::ShaderModule profundidade;
+    vk::Pipeline pipeline;
+    vk::Pipeline pipelineDeProfundidade;
+    vk::Pipeline pipelineDaCena;
+    vk::Pipeline pipelineDeProfundidadeDaCena;
+
+    vk::ShaderModule descarte;
+    vk::Pipeline pipelineDeDescarte;
+    vk::ShaderModule cena;
+    vk::Pipeline pipelineDeEscolhaDaCena;
+    vk::Pipeline pipelineDaPrimeiraFase;
+    vk::Pipeline pipelineDaSegundaFase;
+    vk::ShaderModule piramide;
+    vk::Pipeline pipelineDaPiramide;
+};
+
+// Um objeto da cena: o modelo inteiro numa posição, com a cor
+// dos vértices multiplicada pela tonalidade.
+struct Objeto {
+    glm::vec3 posicao;
+    glm::vec4 tonalidade = glm::vec4(1.0f);
+    // Só há um material por enquanto.
+    uint32_t material = 0;
+};
+
+// Os dados de cada instância desenhada, lidos pelos shaders de
+// vértices pelo índice da instância. A transformação da cena,
+// nas push constants, é aplicada antes desta. O layout é o
+// std430 de shaders/cena.glsl.
+struct Instancia {
+    glm::mat4 modelo;
+    glm::vec4 tonalidade;
+    PoolDeGeometria::IdDeMalha malha;
+    uint32_t material;
+    uint32_t reservado[2];
+};
+static_assert(sizeof(Instancia) == 96,
+              "A instância é lida pelos shaders em std430.");
+
+// Uma malha num nível de detalhe, desenhada em `numInstancias`
+// instâncias seguidas do buffer do quadro. Com `comando`, só os
+// triângulos dos meshlets que o descarte manteve são
+// desenhados, compactados a partir de `saida` no buffer do
+// quadro. O descarte testa as instâncias como uma só, com a
+// transformação completa `modelo` e os meshlets alargados por
+// `folga` no espaço da malha, o que cobre todas elas.
+struct Desenho {
+    PushConstants constantes;
+    PoolDeGeometria::IdDeMalha id;
+    NivelDaMalha nivel;
+    glm::mat4 modelo;
+    float folga;
+    uint32_t primeiraInstancia;
+    uint32_t numInstancias;
+    std::optional<uint32_t> comando;
+    uint32_t saida;
+};
+
+// No começo do buffer de comandos indiretos de cada quadro.
+struct ContadoresDeMeshlets {
+    uint32_t meshletsVisiveis;
+    uint32_t triangulosVisiveis;
+    uint32_t reservado[2];
+};
+
+// Os planos do frustum e a câmera ficam no espaço da malha,
+// onde estão os limites dos meshlets; o w da câmera é a folga
+// do desenho. O bit mais alto do comando diz se os índices da
+// malha são de 16 bits.
+struct ConstantesDoDescarte {
+    std::array<glm::vec4, 6> planos;
+    glm::vec4 camera;
+    uint32_t primeiroMeshlet;
+    uint32_t primeiroIndiceDaMalha;
+    uint32_t saida;
+    uint32_t comando;
+};
+static_assert(sizeof(ConstantesDoDescarte) == 128,
+              "128 bytes de push constants são garantidos.");
+
+// Os buffers do descarte de meshlets de um quadro em execução.
+struct DescarteDoQuadro {
+    vk::Buffer indices;
+    Alocacao alocacaoDosIndices;
+    vk::Buffer comandos;
+    Alocacao alocacaoDosComandos;
+    vk::DescriptorSet set;
+    // A dos buffers do pool na associação 1 do set.
+    uint32_t versaoDoPool = 0;
+};
+
+// Uma linha da tabela de malhas da cena desenhada pela GPU,
+// indexada pelo id da malha no pool. O layout é o std430 de
+// shaders/cena.glsl.
+struct MalhaDaCena {
+    Dequantizacao dequantizacao;
+    glm::vec4 esfera;
+    uint32_t primeiroIndice;
+    int32_t deslocamentoDeVertice;
+    uint32_t indices16;
+    uint32_t numNiveis;
+    std::array<NivelDaMalha, kMaximoDeNiveisDeDetalhe> niveis;
+};
+static_assert(sizeof(MalhaDaCena) == 240,
+              "A malha é lida pelos shaders em std430.");
+
+// Escritos na arena a cada quadro, no layout std140.
+struct ParametrosDaCena {
+    glm::mat4 modeloDaCena;
+    glm::mat4 visaoProjecao;
+    // As do quadro que desenhou a pirâmide de profundidade.
+    glm::mat4 modeloDaCenaDaPiramide;
+    glm::mat4 visaoProjecaoDaPiramide;
+    std::array<glm::vec4, 6> planos;
+    // w: pixels da tela por unidade a uma unidade de distância.
+    glm::vec4 camera;
+    uint32_t numObjetos;
+    uint32_t capacidadeDaLista;
+    float erroEmPixels;
+    float planoProximo;
+    uint32_t usarNiveis;
+    uint32_t piramideValida;
+};
+
+// As listas de comandos da cena, cada uma com `capacidade`
+// comandos: as de índices de 16 e de 32 bits da primeira fase
+// do descarte por oclusão e as da segunda. Sem o descarte por
+// oclusão, só as da primeira são usadas.
+constexpr uint32_t kListasDaCena = 4;
+
+// As fases do shader da cena, a constante de especialização 0
+// dele.
+constexpr uint32_t kSemOclusao = 0;
+constexpr uint32_t kPrimeiraFase = 1;
+constexpr uint32_t kSegundaFase = 2;
+
+// No começo do buffer de comandos da cena. As contagens são
+// lidas pelos desenhos indiretos, uma por lista.
+struct ContadoresDaCena {
+    std::array<uint32_t, kListasDaCena> numComandos;
+    uint32_t objetosVisiveis;
+    uint32_t triangulosVisiveis;
+    uint32_t objetosOclusos;
+    uint32_t reservado;
+};
+
+// No começo do buffer dos objetos adiados pela primeira fase.
+// A segunda fase é despachada com os grupos daqui.
+struct CabecalhoDosAdiados {
+    vk::DispatchIndirectCommand grupos;
+    uint32_t numAdiados;
+};
+
+// Os objetos e as malhas ficam visíveis à CPU, que só os
+// reescreve quando a cena muda desde a `versao` dele. Os
+// comandos ficam na memória do dispositivo, com a lista dos
+// índices de 32 bits depois de `capacidade` comandos, e os
+// contadores são copiados para `leitura` no fim do quadro.
+// As instâncias dos desenhos escolhidos pela CPU são escritas
+// a cada quadro e crescem à parte. O set aponta a pirâmide de
+// profundidade da `versaoDaPiramide`.
+struct CenaDoQuadro {
+    vk::Buffer objetos;
+    Alocacao alocacaoDosObjetos;
+    vk::Buffer malhas;
+    Alocacao alocacaoDasMalhas;
+    vk::Buffer comandos;
+    Alocacao alocacaoDosComandos;
+    vk::Buffer leitura;
+    Alocacao alocacaoDaLeitura;
+    vk::Buffer adiados;
+    Alocacao alocacaoDosAdiados;
+    vk::Buffer instancias;
+    Alocacao alocacaoDasInstancias;
+    vk::DescriptorSet set;
+    uint32_t capacidade;
+    uint32_t numObjetos;
+    uint64_t versao;
+    uint32_t capacidadeDeInstancias;
+    uint64_t versaoDaPiramide;
+};
+
+// A maior profundidade de cada região da tela, num nível por
+// vez maior de região, para o descarte por oclusão. Cada nível
+// tem a própria visão e um set que o constrói a partir do
+// anterior, ou da profundidade da tela no nível 0.
+struct PiramideDeProfundidade {
+    vk::Image imagem;
+    Alocacao alocacao;
+    vk::ImageView visao;
+    vk::Extent2D dimensoes;
+    std::vector<vk::ImageView> visoesDosNiveis;
+    vk::DescriptorPool poolDeDescritores;
+    std::vector<vk::DescriptorSet> sets;
+};
+
+class App {
+  public:
+    void rodar() {
+        iniciar();
+        carregarRecursos();
+        loopPrincipal();
+        destruir();
+    }
+
+    // `arquivo` troca o recurso usado pelas bancadas que leem
+    // um, como a de importação.
+    void rodarBancada(const std::string& nome,
+                      const std::string& arquivo) {
+        iniciar();
+
+        if (nome == "envio") {
+            bancadaDeEnvio();
+        } else if (nome == "malha") {
+            bancadaDeMalha();
+        } else if (nome == "importacao") {
+            bancadaDeImportacao(
+                arquivo.empty() ? kCaminhoDoModelo : arquivo);
+        } else if (nome == "vertices") {
+            bancadaDeVertices();
+        } else if (nome == "mipmaps") {
+            bancadaDeMipmaps();
+        } else if (nome == "textura") {
+            bancadaDeTextura();
+        } else if (nome == "carregamento") {
+            bancadaDeCarregamento();
+        } else if (nome == "profundidade") {
+            bancadaDePassePrevio();
+        } else if (nome == "niveis") {
+            bancadaDeNiveisDeDetalhe();
+        } else if (nome == "meshlets") {
+            bancadaDeMeshlets();
+        } else if (nome == "instancias") {
+            bancadaDeInstancias();
+        } else if (nome == "frustum") {
+            bancadaDeFrustum();
+        } else if (nome == "cena") {
+            bancadaDaCena();
+        } else if (nome == "oclusao") {
+            bancadaDeOclusao();
+        } else if (nome == "recarga") {
+            bancadaDeRecarga();
+        } else if (nome == "otimizacao") {
+            bancadaDeOtimizacao(
+                arquivo.empty() ? kCaminhoDoModelo : arquivo);
+        } else {
+            throw std::runtime_error("Bancada desconhecida '" +
+                                     nome + "'.");
+        }
+
+        dispositivo_.waitIdle();
+        destruir();
+    }
+
+  private:
+    void iniciar() {
+        criarJanela();
+        criarInstancia();
+        criarSuperficie();
+        escolherDispositivoFisico();
+        criarDispositivoLogicoEFilas();
+        orcamento_.iniciar(dispositivoFisico_,
+                           possuiExtensaoDeOrcamento_,
+                           kMaximoQuadrosEmExecucao);
+        alocador_.iniciar(dispositivoFisico_, dispositivo_,
+                          orcamento_);
+        filaDeDestruicao_.iniciar(kMaximoQuadrosEmExecucao);
+        poolDeAlvos_.iniciar(dispositivoFisico_, dispositivo_,
+                             alocador_, filaDeDestruicao_);
+        criarPoolDeComandos();
+        criarAnelDePreparo();
+        contextoDeEnvio_.iniciar(
+            dispositivo_, anelDePreparo_,
+            familiaDeTransferencia_, filaDeTransferencia_,
+            familiaDeGraficos_, filaDeGraficos_);
+        carregador_.iniciar(kThreadsDeCarregamento);
+        criarContextoDeRenderizacao();
+        criarLayoutsDosSetsDeDescritores();
+        criarLayoutDaPipeline();
+        criarLayoutDoDescarte();
+        if (suportaCenaNaGpu_) {
+            criarLayoutDaPiramide();
+        }
+        shaders_ = construirShaders(
+            {}, formatoDeVertice_, passePrevioDeProfundidade_,
+            passeDeRenderizacao_);
+        if (suportaCenaNaGpu_) {
+            piramide_ = criarPiramideDeProfundidade();
+        }
+        iniciarRecargaDeShaders();
+        criarPrimitivosDeSincronizacao();
+        criarPoolDeDescritores();
+    }
+
+    void criarJanela() {
+        glfwInit();
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+        janela_ =
+            glfwCreateWindow(kLarguraDaJanela, kAlturaDaJanela,
+                             kTituloDaJanela, nullptr, nullptr);
+        glfwSetWindowUserPointer(janela_, this);
+        glfwSetFramebufferSizeCallback(janela_,
+                                       callbackDeRedimensao);
+    }
+
+    static void callbackDeRedimensao(GLFWwindow* janela,
+                                     int,
+                                     int) {
+        auto app = reinterpret_cast<App*>(
+            glfwGetWindowUserPointer(janela));
+        app->precisaRecriarContextoDeRenderizacao_ = true;
+    }
+
+    void criarInstancia() {
+        if (kAtivarCamadasDeValidacao &&
+            !verificarDisponibilidadeDasCamadasDeValidacao()) {
+            throw std::runtime_error(
+                "Esta máquina não suporta as camadas de "
+                "validação "
+                "necessárias.");
+        }
+
+        vk::ApplicationInfo infoApp;
+        infoApp.pApplicationName = "App";
+        infoApp.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
+        infoApp.pEngineName = "Simples Motor Vulkan";
+        infoApp.engineVersion = VK_MAKE_VERSION(1, 0, 0);
+        // 1.1 para consultar o orçamento de memória com
+        // vkGetPhysicalDeviceMemoryProperties2.
+        infoApp.apiVersion = VK_API_VERSION_1_1;
+
+        uint32_t numDeExtensoesGLFW;
+        const char** extensoesGLFW =
+            glfwGetRequiredInstanceExtensions(
+                &numDeExtensoesGLFW);
+
+        vk::InstanceCreateInfo info;
+        info.pApplicationInfo = &infoApp;
+        info.enabledExtensionCount = numDeExtensoesGLFW;
+        info.ppEnabledExtensionNames = extensoesGLFW;
+        if (kAtivarCamadasDeValidacao) {
+            info.enabledLayerCount = static_cast<uint32_t>(
+                kCamadasDeValidacao.size());
+            info.ppEnabledLayerNames =
+                kCamadasDeValidacao.data();
+        }
+
+        instancia_ = vk::createInstance(info);
+    }
+
+    bool verificarDisponibilidadeDasCamadasDeValidacao() {
+        auto propriedadesDasCamadas =
+            vk::enumerateInstanceLayerProperties();
+
+        for (auto&& camada : kCamadasDeValidacao) {
+            bool camadaEncontrada = false;
+
+            for (auto&& propriedades : propriedadesDasCamadas) {
+                if (strcmp(camada, propriedades.layerName) ==
+                    0) {
+                    camadaEncontrada = true;
+                    break;
+                }
+            }
+
+            if (!camadaEncontrada) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void criarSuperficie() {
+        VkSurfaceKHR superficiePura;
+        if (glfwCreateWindowSurface(instancia_, janela_,
+                                    nullptr, &superficiePura) !=
+            VK_SUCCESS) {
+            throw std::runtime_error(
+                "Não foi possível criar a superfície.");
+        }
+        superficie_ = vk::SurfaceKHR(superficiePura);
+    }
+
+    void escolherDispositivoFisico() {
+        auto dispositivosFisicos =
+            instancia_.enumeratePhysicalDevices();
+        auto resultado =
+            std::find_if(dispositivosFisicos.begin(),
+                         dispositivosFisicos.end(),
+                         [this](vk::PhysicalDevice d) {
+                             return verificarDispositivo(d);
+                         });
+
+        if (resultado == dispositivosFisicos.end()) {
+            throw std::runtime_error(
+                "Não foi encontrado um dispositivo físico "
+                "compartível.");
+        }
+
+        dispositivoFisico_ = *resultado;
+    }
+
+    bool verificarDispositivo(
+        const vk::PhysicalDevice& dispositivo) {
+        bool possuiFilas =
+            verificarFilasDoDispositivo(dispositivo);
+        bool suportaExtensoes =
+            verificarSuporteDeExtensoes(dispositivo);
+        bool adequadoParaSwapchain =
+            suportaExtensoes &&
+            verificarSuporteDeSwapchain(dispositivo);
+
+        return possuiFilas && adequadoParaSwapchain;
+    }
+
+    bool verificarFilasDoDispositivo(
+        const vk::PhysicalDevice& dispositivo) {
+        bool possuiFilaGrafica =
+            buscarFamiliaDeFilas(dispositivo,
+                                 vk::QueueFlagBits::eGraphics)
+                .has_value();
+
+        bool possuiFilaDeApresentacao =
+            buscarFamiliaDeFilasDePresentacao(dispositivo)
+                .has_value();
+
+        return possuiFilaGrafica && possuiFilaDeApresentacao;
+    }
+
+    std::optional<uint32_t> buscarFamiliaDeFilasDePresentacao(
+        vk::PhysicalDevice dispositivo) {
+        auto familias = dispositivo.getQueueFamilyProperties();
+
+        std::optional<uint32_t> valor = {};
+        for (uint32_t i = 0; i < familias.size(); i++) {
+            if (dispositivo.getSurfaceSupportKHR(i,
+                                                 superficie_)) {
+                valor = i;
+                break;
+            }
+        }
+
+        return valor;
+    }
+
+    bool verificarSuporteDeExtensoes(
+        const vk::PhysicalDevice& dispositivo) {
+        auto extensoesDisponiveis =
+            dispositivo.enumerateDeviceExtensionProperties();
+        std::unordered_set<std::string> extensoesRestantes(
+            kExtensoesDeDispositivo.begin(),
+            kExtensoesDeDispositivo.end());
+
+        for (const auto& extensao : extensoesDisponiveis) {
+            extensoesRestantes.erase(extensao.extensionName);
+        }
+
+        return extensoesRestantes.empty();
+    }
+
+    bool verificarSuporteDeSwapchain(
+        const vk::PhysicalDevice& dispositivo) {
+        bool possuiFormatos =
+            !dispositivo.getSurfaceFormatsKHR(superficie_)
+                 .empty();
+        bool possuiModosDeApresentacao =
+            !dispositivo.getSurfacePresentModesKHR(superficie_)
+                 .empty();
+
+        return possuiFormatos && possuiModosDeApresentacao;
+    }
+
+    void criarDispositivoLogicoEFilas() {
+        vk::PhysicalDeviceFeatures capacidades;
+        auto suportadas = dispositivoFisico_.getFeatures();
+        suportaCompressaoBc_ =
+            suportadas.textureCompressionBC == VK_TRUE;
+        if (suportaCompressaoBc_) {
+            capacidades.textureCompressionBC = VK_TRUE;
+        }
+        // Os comandos indiretos apontam a primeira instância
+        // dos desenhos no buffer de instâncias, e a cena
+        // desenhada pela GPU tem um comando por objeto.
+        suportaPrimeiraInstanciaIndireta_ =
+            suportadas.drawIndirectFirstInstance == VK_TRUE;
+        if (suportaPrimeiraInstanciaIndireta_) {
+            capacidades.drawIndirectFirstInstance = VK_TRUE;
+        }
+        suportaCenaNaGpu_ =
+            suportaPrimeiraInstanciaIndireta_ &&
+            suportadas.multiDrawIndirect == VK_TRUE;
+        if (suportaCenaNaGpu_) {
+            capacidades.multiDrawIndirect = VK_TRUE;
+        }
+        // Com multiDrawIndirect, a especificação só garante
+        // 65535 desenhos por comando indireto.
+        maximoDeDesenhosIndiretos_ =
+            dispositivoFisico_.getProperties()
+                .limits.maxDrawIndirectCount;
+        // A pirâmide do descarte por oclusão é construída da
+        // profundidade lida como textura.
+        auto recursosDaProfundidade =
+            dispositivoFisico_
+                .getFormatProperties(vk::Format::eD32Sfloat)
+                .optimalTilingFeatures;
+        auto necessarios =
+            vk::FormatFeatureFlagBits::eDepthStencilAttachment |
+            vk::FormatFeatureFlagBits::eSampledImage;
+        suportaOclusao_ = suportaCenaNaGpu_ &&
+                          (recursosDaProfundidade &
+                           necessarios) == necessarios;
+
+        auto familias = obterFamiliaDoDispositivo();
+
+        std::vector<vk::DeviceQueueCreateInfo> infos;
+        float prioridade = 1.0f;
+        for (auto familia : familias) {
+            infos.push_back({{}, familia, 1, &prioridade});
+        }
+
+        auto extensoes = kExtensoesDeDispositivo;
+        possuiExtensaoDeOrcamento_ =
+            verificarSuporteAoOrcamentoDeMemoria();
+        if (possuiExtensaoDeOrcamento_) {
+            extensoes.push_back(
+                VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+        possuiContagemIndireta_ = possuiExtensaoDeDispositivo(
+            VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+        if (possuiContagemIndireta_) {
+            extensoes.push_back(
+                VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+        }
+
+        vk::DeviceCreateInfo info;
+        info.pEnabledFeatures = &capacidades;
+        info.queueCreateInfoCount =
+            static_cast<uint32_t>(infos.size());
+        info.pQueueCreateInfos = infos.data();
+        info.enabledExtensionCount =
+            static_cast<uint32_t>(extensoes.size());
+        info.ppEnabledExtensionNames = extensoes.data();
+        if (kAtivarCamadasDeValidacao) {
+            info.enabledLayerCount = static_cast<uint32_t>(
+                kCamadasDeValidacao.size());
+            info.ppEnabledLayerNames =
+                kCamadasDeValidacao.data();
+        }
+
+        dispositivo_ = dispositivoFisico_.createDevice(info);
+        filaDeApresentacao_ =
+            dispositivo_.getQueue(familiaDeApresentacao_, 0);
+        filaDeGraficos_ =
+            dispositivo_.getQueue(familiaDeGraficos_, 0);
+        filaDeTransferencia_ =
+            dispositivo_.getQueue(familiaDeTransferencia_, 0);
+
+        // O carregador estático só exporta o núcleo do 1.1.
+        if (possuiContagemIndireta_) {
+            desenharComContagemIndireta_ = reinterpret_cast<
+                PFN_vkCmdDrawIndexedIndirectCountKHR>(
+                dispositivo_.getProcAddr(
+                    "vkCmdDrawIndexedIndirectCountKHR"));
+        }
+    }
+
+    // VK_EXT_memory_budget é opcional; sem ela o orçamento é
+    // estimado a partir do tamanho dos heaps.
+    bool verificarSuporteAoOrcamentoDeMemoria() {
+        if (dispositivoFisico_.getProperties().apiVersion <
+            VK_API_VERSION_1_1) {
+            return false;
+        }
+        return possuiExtensaoDeDispositivo(
+            VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    bool possuiExtensaoDeDispositivo(const std::string& nome) {
+        auto extensoes =
+            dispositivoFisico_
+                .enumerateDeviceExtensionProperties();
+        return std::any_of(
+            extensoes.begin(), extensoes.end(),
+            [&nome](const vk::ExtensionProperties& extensao) {
+                return std::string(
+                           extensao.extensionName.data()) ==
+                       nome;
+            });
+    }
+
+    std::vector<uint32_t> obterFamiliaDoDispositivo() {
+        familiaDeGraficos_ =
+            buscarFamiliaDeFilas(dispositivoFisico_,
+                                 vk::QueueFlagBits::eGraphics)
+                .value();
+
+        familiaDeApresentacao_ =
+            buscarFamiliaDeFilasDePresentacao(
+                dispositivoFisico_)
+                .value();
+
+        familiaDeTransferencia_ =
+            buscarFamiliaDeTransferencia(dispositivoFisico_)
+                .value_or(familiaDeGraficos_);
+
+        std::vector<uint32_t> familias = {familiaDeGraficos_};
+        for (auto familia : {familiaDeApresentacao_,
+                             familiaDeTransferencia_}) {
+            if (std::find(familias.begin(), familias.end(),
+                          familia) == familias.end()) {
+                familias.push_back(familia);
+            }
+        }
+        return familias;
+    }
+
+    // Família que só faz transferências, normalmente ligada
+    // aos motores de DMA do dispositivo.
+    static std::optional<uint32_t> buscarFamiliaDeTransferencia(
+        const vk::PhysicalDevice& dispositivo) {
+        auto familias = dispositivo.getQueueFamilyProperties();
+
+        auto familia = find_if(
+            familias.begin(), familias.end(), [](auto familia) {
+                return (familia.queueFlags &
+                        vk::QueueFlagBits::eTransfer) &&
+                       !(familia.queueFlags &
+                         (vk::QueueFlagBits::eGraphics |
+                          vk::QueueFlagBits::eCompute));
+            });
+
+        if (familia == familias.end()) {
+            return {};
+        }
+
+        return static_cast<uint32_t>(
+            std::distance(familias.begin(), familia));
+    }
+
+    static std::optional<uint32_t> buscarFamiliaDeFilas(
+        const vk::PhysicalDevice& dispositivo,
+        vk::QueueFlagBits tipo) {
+        auto familias = dispositivo.getQueueFamilyProperties();
+
+        auto familia =
+            find_if(familias.begin(), familias.end(),
+                    [tipo](auto familia) {
+                        return familia.queueFlags & tipo;
+                    });
+
+        bool foiEncontrada = familia == familias.end();
+        if (foiEncontrada) {
+            return {};
+        }
+
+        return std::distance(familias.begin(), familia);
+    }
+
+    void criarPoolDeComandos() {
+        vk::CommandPoolCreateInfo info;
+        info.flags =
+            vk::CommandPoolCreateFlagBits::eResetCommandBuffer |
+            vk::CommandPoolCreateFlagBits::eTransient;
+        info.queueFamilyIndex = familiaDeGraficos_;
+
+        poolDeComandos_ = dispositivo_.createCommandPool(info);
+    }
+
+    void criarAnelDePreparo() {
+        criarBuffer(vk::BufferUsageFlagBits::eTransferSrc,
+                    kTamanhoDoAnelDePreparo,
+                    vk::MemoryPropertyFlagBits::eHostVisible |
+                        vk::MemoryPropertyFlagBits::
+                            eHostCoherent,
+                    bufferDoAnelDePreparo_,
+                    alocacaoDoAnelDePreparo_);
+        anelDePreparo_.iniciar(
+            dispositivo_, bufferDoAnelDePreparo_,
+            alocacaoDoAnelDePreparo_.mapeamento,
+            kTamanhoDoAnelDePreparo);
+    }
+
+    void criarContextoDeRenderizacao() {
+        criarSwapchain();
+        criarAlvosDeRenderizacao();
+        criarPasseDeRenderizacao();
+        criarFramebuffers();
+    }
+
+    void criarSwapchain() {
+        auto capacidades =
+            dispositivoFisico_.getSurfaceCapabilitiesKHR(
+                superficie_);
+        auto formatosDisponiveis =
+            dispositivoFisico_.getSurfaceFormatsKHR(
+                superficie_);
+        auto modosDeApresentacaoDisponiveis =
+            dispositivoFisico_.getSurfacePresentModesKHR(
+                superficie_);
+
+        auto formato =
+            escolherFormatoDaSwapchain(formatosDisponiveis);
+        auto modoDeApresentacao = escolherModoDeApresentacao(
+            modosDeApresentacaoDisponiveis);
+        dimensoesDaSwapchain_ =
+            escolherDimensoesDaSwapchain(capacidades);
+
+        uint32_t numeroDeImagens =
+            std::max(capacidades.minImageCount + 1,
+                     capacidades.maxImageCount);
+
+        vk::SwapchainCreateInfoKHR info;
+
+        info.surface = superficie_;
+        info.minImageCount = numeroDeImagens;
+        info.imageFormat = formatoDaSwapchain_ = formato.format;
+        info.imageColorSpace = formato.colorSpace;
+        info.imageExtent = dimensoesDaSwapchain_;
+        info.imageArrayLayers = 1;
+        info.imageUsage =
+            vk::ImageUsageFlagBits::eColorAttachment;
+
+        info.preTransform = capacidades.currentTransform;
+        info.compositeAlpha =
+            vk::CompositeAlphaFlagBitsKHR::eOpaque;
+        info.presentMode = modoDeApresentacao;
+        info.clipped = true;
+        // Na recriação, a swapchain antiga ainda pode estar
+        // apresentando imagens; ela é destruída depois pela
+        // fila de destruição.
+        info.oldSwapchain = swapChain_;
+
+        if (familiaDeApresentacao_ != familiaDeGraficos_) {
+            std::array<uint32_t, 2> familias{
+                familiaDeApresentacao_, familiaDeGraficos_};
+            info.imageSharingMode =
+                vk::SharingMode::eConcurrent;
+            info.queueFamilyIndexCount =
+                static_cast<uint32_t>(familias.size());
+            info.pQueueFamilyIndices = familias.data();
+
+            swapChain_ = dispositivo_.createSwapchainKHR(info);
+        } else {
+            info.imageSharingMode = vk::SharingMode::eExclusive;
+            // info.queueFamilyIndexCount = 0;
+            // info.pQueueFamilyIndices = nullptr;
+
+            swapChain_ = dispositivo_.createSwapchainKHR(info);
+        }
+
+        imagensDaSwapchain_ =
+            dispositivo_.getSwapchainImagesKHR(swapChain_);
+        visoesDasImagensDaSwapchain_.reserve(
+            imagensDaSwapchain_.size());
+        for (const auto& imagem : imagensDaSwapchain_) {
+            visoesDasImagensDaSwapchain_.push_back(
+                criarVisaoDeImagem(imagem,
+                                   formatoDaSwapchain_));
+        }
+        imagensEmExecucao_.assign(imagensDaSwapchain_.size(),
+                                  std::nullopt);
+    }
+
+    vk::SurfaceFormatKHR escolherFormatoDaSwapchain(
+        const std::vector<vk::SurfaceFormatKHR>&
+            formatosDisponiveis) {
+        for (const auto& formato : formatosDisponiveis) {
+            if (formato.format == vk::Format::eB8G8R8A8Srgb &&
+                formato.colorSpace ==
+                    vk::ColorSpaceKHR::eSrgbNonlinear) {
+                return formato;
+            }
+        }
+        return formatosDisponiveis[0];
+    }
+
+    vk::PresentModeKHR escolherModoDeApresentacao(
+        const std::vector<vk::PresentModeKHR>&
+            modosDeApresentacaoDisponiveis) {
+        auto comeco = modosDeApresentacaoDisponiveis.begin();
+        auto fim = modosDeApresentacaoDisponiveis.end();
+
+        if (std::find(comeco, fim,
+                      vk::PresentModeKHR::eMailbox) != fim) {
+            return vk::PresentModeKHR::eMailbox;
+        }
+
+        return vk::PresentModeKHR::eFifo;
+    }
+
+    vk::Extent2D escolherDimensoesDaSwapchain(
+        const vk::SurfaceCapabilitiesKHR& capacidades) {
+        if (capacidades.currentExtent.width !=
+            std::numeric_limits<uint32_t>::max()) {
+            return capacidades.currentExtent;
+        } else {
+            int largura, altura;
+            glfwGetFramebufferSize(janela_, &largura, &altura);
+
+            vk::Extent2D dimensoes = {
+                static_cast<uint32_t>(largura),
+                static_cast<uint32_t>(altura)};
+
+            vk::Extent2D minimo = capacidades.minImageExtent;
+            vk::Extent2D maximo = capacidades.maxImageExtent;
+
+            dimensoes.width = std::clamp(
+                dimensoes.width, minimo.width, maximo.width);
+            dimensoes.height = std::clamp(
+                dimensoes.height, minimo.height, maximo.height);
+
+            return dimensoes;
+        }
+    }
+
+    vk::ImageView criarVisaoDeImagem(
+        const vk::Image& imagem,
+        vk::Format formato,
+        vk::ImageAspectFlags aspectos =
+            vk::ImageAspectFlagBits::eColor,
+        uint32_t numNiveis = 1,
+        uint32_t primeiroNivel = 0) {
+        vk::ImageViewCreateInfo info;
+        // info.flags = {};
+        info.image = imagem;
+        info.viewType = vk::ImageViewType::e2D;
+        info.format = formato;
+        // info.components = {};
+        info.subresourceRange.aspectMask = aspectos;
+        info.subresourceRange.baseMipLevel = primeiroNivel;
+        info.subresourceRange.levelCount = numNiveis;
+        info.subresourceRange.baseArrayLayer = 0;
+        info.subresourceRange.layerCount = 1;
+
+        return dispositivo_.createImageView(info);
+    }
+
+    // Todos os anexos do quadro além das imagens da swapchain.
+    // Os passes que vierem depois do principal, como os de
+    // pós-processamento, declaram seus alvos aqui também.
+    void criarAlvosDeRenderizacao() {
+        poolDeAlvos_.comecar();
+        criarImagemDeProfundidade();
+        poolDeAlvos_.compilar();
+    }
+
+    void criarImagemDeProfundidade() {
+        formatoDaImagemDeProfundidade_ = buscarFormatoSuportado(
+            {vk::Format::eD32Sfloat,
+             vk::Format::eD32SfloatS8Uint,
+             vk::Format::eD24UnormS8Uint},
+            vk::FormatFeatureFlagBits::eDepthStencilAttachment);
+
+        vk::ImageAspectFlags aspectos =
+            vk::ImageAspectFlagBits::eDepth;
+        if (formatoPossuiEstencil(
+                formatoDaImagemDeProfundidade_)) {
+            aspectos |= vk::ImageAspectFlagBits::eStencil;
+        }
+
+        // A profundidade nunca é guardada (eDontCare), então
+        // pode ficar só na memória do tile em GPUs que a
+        // alocam sob demanda. A transição de layout fica a
+        // cargo do passe de renderização, que parte de
+        // eUndefined.
+        DescricaoDeAlvo descricao;
+        descricao.formato = formatoDaImagemDeProfundidade_;
+        descricao.dimensoes = dimensoesDaSwapchain_;
+        descricao.usos =
+            vk::ImageUsageFlagBits::eDepthStencilAttachment |
+            vk::ImageUsageFlagBits::eTransientAttachment;
+        descricao.aspectos = aspectos;
+        descricao.primeiroPasse = 0;
+        descricao.ultimoPasse = 0;
+        // Com o descarte por oclusão, a profundidade da
+        // primeira fase é guardada, lida pela construção da
+        // pirâmide e carregada pela segunda fase. O formato é
+        // o primeiro candidato, sem estêncil.
+        if (suportaOclusao_) {
+            descricao.usos =
+                vk::ImageUsageFlagBits::
+                    eDepthStencilAttachment |
+                vk::ImageUsageFlagBits::eSampled;
+            descricao.ultimoPasse = 2;
+        }
+        alvoDeProfundidade_ = poolDeAlvos_.declarar(descricao);
+    }
+
+    vk::Format buscarFormatoSuportado(
+        std::initializer_list<vk::Format> candidatos,
+        vk::FormatFeatureFlags capacidades) {
+        auto resultado = std::find_if(
+            candidatos.begin(), candidatos.end(),
+            [this, capacidades](const vk::Format& candidato) {
+                auto propriedades =
+                    dispositivoFisico_.getFormatProperties(
+                        candidato);
+
+                return (propriedades.optimalTilingFeatures &
+                        capacidades) == capacidades;
+            });
+
+        if (resultado == candidatos.end()) {
+            throw std::runtime_error(
+                "Não foi encontrado um formato suportado.");
+        }
+
+        return *resultado;
+    }
+
+    bool formatoPossuiEstencil(vk::Format formato) {
+        return formato == vk::Format::eD32SfloatS8Uint ||
+               formato == vk::Format::eD24UnormS8Uint;
+    }
+
+    void criarImagem(vk::Format formato,
+                     vk::Extent3D dimensoes,
+                     vk::ImageUsageFlags usos,
+                     vk::Image& imagem,
+                     Alocacao& alocacao,
+                     uint32_t numNiveis = 1) {
+        vk::ImageCreateInfo info;
+        // info.flags = {};
+        info.imageType = vk::ImageType::e2D;
+        info.format = formato;
+        info.extent = dimensoes;
+        info.mipLevels = numNiveis;
+        info.arrayLayers = 1;
+        info.samples = vk::SampleCountFlagBits::e1;
+        info.tiling = vk::ImageTiling::eOptimal;
+        info.usage = usos;
+        info.sharingMode = vk::SharingMode::eExclusive;
+        // info.queueFamilyIndexCount = 0;
+        // info.pQueueFamilyIndices = nullptr;
+        info.initialLayout = vk::ImageLayout::eUndefined;
+
+        imagem = dispositivo_.createImage(info);
+
+        auto requisitosDeMemoria =
+            dispositivo_.getImageMemoryRequirements(imagem);
+        auto tipoDeMemoria = buscarTipoDeMemoria(
+            requisitosDeMemoria.memoryTypeBits,
+            vk::MemoryPropertyFlagBits::eDeviceLocal,
+            requisitosDeMemoria.size);
+        alocacao = alocador_.alocar(requisitosDeMemoria,
+                                    tipoDeMemoria, false);
+        dispositivo_.bindImageMemory(imagem, alocacao.memoria,
+                                     alocacao.deslocamento);
+    }
+
+    void criarPasseDeRenderizacao() {
+        passeDeRenderizacao_ = criarPasse(false, false);
+        // As duas fases do descarte por oclusão dividem o
+        // quadro em dois passes compatíveis com o de cima, que
+        // usam as mesmas pipelines e framebuffers. A primeira
+        // guarda a profundidade para a pirâmide, e a segunda
+        // continua de onde ela parou.
+        if (suportaOclusao_) {
+            passeDaPrimeiraFase_ = criarPasse(false, true);
+            passeDaSegundaFase_ = criarPasse(true, false);
+        }
+    }
+
+    // `carregar` continua um passe que guardou os anexos, e
+    // `guardar` deixa a profundidade pronta para ser lida pelos
+    // shaders de computação e a cor para o próximo passe.
+    vk::RenderPass criarPasse(bool carregar, bool guardar) {
+        auto carga = carregar ? vk::AttachmentLoadOp::eLoad
+                              : vk::AttachmentLoadOp::eClear;
+        auto layoutDaCorAntes =
+            carregar ? vk::ImageLayout::eColorAttachmentOptimal
+                     : vk::ImageLayout::eUndefined;
+        auto layoutDaCorDepois =
+            guardar ? vk::ImageLayout::eColorAttachmentOptimal
+                    : vk::ImageLayout::ePresentSrcKHR;
+        auto layoutDaProfundidadeAntes =
+            carregar ? vk::ImageLayout::
+                           eDepthStencilReadOnlyOptimal
+                     : vk::ImageLayout::eUndefined;
+        auto layoutDaProfundidadeDepois =
+            guardar ? vk::ImageLayout::
+                          eDepthStencilReadOnlyOptimal
+                    : vk::ImageLayout::
+                          eDepthStencilAttachmentOptimal;
+        std::array<vk::AttachmentDescription, 2> anexos = {
+            vk::AttachmentDescription(
+                {}, formatoDaSwapchain_,
+                vk::SampleCountFlagBits::e1, carga,
+                vk::AttachmentStoreOp::eStore,
+                vk::AttachmentLoadOp::eDontCare,
+                vk::AttachmentStoreOp::eDontCare,
+                layoutDaCorAntes, layoutDaCorDepois),
+            vk::AttachmentDescription(
+                {}, formatoDaImagemDeProfundidade_,
+                vk::SampleCountFlagBits::e1, carga,
+                guardar ? vk::AttachmentStoreOp::eStore
+                        : vk::AttachmentStoreOp::eDontCare,
+                vk::AttachmentLoadOp::eDontCare,
+                vk::AttachmentStoreOp::eDontCare,
+                layoutDaProfundidadeAntes,
+                layoutDaProfundidadeDepois)};
+
+        vk::AttachmentReference refAnexoCor(
+            0, vk::ImageLayout::eColorAttachmentOptimal);
+
+        vk::AttachmentReference refAnexoProfundidade(
+            1, vk::ImageLayout::eDepthStencilAttachmentOptimal);
+
+        vk::SubpassDescription subpasse;
+        // subpasse.flags = {};
+        // subpasse.pipelineBindPoint =
+        // vk::PipelineBindPoint::eGraphics;
+        // subpasse.inputAttachmentCount = 0;
+        // subpasse.pInputAttachments = nullptr;
+        subpasse.colorAttachmentCount = 1;
+        subpasse.pColorAttachments = &refAnexoCor;
+        // subpasse.pResolveAttachments = nullptr;
+        subpasse.pDepthStencilAttachment =
+            &refAnexoProfundidade;
+        // subpasse.preserveAttachmentCount = 0;
+        // subpasse.pPreserveAttachments = nullptr;
+
+        std::vector<vk::SubpassDependency> dependencias;
+        vk::SubpassDependency dependenciaAnexoDeCor;
+        dependenciaAnexoDeCor.srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependenciaAnexoDeCor.dstSubpass = 0;
+        dependenciaAnexoDeCor.srcStageMask =
+            vk::PipelineStageFlagBits::eColorAttachmentOutput |
+            vk::PipelineStageFlagBits::eEarlyFragmentTests;
+        dependenciaAnexoDeCor.dstStageMask =
+            vk::PipelineStageFlagBits::eColorAttachmentOutput |
+            vk::PipelineStageFlagBits::eEarlyFragmentTests;
+        dependenciaAnexoDeCor.srcAccessMask = {};
+        dependenciaAnexoDeCor.dstAccessMask =
+            vk::AccessFlagBits::eColorAttachmentWrite |
+            vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+        // A segunda fase espera a primeira escrever os anexos
+        // e a pirâmide terminar de ler a profundidade. A
+        // primeira fase espera o mesmo do quadro anterior,
+        // antes de limpar a profundidade.
+        if (carregar || guardar) {
+            dependenciaAnexoDeCor.srcStageMask |=
+                vk::PipelineStageFlagBits::eLateFragmentTests |
+                vk::PipelineStageFlagBits::eComputeShader;
+            dependenciaAnexoDeCor.srcAccessMask =
+                vk::AccessFlagBits::eColorAttachmentWrite |
+                vk::AccessFlagBits::
+                    eDepthStencilAttachmentWrite;
+        }
+        if (carregar) {
+            dependenciaAnexoDeCor.dstAccessMask |=
+                vk::AccessFlagBits::eColorAttachmentRead |
+                vk::AccessFlagBits::eDepthStencilAttachmentRead;
+        }
+        dependencias.push_back(dependenciaAnexoDeCor);
+        if (guardar) {
+            vk::SubpassDependency dependenciaDaPiramide;
+            dependenciaDaPiramide.srcSubpass = 0;
+            dependenciaDaPiramide.dstSubpass =
+                VK_SUBPASS_EXTERNAL;
+            dependenciaDaPiramide.srcStageMask =
+                vk::PipelineStageFlagBits::eEarlyFragmentTests |
+                vk::PipelineStageFlagBits::eLateFragmentTests;
+            dependenciaDaPiramide.dstStageMask =
+                vk::PipelineStageFlagBits::eComputeShader;
+            dependenciaDaPiramide.srcAccessMask =
+                vk::AccessFlagBits::
+                    eDepthStencilAttachmentWrite;
+            dependenciaDaPiramide.dstAccessMask =
+                vk::AccessFlagBits::eShaderRead;
+            dependencias.push_back(dependenciaDaPiramide);
+        }
+
+        vk::RenderPassCreateInfo info;
+        info.attachmentCount =
+            static_cast<uint32_t>(anexos.size());
+        info.pAttachments = anexos.data();
+        info.subpassCount = 1;
+        info.pSubpasses = &subpasse;
+        info.dependencyCount =
+            static_cast<uint32_t>(dependencias.size());
+        info.pDependencies = dependencias.data();
+
+        return dispositivo_.createRenderPass(info);
+    }
+
+    void criarFramebuffers() {
+        auto visaoDeProfundidade =
+            poolDeAlvos_.alvo(alvoDeProfundidade_).visao;
+        std::transform(visoesDasImagensDaSwapchain_.begin(),
+                       visoesDasImagensDaSwapchain_.end(),
+                       std::back_inserter(framebuffers_),
+                       [this, visaoDeProfundidade](
+                           const vk::ImageView& i) {
+                           return criarFramebuffer(
+                               i, visaoDeProfundidade);
+                       });
+    }
+
+    vk::Framebuffer criarFramebuffer(
+        const vk::ImageView& imagemDaSwapchain,
+        const vk::ImageView& imagemDeProfundidade) {
+        std::array<vk::ImageView, 2> anexos = {
+            imagemDaSwapchain, imagemDeProfundidade};
+
+        vk::FramebufferCreateInfo info;
+        info.renderPass = passeDeRenderizacao_;
+        info.attachmentCount =
+            static_cast<uint32_t>(anexos.size());
+        info.pAttachments = anexos.data();
+        info.width = dimensoesDaSwapchain_.width;
+        info.height = dimensoesDaSwapchain_.height;
+        info.layers = 1;
+
+        return dispositivo_.createFramebuffer(info);
+    }
+
+    void criarLayoutsDosSetsDeDescritores() {
+        std::array<vk::DescriptorSetLayoutBinding, 2>
+            associacoes = {
+                vk::DescriptorSetLayoutBinding{
+                    0,
+                    vk::DescriptorType::eUniformBufferDynamic,
+                    1, vk::ShaderStageFlagBits::eVertex},
+                vk::DescriptorSetLayoutBinding{
+                    1,
+                    vk::DescriptorType::eCombinedImageSampler,
+                    1, vk::ShaderStageFlagBits::eFragment}};
+
+        vk::DescriptorSetLayoutCreateInfo info;
+        info.bindingCount =
+            static_cast<uint32_t>(associacoes.size());
+        info.pBindings = associacoes.data();
+
+        layoutDoSetDeDescritores_ =
+            dispositivo_.createDescriptorSetLayout(info);
+
+        // O set 1 é o da cena. Os shaders de vértices só leem
+        // os objetos, as malhas e as instâncias. A pirâmide de
+        // profundidade e os adiados são do descarte por
+        // oclusão.
+        auto estagios = vk::ShaderStageFlagBits::eVertex |
+                        vk::ShaderStageFlagBits::eCompute;
+        std::array<vk::DescriptorSetLayoutBinding, 7>
+            associacoesDaCena = {
+                vk::DescriptorSetLayoutBinding{
+                    0, vk::DescriptorType::eStorageBuffer, 1,
+                    estagios},
+                vk::DescriptorSetLayoutBinding{
+                    1, vk::DescriptorType::eStorageBuffer, 1,
+                    estagios},
+                vk::DescriptorSetLayoutBinding{
+                    2, vk::DescriptorType::eStorageBuffer, 1,
+                    vk::ShaderStageFlagBits::eCompute},
+                vk::DescriptorSetLayoutBinding{
+                    3,
+                    vk::DescriptorType::eUniformBufferDynamic,
+                    1, vk::ShaderStageFlagBits::eCompute},
+                vk::DescriptorSetLayoutBinding{
+                    4, vk::DescriptorType::eStorageBuffer, 1,
+                    vk::ShaderStageFlagBits::eVertex},
+                vk::DescriptorSetLayoutBinding{
+                    5,
+                    vk::DescriptorType::eCombinedImageSampler,
+                    1, vk::ShaderStageFlagBits::eCompute},
+                vk::DescriptorSetLayoutBinding{
+                    6, vk::DescriptorType::eStorageBuffer, 1,
+                    vk::ShaderStageFlagBits::eCompute}};
+        info.bindingCount =
+            static_cast<uint32_t>(associacoesDaCena.size());
+        info.pBindings = associacoesDaCena.data();
+        layoutDoSetDaCena_ =
+            dispositivo_.createDescriptorSetLayout(info);
+    }
+
+    // O passe que escolhe os desenhos da cena usa o mesmo
+    // layout, sem push constants.
+    void criarLayoutDaPipeline() {
+        vk::PushConstantRange intervalo = {
+            vk::ShaderStageFlagBits::eVertex, 0,
+            sizeof(PushConstants)};
+
+        std::array<vk::DescriptorSetLayout, 2> layouts = {
+            layoutDoSetDeDescritores_, layoutDoSetDaCena_};
+        vk::PipelineLayoutCreateInfo info;
+        info.setLayoutCount =
+            static_cast<uint32_t>(layouts.size());
+        info.pSetLayouts = layouts.data();
+        info.pushConstantRangeCount = 1;
+        info.pPushConstantRanges = &intervalo;
+
+        layoutDaPipeline_ =
+            dispositivo_.createPipelineLayout(info);
+    }
+
+    void carregarShaders(ConjuntoDeShaders& shaders) {
+        shaders.vertices =
+            carregarShader(kCaminhoShaderDeVertices);
+        shaders.fragmentos =
+            carregarShader(kCaminhoShaderDeFragmento);
+        shaders.profundidade =
+            carregarShader(kCaminhoShaderDeProfundidade);
+        shaders.descarte =
+            carregarShader(kCaminhoShaderDeDescarte);
+        shaders.cena = carregarShader(kCaminhoShaderDaCena);
+        if (suportaCenaNaGpu_) {
+            shaders.piramide =
+                carregarShader(kCaminhoShaderDaPiramide);
+        }
+    }
+
+    vk::ShaderModule carregarShader(
+        const std::string& caminho) {
+        std::ifstream arquivoDoShader(caminho,
+                                      std::ios::binary);
+
+        if (!arquivoDoShader.is_open()) {
+            throw std::runtime_error(
+                "Não foi possível abrir o arquivo '" + caminho +
+                "'!");
+        }
+
+        std::vector<char> codigoDoShader(
+            (std::istreambuf_iterator<char>(arquivoDoShader)),
+            (std::istreambuf_iterator<char>()));
+
+        vk::ShaderModuleCreateInfo info;
+        info.codeSize = codigoDoShader.size();
+        info.pCode = reinterpret_cast<const uint32_t*>(
+            codigoDoShader.data());
+
+        return dispositivo_.createShaderModule(info);
+    }
+
+    // Com o passe prévio, a profundidade já está pronta quando
+    // as cores são desenhadas, e o shader de fragmentos só roda
+    // na superfície visível. O passe prévio só lê o fluxo de
+    // posições.
+    void criarPipeline() {
+        criarPipelines(shaders_, formatoDeVertice_,
+                       passePrevioDeProfundidade_,
+                       passeDeRenderizacao_);
+    }
+
+    // As pipelines gráficas, que dependem do formato de vértice
+    // e do passe prévio; os shaders continuam.
+    void destruirPipelines() {
+        dispositivo_.destroyPipeline(
+            shaders_.pipelineDeProfundidadeDaCena);
+        dispositivo_.destroyPipeline(shaders_.pipelineDaCena);
+        dispositivo_.destroyPipeline(
+            shaders_.pipelineDeProfundidade);
+        dispositivo_.destroyPipeline(shaders_.pipeline);
+    }
+
+    // Só lê os argumentos e o layout da pipeline, então pode
+    // rodar numa thread de trabalho.
+    void criarPipelines(ConjuntoDeShaders& shaders,
+                        FormatoDeVertice formato,
+                        bool passePrevio,
+                        vk::RenderPass passe) {
+        for (bool cenaNaGpu : {false, true}) {
+            auto pipeline = criarPipelineGrafica(
+                shaders.vertices, shaders.fragmentos,
+                entradaDoFormato(formato), !passePrevio,
+                passePrevio ? vk::CompareOp::eLessOrEqual
+                            : vk::CompareOp::eLess,
+                passe, cenaNaGpu);
+            auto pipelineDeProfundidade = criarPipelineGrafica(
+                shaders.profundidade, nullptr,
+                entradaDoFormato(formato, {kFluxoDePosicao}),
+                true, vk::CompareOp::eLess, passe, cenaNaGpu);
+            if (cenaNaGpu) {
+                shaders.pipelineDaCena = pipeline;
+                shaders.pipelineDeProfundidadeDaCena =
+                    pipelineDeProfundidade;
+            } else {
+                shaders.pipeline = pipeline;
+                shaders.pipelineDeProfundidade =
+                    pipelineDeProfundidade;
+            }
+        }
+    }
+
+    // Sem shader de fragmentos, a pipeline só escreve a
+    // profundidade. `cenaNaGpu` especializa o shader de
+    // vértices para ler o objeto e a malha dos buffers da cena.
+    vk::Pipeline criarPipelineGrafica(
+        vk::ShaderModule vertices,
+        vk::ShaderModule fragmentos,
+        const EntradaDeVertices& entrada,
+        bool escreverProfundidade,
+        vk::CompareOp comparacaoDeProfundidade,
+        vk::RenderPass passe,
+        bool cenaNaGpu) {
+        vk::Bool32 valorDaCena = cenaNaGpu ? VK_TRUE : VK_FALSE;
+        vk::SpecializationMapEntry mapa = {
+            0, 0, sizeof(vk::Bool32)};
+        vk::SpecializationInfo especializacao = {
+            1, &mapa, sizeof(vk::Bool32), &valorDaCena};
+        std::vector<vk::PipelineShaderStageCreateInfo> estagios{
+            vk::PipelineShaderStageCreateInfo{
+                {},
+                vk::ShaderStageFlagBits::eVertex,
+                vertices,
+                "main",
+                &especializacao}};
+        if (fragmentos) {
+            estagios.push_back(
+                vk::PipelineShaderStageCreateInfo{
+                    {},
+                    vk::ShaderStageFlagBits::eFragment,
+                    fragmentos,
+                    "main"});
+        }
+
+        vk::PipelineVertexInputStateCreateInfo infoVertices;
+        infoVertices.vertexBindingDescriptionCount =
+            static_cast<uint32_t>(entrada.associacoes.size());
+        infoVertices.pVertexBindingDescriptions =
+            entrada.associacoes.data();
+        infoVertices.vertexAttributeDescriptionCount =
+            static_cast<uint32_t>(entrada.atributos.size());
+        infoVertices.pVertexAttributeDescriptions =
+            entrada.atributos.data();
+
+        vk::PipelineInputAssemblyStateCreateInfo infoEntrada;
+        infoEntrada.topology =
+            vk::PrimitiveTopology::eTriangleList;
+
+        vk::PipelineViewportStateCreateInfo infoViewport;
+        infoViewport.viewportCount = 1;
+        infoViewport.scissorCount = 1;
+
+        vk::PipelineRasterizationStateCreateInfo
+            infoRasterizador;
+        infoRasterizador.polygonMode = vk::PolygonMode::eFill;
+        infoRasterizador.cullMode = vk::CullModeFlagBits::eBack;
+        infoRasterizador.frontFace =
+            vk::FrontFace::eCounterClockwise;
+        infoRasterizador.lineWidth = 1.0f;
+
+        vk::PipelineMultisampleStateCreateInfo infoAmostragem;
+
+        vk::PipelineDepthStencilStateCreateInfo
+            infoProfundidade;
+        infoProfundidade.depthTestEnable = true;
+        infoProfundidade.depthWriteEnable =
+            escreverProfundidade;
+        infoProfundidade.depthCompareOp =
+            comparacaoDeProfundidade;
+
+        vk::PipelineColorBlendAttachmentState
+            misturaDoAnexoDeCor;
+        if (fragmentos) {
+            misturaDoAnexoDeCor.colorWriteMask =
+                vk::ColorComponentFlagBits::eR |
+                vk::ColorComponentFlagBits::eG |
+                vk::ColorComponentFlagBits::eB |
+                vk::ColorComponentFlagBits::eA;
+        }
+        misturaDoAnexoDeCor.blendEnable = false;
+
+        // Sobrescrita
+        // misturaDoAnexoDeCor.srcColorBlendFactor =
+        // vk::BlendFactor::eOne;
+        // misturaDoAnexoDeCor.dstColorBlendFactor =
+        // vk::BlendFactor::eZero;
+        // misturaDoAnexoDeCor.colorBlendOp = vk::BlendOp::eAdd;
+        // misturaDoAnexoDeCor.srcAlphaBlendFactor =
+        // vk::BlendFactor::eOne;
+        // misturaDoAnexoDeCor.dstAlphaBlendFactor =
+        // vk::BlendFactor::eZero;
+        // misturaDoAnexoDeCor.alphaBlendOp = vk::BlendOp::eAdd;
+
+        // Alpha blending
+        // misturaDoAnexoDeCor.srcColorBlendFactor =
+        // vk::BlendFactor::eSrcAlpha;
+        // misturaDoAnexoDeCor.dstColorBlendFactor =
+        //     vk::BlendFactor::eOneMinusSrcAlpha;
+        // misturaDoAnexoDeCor.colorBlendOp = vk::BlendOp::eAdd;
+        // misturaDoAnexoDeCor.srcAlphaBlendFactor =
+        // vk::BlendFactor::eOne;
+        // misturaDoAnexoDeCor.dstAlphaBlendFactor =
+        // vk::BlendFactor::eZero;
+        // misturaDoAnexoDeCor.alphaBlendOp = vk::BlendOp::eAdd;
+
+        vk::PipelineColorBlendStateCreateInfo infoMistura;
+        infoMistura.attachmentCount = 1;
+        infoMistura.pAttachments = &misturaDoAnexoDeCor;
+
+        std::array<vk::DynamicState, 2> estadosDinamicos = {
+            vk::DynamicState::eViewport,
+            vk::DynamicState::eScissor};
+        vk::PipelineDynamicStateCreateInfo infoEstadosDinamicos;
+        infoEstadosDinamicos.dynamicStateCount =
+            static_cast<uint32_t>(estadosDinamicos.size());
+        infoEstadosDinamicos.pDynamicStates =
+            estadosDinamicos.data();
+
+        vk::GraphicsPipelineCreateInfo info;
+        // info.flags = {}
+        info.stageCount =
+            static_cast<uint32_t>(estagios.size());
+        info.pStages = estagios.data();
+        info.pVertexInputState = &infoVertices;
+        info.pInputAssemblyState = &infoEntrada;
+        info.pViewportState = &infoViewport;
+        info.pRasterizationState = &infoRasterizador;
+        info.pMultisampleState = &infoAmostragem;
+        info.pDepthStencilState = &infoProfundidade;
+        info.pColorBlendState = &infoMistura;
+        info.pDynamicState = &infoEstadosDinamicos;
+        info.layout = layoutDaPipeline_;
+        info.renderPass = passe;
+        info.subpass = 0;
+
+        return dispositivo_.createGraphicsPipeline({}, info)
+            .value;
+    }
+
+    // O descarte de meshlets tem o próprio layout, com os
+    // buffers que o shader lê e escreve.
+    void criarLayoutDoDescarte() {
+        std::array<vk::DescriptorSetLayoutBinding, 4>
+            associacoes;
+        for (uint32_t i = 0; i < associacoes.size(); i++) {
+            associacoes[i] = vk::DescriptorSetLayoutBinding{
+                i, vk::DescriptorType::eStorageBuffer, 1,
+                vk::ShaderStageFlagBits::eCompute};
+        }
+        vk::DescriptorSetLayoutCreateInfo infoDoSet;
+        infoDoSet.bindingCount =
+            static_cast<uint32_t>(associacoes.size());
+        infoDoSet.pBindings = associacoes.data();
+        layoutDoSetDeDescarte_ =
+            dispositivo_.createDescriptorSetLayout(infoDoSet);
+
+        vk::PushConstantRange intervalo = {
+            vk::ShaderStageFlagBits::eCompute, 0,
+            sizeof(ConstantesDoDescarte)};
+        vk::PipelineLayoutCreateInfo infoDoLayout;
+        infoDoLayout.setLayoutCount = 1;
+        infoDoLayout.pSetLayouts = &layoutDoSetDeDescarte_;
+        infoDoLayout.pushConstantRangeCount = 1;
+        infoDoLayout.pPushConstantRanges = &intervalo;
+        layoutDoDescarte_ =
+            dispositivo_.createPipelineLayout(infoDoLayout);
+    }
+
+    // Como criarPipelines, só lê os layouts, então pode rodar
+    // numa thread de trabalho. A cena só usa o set 1 do layout
+    // das pipelines gráficas.
+    void criarPipelinesDeComputacao(
+        ConjuntoDeShaders& shaders) {
+        shaders.pipelineDeDescarte = criarPipelineDeComputacao(
+            shaders.descarte, layoutDoDescarte_);
+        shaders.pipelineDeEscolhaDaCena = criarPipelineDaFase(
+            shaders.cena, kSemOclusao);
+        if (suportaOclusao_) {
+            shaders.pipelineDaPrimeiraFase =
+                criarPipelineDaFase(shaders.cena,
+                                    kPrimeiraFase);
+            shaders.pipelineDaSegundaFase =
+                criarPipelineDaFase(shaders.cena, kSegundaFase);
+        }
+        if (suportaCenaNaGpu_) {
+            shaders.pipelineDaPiramide =
+                criarPipelineDeComputacao(shaders.piramide,
+                                          layoutDaPiramide_);
+        }
+    }
+
+    // A fase do descarte por oclusão é uma constante de
+    // especialização do shader da cena.
+    vk::Pipeline criarPipelineDaFase(vk::ShaderModule shader,
+                                     uint32_t fase) {
+        vk::SpecializationMapEntry entrada{0, 0,
+                                           sizeof(fase)};
+        vk::SpecializationInfo especializacao{
+            1, &entrada, sizeof(fase), &fase};
+        return criarPipelineDeComputacao(
+            shader, layoutDaPipeline_, &especializacao);
+    }
+
+    vk::Pipeline criarPipelineDeComputacao(
+        vk::ShaderModule shader,
+        vk::PipelineLayout layout,
+        const vk::SpecializationInfo* especializacao =
+            nullptr) {
+        vk::ComputePipelineCreateInfo info;
+        info.stage = vk::PipelineShaderStageCreateInfo{
+            {},
+            vk::ShaderStageFlagBits::eCompute,
+            shader,
+            "main",
+            especializacao};
+        info.layout = layout;
+        return dispositivo_.createComputePipeline({}, info)
+            .value;
+    }
+
+    void criarLayoutDaPiramide() {
+        std::array<vk::DescriptorSetLayoutBinding, 2>
+            associacoes = {
+                vk::DescriptorSetLayoutBinding{
+                    0,
+                    vk::DescriptorType::eCombinedImageSampler,
+                    1, vk::ShaderStageFlagBits::eCompute},
+                vk::DescriptorSetLayoutBinding{
+                    1, vk::DescriptorType::eStorageImage, 1,
+                    vk::ShaderStageFlagBits::eCompute}};
+        vk::DescriptorSetLayoutCreateInfo infoDoSet;
+        infoDoSet.bindingCount =
+            static_cast<uint32_t>(associacoes.size());
+        infoDoSet.pBindings = associacoes.data();
+        layoutDoSetDaPiramide_ =
+            dispositivo_.createDescriptorSetLayout(infoDoSet);
+
+        vk::PipelineLayoutCreateInfo infoDoLayout;
+        infoDoLayout.setLayoutCount = 1;
+        infoDoLayout.pSetLayouts = &layoutDoSetDaPiramide_;
+        layoutDaPiramide_ =
+            dispositivo_.createPipelineLayout(infoDoLayout);
+
+        // Sem filtro, para que cada texel amostrado seja uma
+        // profundidade da tela, e sem passar da borda.
+        vk::SamplerCreateInfo infoDoAmostrador;
+        infoDoAmostrador.magFilter = vk::Filter::eNearest;
+        infoDoAmostrador.minFilter = vk::Filter::eNearest;
+        infoDoAmostrador.mipmapMode =
+            vk::SamplerMipmapMode::eNearest;
+        infoDoAmostrador.addressModeU =
+            vk::SamplerAddressMode::eClampToEdge;
+        infoDoAmostrador.addressModeV =
+            vk::SamplerAddressMode::eClampToEdge;
+        infoDoAmostrador.maxLod = VK_LOD_CLAMP_NONE;
+        amostradorDaPiramide_ =
+            dispositivo_.createSampler(infoDoAmostrador);
+    }
+
+    // O nível 0 tem a maior potência de 2 que cabe na tela, e
+    // cada nível seguinte cobre o dobro da região do anterior.
+    // Os níveis ficam no layout geral, escritos como imagens de
+    // armazenamento e lidos como texturas; a transição é
+    // gravada no próximo quadro. Sem o descarte por oclusão, a
+    // pirâmide só completa o set da cena, e um texel basta.
+    PiramideDeProfundidade criarPiramideDeProfundidade() {
+        auto potenciaDe2 = [](uint32_t lado) {
+            uint32_t potencia = 1;
+            while (potencia * 2 <= lado) {
+                potencia *= 2;
+            }
+            return potencia;
+        };
+        PiramideDeProfundidade piramide;
+        piramide.dimensoes =
+            suportaOclusao_
+                ? vk::Extent2D{
+                      potenciaDe2(dimensoesDaSwapchain_.width),
+                      potenciaDe2(dimensoesDaSwapchain_.height)}
+                : vk::Extent2D{1, 1};
+        uint32_t numNiveis =
+            numNiveisDeMip(piramide.dimensoes.width,
+                           piramide.dimensoes.height);
+        criarImagem(vk::Format::eR32Sfloat,
+                    vk::Extent3D{piramide.dimensoes, 1},
+                    vk::ImageUsageFlagBits::eStorage |
+                        vk::ImageUsageFlagBits::eSampled,
+                    piramide.imagem, piramide.alocacao,
+                    numNiveis);
+        piramide.visao = criarVisaoDeImagem(
+            piramide.imagem, vk::Format::eR32Sfloat,
+            vk::ImageAspectFlagBits::eColor, numNiveis);
+        for (uint32_t nivel = 0; nivel < numNiveis; nivel++) {
+            piramide.visoesDosNiveis.push_back(
+                criarVisaoDeImagem(
+                    piramide.imagem, vk::Format::eR32Sfloat,
+                    vk::ImageAspectFlagBits::eColor, 1, nivel));
+        }
+
+        std::array<vk::DescriptorPoolSize, 2> tamanhos = {
+            vk::DescriptorPoolSize{
+                vk::DescriptorType::eCombinedImageSampler,
+                numNiveis},
+            vk::DescriptorPoolSize{
+                vk::DescriptorType::eStorageImage, numNiveis}};
+        vk::DescriptorPoolCreateInfo infoDoPool;
+        infoDoPool.maxSets = numNiveis;
+        infoDoPool.poolSizeCount =
+            static_cast<uint32_t>(tamanhos.size());
+        infoDoPool.pPoolSizes = tamanhos.data();
+        piramide.poolDeDescritores =
+            dispositivo_.createDescriptorPool(infoDoPool);
+
+        std::vector<vk::DescriptorSetLayout> layouts(
+            numNiveis, layoutDoSetDaPiramide_);
+        vk::DescriptorSetAllocateInfo infoDosSets;
+        infoDosSets.descriptorPool = piramide.poolDeDescritores;
+        infoDosSets.descriptorSetCount = numNiveis;
+        infoDosSets.pSetLayouts = layouts.data();
+        piramide.sets =
+            dispositivo_.allocateDescriptorSets(infoDosSets);
+
+        // Sem o descarte por oclusão, a pirâmide nunca é
+        // construída.
+        for (uint32_t nivel = 0; nivel < numNiveis; nivel++) {
+            if (nivel == 0 && !suportaOclusao_) {
+                continue;
+            }
+            vk::DescriptorImageInfo origem =
+                nivel == 0
+                    ? vk::DescriptorImageInfo{
+                          amostradorDaPiramide_,
+                          poolDeAlvos_
+                              .alvo(alvoDeProfundidade_)
+                              .visao,
+                          vk::ImageLayout::
+                              eDepthStencilReadOnlyOptimal}
+                    : vk::DescriptorImageInfo{
+                          amostradorDaPiramide_,
+                          piramide.visoesDosNiveis[nivel - 1],
+                          vk::ImageLayout::eGeneral};
+            vk::DescriptorImageInfo destino{
+                {},
+                piramide.visoesDosNiveis[nivel],
+                vk::ImageLayout::eGeneral};
+            std::array<vk::WriteDescriptorSet, 2> escritas = {
+                vk::WriteDescriptorSet{
+                    piramide.sets[nivel], 0, 0, 1,
+                    vk::DescriptorType::eCombinedImageSampler,
+                    &origem},
+                vk::WriteDescriptorSet{
+                    piramide.sets[nivel], 1, 0, 1,
+                    vk::DescriptorType::eStorageImage,
+                    &destino}};
+            dispositivo_.updateDescriptorSets(escritas, {});
+        }
+
+        // Os sets das cenas apontam a pirâmide antiga, e a
+        // profundidade do quadro anterior se perdeu.
+        piramideSemLayout_ = true;
+        piramideValida_ = false;
+        versaoDaPiramide_++;
+        return piramide;
+    }
+
+    // Grava a transição da pirâmide nova para o layout geral
+    // antes de qualquer uso dela no quadro.
+    void prepararPiramide(vk::CommandBuffer bufferDeComandos) {
+        vk::ImageMemoryBarrier barreira;
+        barreira.dstAccessMask =
+            vk::AccessFlagBits::eShaderRead |
+            vk::AccessFlagBits::eShaderWrite;
+        barreira.oldLayout = vk::ImageLayout::eUndefined;
+        barreira.newLayout = vk::ImageLayout::eGeneral;
+        barreira.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barreira.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barreira.image = piramide_.imagem;
+        barreira.subresourceRange = vk::ImageSubresourceRange{
+            vk::ImageAspectFlagBits::eColor, 0,
+            VK_REMAINING_MIP_LEVELS, 0, 1};
+        bufferDeComandos.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTopOfPipe,
+            vk::PipelineStageFlagBits::eComputeShader, {}, {},
+            {}, barreira);
+        piramideSemLayout_ = false;
+    }
+
+    void destruirPiramideDeProfundidade(
+        PiramideDeProfundidade& piramide) {
+        dispositivo_.destroyDescriptorPool(
+            piramide.poolDeDescritores);
+        for (auto&& visao : piramide.visoesDosNiveis) {
+            dispositivo_.destroyImageView(visao);
+        }
+        dispositivo_.destroyImageView(piramide.visao);
+        dispositivo_.destroyImage(piramide.imagem);
+        alocador_.liberar(piramide.alocacao);
+    }
+
+    // Só no modo de depuração, e quando o CMake encontrou o
+    // glslc.
+    void iniciarRecargaDeShaders() {
+        if (kRecarregarShaders && !kPastaDosShaders.empty()) {
+            recargaDeShadersAtiva_ =
+                vigiaDeShaders_.vigiar(kPastaDosShaders);
+        }
+    }
+
+    // Roda no começo de cada quadro. Só uma recarga fica em
+    // andamento; o que mudar enquanto isso entra na próxima.
+    void verificarShadersModificados() {
+        if (!recargaDeShadersAtiva_) {
+            return;
+        }
+        for (auto&& nome : vigiaDeShaders_.modificados()) {
+            marcarShaderModificado(nome);
+        }
+        if (!shadersModificados_.empty() &&
+            !recarregandoShaders()) {
+            recarregarShaders(std::move(shadersModificados_));
+            shadersModificados_.clear();
+        }
+    }
+
+    // Um arquivo .glsl não é compilado sozinho: os shaders que
+    // o incluem é que são recompilados.
+    void marcarShaderModificado(const std::string& nome) {
+        auto extensao = nome.substr(nome.find_last_of('.') + 1);
+        if (extensao == "glsl") {
+            for (auto&& incluidor : incluidoresDe(nome)) {
+                marcarShaderModificado(incluidor);
+            }
+            return;
+        }
+        bool ehShader = extensao == "vert" ||
+                        extensao == "frag" ||
+                        extensao == "comp";
+        if (ehShader &&
+            std::find(shadersModificados_.begin(),
+                      shadersModificados_.end(),
+                      nome) == shadersModificados_.end()) {
+            shadersModificados_.push_back(nome);
+        }
+    }
+
+    std::vector<std::string> incluidoresDe(
+        const std::string& nome) {
+        std::vector<std::string> incluidores;
+        std::string diretiva = "#include \"" + nome + "\"";
+        for (auto&& entrada :
+             std::filesystem::directory_iterator(
+                 kPastaDosShaders)) {
+            std::ifstream arquivo(entrada.path());
+            std::string conteudo(
+                (std::istreambuf_iterator<char>(arquivo)),
+                (std::istreambuf_iterator<char>()));
+            auto incluidor = entrada.path().filename().string();
+            if (incluidor != nome &&
+                conteudo.find(diretiva) != std::string::npos) {
+                incluidores.push_back(incluidor);
+            }
+        }
+        return incluidores;
+    }
+
+    bool recarregandoShaders() const {
+        return pedidoDeShaders_.has_value() &&
+               !carregador_.pronto(*pedidoDeShaders_);
+    }
+
+    // Compilar e criar as pipelines leva dezenas de
+    // milissegundos, então roda no carregador, e os quadros
+    // continuam com as pipelines atuais. Um erro de compilação
+    // só é impresso, e as pipelines atuais continuam.
+    void recarregarShaders(std::vector<std::string> nomes) {
+        pedidoDeShaders_ = carregador_.pedir(
+            [this, nomes = std::move(nomes),
+             formato = formatoDeVertice_,
+             passePrevio = passePrevioDeProfundidade_,
+             passe = passeDeRenderizacao_,
+             formatoDaSwapchain = formatoDaSwapchain_]()
+                -> CarregadorDeRecursos::Conclusao {
+                ConjuntoDeShaders novos;
+                try {
+                    novos = construirShaders(
+                        nomes, formato, passePrevio, passe);
+                } catch (const std::exception& e) {
+                    std::cerr << e.what() << std::endl;
+                    return []() {};
+                }
+                return [this, nomes, novos, formato,
+                        passePrevio, formatoDaSwapchain]() {
+                    // As pipelines foram recriadas em outro
+                    // formato, ou o passe em outro formato de
+                    // cor, enquanto estas eram criadas. Elas
+                    // são descartadas e a recarga se repete.
+                    if (formato != formatoDeVertice_ ||
+                        passePrevio !=
+                            passePrevioDeProfundidade_ ||
+                        formatoDaSwapchain !=
+                            formatoDaSwapchain_) {
+                        destruirShaders(novos);
+                        for (auto&& nome : nomes) {
+                            marcarShaderModificado(nome);
+                        }
+                        return;
+                    }
+                    trocarShaders(novos);
+                    std::cerr << "Shaders recarregados."
+                              << std::endl;
+                };
+            });
+    }
+
+    // Não usa nada que a thread principal modifique, então
+    // pode rodar numa thread de trabalho.
+    ConjuntoDeShaders construirShaders(
+        const std::vector<std::string>& nomes,
+        FormatoDeVertice formato,
+        bool passePrevio,
+        vk::RenderPass passe) {
+        for (auto&& nome : nomes) {
+            compilarShader(nome);
+        }
+
+        ConjuntoDeShaders shaders;
+        try {
+            carregarShaders(shaders);
+            criarPipelines(shaders, formato, passePrevio,
+                           passe);
+            criarPipelinesDeComputacao(shaders);
+        } catch (...) {
+            destruirShaders(shaders);
+            throw;
+        }
+        return shaders;
+    }
+
+    void compilarShader(const std::string& nome) {
+        std::string comando =
+            "\"" + kCompiladorDeShaders + "\" -o \"" +
+            kPastaDosShadersCompilados + "/" + nome +
+            ".spv\" \"" + kPastaDosShaders + "/" + nome + "\"";
+        if (std::system(comando.c_str()) != 0) {
+            throw std::runtime_error(
+                "Não foi possível compilar o shader '" + nome +
+                "'.");
+        }
+    }
+
+    // Quadros em execução ainda usam as pipelines atuais,
+    // então elas vão para a fila de destruição.
+    void trocarShaders(const ConjuntoDeShaders& novos) {
+        filaDeDestruicao_.adiar(
+            [this, antigos = shaders_]() {
+                destruirShaders(antigos);
+            });
+        shaders_ = novos;
+    }
+
+    void destruirShaders(const ConjuntoDeShaders& shaders) {
+        dispositivo_.destroyPipeline(
+            shaders.pipelineDaPiramide);
+        dispositivo_.destroyShaderModule(shaders.piramide);
+        dispositivo_.destroyPipeline(
+            shaders.pipelineDaSegundaFase);
+        dispositivo_.destroyPipeline(
+            shaders.pipelineDaPrimeiraFase);
+        dispositivo_.destroyPipeline(
+            shaders.pipelineDeEscolhaDaCena);
+        dispositivo_.destroyShaderModule(shaders.cena);
+        dispositivo_.destroyPipeline(
+            shaders.pipelineDeDescarte);
+        dispositivo_.destroyShaderModule(shaders.descarte);
+        dispositivo_.destroyPipeline(
+            shaders.pipelineDeProfundidadeDaCena);
+        dispositivo_.destroyPipeline(shaders.pipelineDaCena);
+        dispositivo_.destroyPipeline(
+            shaders.pipelineDeProfundidade);
+        dispositivo_.destroyPipeline(shaders.pipeline);
+        dispositivo_.destroyShaderModule(shaders.profundidade);
+        dispositivo_.destroyShaderModule(shaders.fragmentos);
+        dispositivo_.destroyShaderModule(shaders.vertices);
+    }
+
+    void criarBuffersDeComandos() {
+        vk::CommandBufferAllocateInfo info;
+        info.commandPool = poolDeComandos_;
+        info.commandBufferCount = kMaximoQuadrosEmExecucao;
+
+        buffersDeComandos_ =
+            dispositivo_.allocateCommandBuffers(info);
+    }
+
+    void gravarBufferDeComandos(
+        vk::CommandBuffer bufferDeComandos,
+        vk::Framebuffer framebuffer,
+        uint32_t deslocamentoDaOBU) {
+        vk::CommandBufferBeginInfo info;
+        info.flags =
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+        bufferDeComandos.begin(info);
+
+        if (piramideSemLayout_) {
+            prepararPiramide(bufferDeComandos);
+        }
+
+        // O set da cena é associado mesmo sem a cena na GPU,
+        // porque os shaders de vértices o declaram.
+        atualizarCenaDoQuadro();
+        const auto& cena = cenas_[quadroAtual_];
+        uint32_t deslocamentoDaCena =
+            arenaDeUniformes_.escrever(parametrosDaCena(cena));
+        bool ocluir = desenharCenaNaGpu_ && ocluirObjetos_ &&
+                      suportaOclusao_;
+        if (desenharCenaNaGpu_) {
+            escolherDesenhosNaGpu(bufferDeComandos,
+                                  deslocamentoDaCena, ocluir);
+        } else {
+            escolherDesenhos();
+            enviarInstancias();
+            descartarMeshlets(bufferDeComandos);
+        }
+
+        // Com o descarte por oclusão, o primeiro passe desenha
+        // os objetos que a pirâmide anterior não escondeu, e o
+        // segundo os adiados que a pirâmide nova não esconde.
+        gravarPasse(bufferDeComandos, framebuffer,
+                    ocluir ? passeDaPrimeiraFase_
+                           : passeDeRenderizacao_,
+                    0, deslocamentoDaOBU, deslocamentoDaCena);
+        if (ocluir) {
+            construirPiramide(bufferDeComandos);
+            escolherAdiadosNaGpu(bufferDeComandos,
+                                 deslocamentoDaCena);
+            gravarPasse(bufferDeComandos, framebuffer,
+                        passeDaSegundaFase_, 2,
+                        deslocamentoDaOBU, deslocamentoDaCena);
+        }
+
+        bufferDeComandos.end();
+    }
+
+    // `primeiraLista` é a lista dos comandos de índices de 16
+    // bits da cena na GPU, seguida pela de 32 bits.
+    void gravarPasse(vk::CommandBuffer bufferDeComandos,
+                     vk::Framebuffer framebuffer,
+                     vk::RenderPass passe,
+                     uint32_t primeiraLista,
+                     uint32_t deslocamentoDaOBU,
+                     uint32_t deslocamentoDaCena) {
+        const auto& cena = cenas_[quadroAtual_];
+        std::array<vk::ClearValue, 2> valoresDeLimpeza = {
+            vk::ClearColorValue{
+                std::array<float, 4>{0.0f, 0.0f, 0.0f, 1.0f}},
+            vk::ClearDepthStencilValue{1.0f, 0}};
+
+        vk::RenderPassBeginInfo infoPasse;
+        infoPasse.renderPass = passe;
+        infoPasse.framebuffer = framebuffer;
+        infoPasse.renderArea =
+            vk::Rect2D{{0, 0}, dimensoesDaSwapchain_};
+        infoPasse.clearValueCount =
+            static_cast<uint32_t>(valoresDeLimpeza.size());
+        infoPasse.pClearValues = valoresDeLimpeza.data();
+        bufferDeComandos.beginRenderPass(
+            infoPasse, vk::SubpassContents::eInline);
+
+        vk::Viewport viewport = {
+            0.0f,
+            0.0f,
+            static_cast<float>(dimensoesDaSwapchain_.width),
+            static_cast<float>(dimensoesDaSwapchain_.height),
+            0.0f,
+            1.0f};
+        bufferDeComandos.setViewport(0, viewport);
+
+        vk::Rect2D recorte = {{0, 0}, dimensoesDaSwapchain_};
+        bufferDeComandos.setScissor(0, recorte);
+
+        poolDeGeometria_.associarVertices(bufferDeComandos);
+
+        // Enquanto a textura carrega, ou depois de despejada,
+        // o modelo é desenhado com a substituta.
+        vk::DescriptorSet set = setDaTexturaSubstituta_;
+        if (orcamento_.residente(idDaTextura_)) {
+            orcamento_.usar(idDaTextura_);
+            set = setDeDescritores_;
+        }
+        bufferDeComandos.bindDescriptorSets(
+            vk::PipelineBindPoint::eGraphics, layoutDaPipeline_,
+            0, set, deslocamentoDaOBU);
+        bufferDeComandos.bindDescriptorSets(
+            vk::PipelineBindPoint::eGraphics, layoutDaPipeline_,
+            1, cena.set, deslocamentoDaCena);
+
+        auto desenhar = [&](vk::Pipeline pipeline,
+                            vk::Pipeline pipelineDaCena) {
+            if (desenharCenaNaGpu_) {
+                bufferDeComandos.bindPipeline(
+                    vk::PipelineBindPoint::eGraphics,
+                    pipelineDaCena);
+                desenharCena(bufferDeComandos, primeiraLista);
+            } else {
+                bufferDeComandos.bindPipeline(
+                    vk::PipelineBindPoint::eGraphics, pipeline);
+                desenharMalhas(bufferDeComandos);
+            }
+        };
+        if (passePrevioDeProfundidade_) {
+            desenhar(shaders_.pipelineDeProfundidade,
+                     shaders_.pipelineDeProfundidadeDaCena);
+        }
+        desenhar(shaders_.pipeline, shaders_.pipelineDaCena);
+
+        bufferDeComandos.endRenderPass();
+    }
+
+    // Escolhe o nível de detalhe de cada malha em cada objeto
+    // da cena pela distância do objeto. A escolha só depende do
+    // quadro, então os dois passes desenham os mesmos
+    // triângulos. Só os objetos que sobram do descarte pelo
+    // frustum entram. Com `instanciarObjetos_`, os objetos com
+    // a mesma malha no mesmo nível viram um desenho só. Os
+    // desenhos só passam pelo descarte de meshlets enquanto
+    // couberem no buffer compactado do quadro.
+    void escolherDesenhos() {
+        desenhos_.clear();
+        instancias_.clear();
+        size_t numVisiveis = descartarObjetos();
+        objetosVisiveis_ +=
+            numVisiveis * malhasDoModelo_.size();
+        glm::vec3 camera(glm::inverse(obu_.visao)[3]);
+        uint32_t numComandos = 0;
+        uint32_t indicesReservados = 0;
+        const auto& modeloDaCena = pushConstants_.modelo;
+        float menorEscala = std::min(
+            {glm::length(glm::vec3(modeloDaCena[0])),
+             glm::length(glm::vec3(modeloDaCena[1])),
+             glm::length(glm::vec3(modeloDaCena[2]))});
+        auto adicionarDesenho =
+            [&](PoolDeGeometria::IdDeMalha id, size_t nivel,
+                const Instancia* instancias,
+                size_t numObjetos) {
+                // As instâncias dos objetos só diferem na
+                // translação, então uma instância no centro da
+                // caixa das posições, com os meshlets alargados
+                // até a mais afastada, cobre todas.
+                glm::vec3 minimo(instancias[0].modelo[3]);
+                glm::vec3 maximo = minimo;
+                for (size_t i = 1; i < numObjetos; i++) {
+                    glm::vec3 posicao(instancias[i].modelo[3]);
+                    minimo = glm::min(minimo, posicao);
+                    maximo = glm::max(maximo, posicao);
+                }
+                glm::vec3 centro = (minimo + maximo) * 0.5f;
+                Desenho desenho{
+                    pushConstants_,
+                    id,
+                    niveisDasMalhas_[id][nivel],
+                    glm::translate(glm::identity<glm::mat4>(),
+                                   centro) *
+                        modeloDaCena,
+                    glm::length(maximo - centro) / menorEscala,
+                    static_cast<uint32_t>(instancias_.size()),
+                    static_cast<uint32_t>(
+                        numObjetos * instanciasPorDesenho_),
+                    {},
+                    0};
+                desenho.constantes.dequantizacao =
+                    dequantizacaoDasMalhas_[id];
+                for (size_t i = 0; i < numObjetos; i++) {
+                    instancias_.insert(instancias_.end(),
+                                       instanciasPorDesenho_,
+                                       instancias[i]);
+                }
+                bool cabe =
+                    usarMeshlets_ &&
+                    suportaPrimeiraInstanciaIndireta_ &&
+                    numComandos < kMaximoDeDesenhosIndiretos &&
+                    indicesReservados +
+                            desenho.nivel.numIndices <=
+                        kCapacidadeDeIndicesCompactados;
+                if (cabe) {
+                    desenho.comando = numComandos++;
+                    desenho.saida = indicesReservados;
+                    indicesReservados +=
+                        desenho.nivel.numIndices;
+                } else {
+                    // Os do descarte são contados pela GPU.
+                    triangulosDesenhados_ +=
+                        size_t{desenho.nivel.numIndices} / 3 *
+                        desenho.numInstancias;
+                }
+                desenhos_.push_back(desenho);
+            };
+
+        // Um grupo de instâncias por nível de cada malha.
+        std::vector<size_t> inicioDosGrupos;
+        size_t numGrupos = 0;
+        for (auto id : malhasDoModelo_) {
+            inicioDosGrupos.push_back(numGrupos);
+            numGrupos += niveisDasMalhas_[id].size();
+        }
+        if (gruposDeInstancias_.size() < numGrupos) {
+            gruposDeInstancias_.resize(numGrupos);
+        }
+
+        for (size_t i = 0; i < numVisiveis; i++) {
+            const auto& objeto =
+                objetos_[objetosVisiveisNaCpu_[i]];
+            auto instancia = instanciaDoObjeto(objeto, 0);
+            float pixelsPorUnidade = pixelsPorUnidadeDoObjeto(
+                instancia.modelo * pushConstants_.modelo,
+                camera);
+            for (size_t j = 0; j < malhasDoModelo_.size();
+                 j++) {
+                auto id = malhasDoModelo_[j];
+                instancia.malha = id;
+                size_t nivel = escolherNivel(
+                    niveisDasMalhas_[id], pixelsPorUnidade);
+                if (instanciarObjetos_) {
+                    gruposDeInstancias_[inicioDosGrupos[j] +
+                                        nivel]
+                        .push_back(instancia);
+                } else {
+                    adicionarDesenho(id, nivel, &instancia, 1);
+                }
+            }
+        }
+
+        for (size_t j = 0; j < malhasDoModelo_.size(); j++) {
+            auto id = malhasDoModelo_[j];
+            for (size_t nivel = 0;
+                 nivel < niveisDasMalhas_[id].size(); nivel++) {
+                auto& grupo = gruposDeInstancias_
+                    [inicioDosGrupos[j] + nivel];
+                if (!grupo.empty()) {
+                    adicionarDesenho(id, nivel, grupo.data(),
+                                     grupo.size());
+                    grupo.clear();
+                }
+            }
+        }
+    }
+
+    // Escreve no começo de `objetosVisiveisNaCpu_` os índices
+    // dos objetos cuja esfera não fica fora do frustum e
+    // retorna quantos são. A transformação da cena muda a cada
+    // quadro, mas é a mesma em todos os objetos, então o
+    // descarte guarda só as posições deles, que mudam com a
+    // versão da cena, e a esfera do modelo transformada entra
+    // no w dos planos.
+    size_t descartarObjetos() {
+        if (versaoDoDescarte_ != versaoDaCena_) {
+            descarteDeObjetos_.limpar();
+            for (const auto& objeto : objetos_) {
+                descarteDeObjetos_.adicionar(
+                    glm::vec4(objeto.posicao, 0.0f));
+            }
+            versaoDoDescarte_ = versaoDaCena_;
+        }
+        if (!descartarObjetos_ || malhasDoModelo_.empty()) {
+            objetosVisiveisNaCpu_.resize(objetos_.size());
+            std::iota(objetosVisiveisNaCpu_.begin(),
+                      objetosVisiveisNaCpu_.end(), 0u);
+            return objetos_.size();
+        }
+
+        glm::vec4 esfera =
+            esferasDasMalhas_[malhasDoModelo_[0]];
+        for (auto id : malhasDoModelo_) {
+            esfera =
+                juntarEsferas(esfera, esferasDasMalhas_[id]);
+        }
+        const auto& modelo = pushConstants_.modelo;
+        float escala = std::max(
+            {glm::length(glm::vec3(modelo[0])),
+             glm::length(glm::vec3(modelo[1])),
+             glm::length(glm::vec3(modelo[2]))});
+        glm::vec3 centro(modelo *
+                         glm::vec4(glm::vec3(esfera), 1.0f));
+        auto planos =
+            planosDoFrustum(obu_.projecao * obu_.visao);
+        for (auto& plano : planos) {
+            plano.w += glm::dot(glm::vec3(plano), centro) +
+                       esfera.w * escala;
+        }
+        return descarteDeObjetos_.descartar(
+            planos, objetosVisiveisNaCpu_);
+    }
+
+    // A transformação do objeto, sem a da cena.
+    static Instancia instanciaDoObjeto(
+        const Objeto& objeto,
+        PoolDeGeometria::IdDeMalha malha) {
+        return Instancia{
+            glm::translate(glm::identity<glm::mat4>(),
+                           objeto.posicao),
+            objeto.tonalidade, malha, objeto.material, {0, 0}};
+    }
+
+    // As instâncias dos desenhos do quadro vão para o buffer
+    // dele, que cresce quando elas não cabem. A cerca do
+    // quadro já foi esperada.
+    void enviarInstancias() {
+        auto& cena = cenas_[quadroAtual_];
+        if (instancias_.size() > cena.capacidadeDeInstancias) {
+            uint32_t capacidade = cena.capacidadeDeInstancias;
+            while (capacidade < instancias_.size()) {
+                capacidade *= 2;
+            }
+            dispositivo_.destroyBuffer(cena.instancias);
+            alocador_.liberar(cena.alocacaoDasInstancias);
+            criarBufferDeInstancias(cena, capacidade);
+        }
+        if (!instancias_.empty()) {
+            std::memcpy(cena.alocacaoDasInstancias.mapeamento,
+                        instancias_.data(),
+                        instancias_.size() * sizeof(Instancia));
+        }
+    }
+
+    // Um dispatch por desenho indireto, com um grupo por
+    // meshlet do nível, antes do passe de renderização. Os
+    // comandos começam sem índices, e o shader soma os dos
+    // meshlets que ficam.
+    void descartarMeshlets(vk::CommandBuffer bufferDeComandos) {
+        auto& descarte = descartes_[quadroAtual_];
+        // O pool troca de buffer de índices ao ser compactado.
+        // O set do quadro não está em uso, já que a cerca dele
+        // foi esperada.
+        if (descarte.versaoDoPool !=
+            poolDeGeometria_.versaoDosBuffers()) {
+            vk::DescriptorBufferInfo infoDosIndices = {
+                poolDeGeometria_.bufferDeIndices(), 0,
+                VK_WHOLE_SIZE};
+            dispositivo_.updateDescriptorSets(
+                vk::WriteDescriptorSet{
+                    descarte.set, 1, 0, 1,
+                    vk::DescriptorType::eStorageBuffer, {},
+                    &infoDosIndices},
+                {});
+            descarte.versaoDoPool =
+                poolDeGeometria_.versaoDosBuffers();
+        }
+
+        bufferDeComandos.bindPipeline(
+            vk::PipelineBindPoint::eCompute,
+            shaders_.pipelineDeDescarte);
+        bufferDeComandos.bindDescriptorSets(
+            vk::PipelineBindPoint::eCompute, layoutDoDescarte_,
+            0, descarte.set, {});
+
+        auto comandos = comandosDoDescarte(descarte);
+        glm::mat4 visaoProjecao = obu_.projecao * obu_.visao;
+        for (const auto& desenho : desenhos_) {
+            if (!desenho.comando.has_value()) {
+                continue;
+            }
+            const auto& malha =
+                poolDeGeometria_.malha(desenho.id);
+            comandos[*desenho.comando] =
+                vk::DrawIndexedIndirectCommand{
+                    0, desenho.numInstancias, desenho.saida,
+                    malha.deslocamentoDeVertice,
+                    desenho.primeiraInstancia};
+
+            const auto& modelo = desenho.modelo;
+            ConstantesDoDescarte constantes;
+            constantes.planos =
+                planosDoFrustum(visaoProjecao * modelo);
+            constantes.camera = glm::vec4(
+                glm::vec3(glm::inverse(obu_.visao * modelo)[3]),
+                desenho.folga);
+            constantes.primeiroMeshlet =
+                primeiroMeshletDasMalhas_[desenho.id] +
+                desenho.nivel.primeiroMeshlet;
+            constantes.primeiroIndiceDaMalha =
+                malha.primeiroIndice;
+            constantes.saida = desenho.saida;
+            constantes.comando = *desenho.comando;
+            if (malha.tipoDeIndice == vk::IndexType::eUint16) {
+                constantes.comando |= 1u << 31;
+            }
+            bufferDeComandos
+                .pushConstants<ConstantesDoDescarte>(
+                    layoutDoDescarte_,
+                    vk::ShaderStageFlagBits::eCompute, 0,
+                    constantes);
+            bufferDeComandos.dispatch(
+                desenho.nivel.numMeshlets, 1, 1);
+        }
+
+        // Os contadores são lidos pela CPU depois da cerca do
+        // quadro.
+        vk::MemoryBarrier barreira = {
+            vk::AccessFlagBits::eShaderWrite,
+            vk::AccessFlagBits::eIndirectCommandRead |
+                vk::AccessFlagBits::eIndexRead |
+                vk::AccessFlagBits::eHostRead};
+        bufferDeComandos.pipelineBarrier(
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eDrawIndirect |
+                vk::PipelineStageFlagBits::eVertexInput |
+                vk::PipelineStageFlagBits::eHost,
+            {}, barreira, {}, {});
+    }
+
+    // Os planos de Gribb e Hartmann da matriz que leva ao
+    // espaço de recorte, com a profundidade de 0 a 1 e as
+    // normais para dentro.
+    static std::array<glm::vec4, 6> planosDoFrustum(
+        const glm::mat4& matriz) {
+        auto linha = [&matriz](int i) {
+            return glm::vec4(matriz[0][i], matriz[1][i],
+                             matriz[2][i], matriz[3][i]);
+        };
+        std::array<glm::vec4, 6> planos = {
+            linha(3) + linha(0), linha(3) - linha(0),
+            linha(3) + linha(1), linha(3) - linha(1),
+            linha(2),            linha(3) - linha(2)};
+        for (auto& plano : planos) {
+            plano /= glm::length(glm::vec3(plano));
+        }
+        return planos;
+    }
+
+    void desenharMalhas(vk::CommandBuffer bufferDeComandos) {
+        const auto& descarte = descartes_[quadroAtual_];
+        vk::Buffer bufferAssociado;
+        vk::IndexType tipoAssociado = vk::IndexType::eUint16;
+        // As constantes só mudam com a malha.
+        std::optional<PoolDeGeometria::IdDeMalha> idAssociado;
+        for (const auto& desenho : desenhos_) {
+            const auto& malha =
+                poolDeGeometria_.malha(desenho.id);
+            if (idAssociado != desenho.id) {
+                bufferDeComandos.pushConstants<PushConstants>(
+                    layoutDaPipeline_,
+                    vk::ShaderStageFlagBits::eVertex, 0,
+                    desenho.constantes);
+                idAssociado = desenho.id;
+            }
+
+            // Os índices compactados são de 32 bits.
+            if (desenho.comando.has_value()) {
+                if (bufferAssociado != descarte.indices) {
+                    bufferDeComandos.bindIndexBuffer(
+                        descarte.indices, 0,
+                        vk::IndexType::eUint32);
+                    bufferAssociado = descarte.indices;
+                }
+                bufferDeComandos.drawIndexedIndirect(
+                    descarte.comandos,
+                    kDeslocamentoDosComandos +
+                        *desenho.comando * kTamanhoDoComando,
+                    1, kTamanhoDoComando);
+                continue;
+            }
+
+            if (bufferAssociado !=
+                    poolDeGeometria_.bufferDeIndices() ||
+                tipoAssociado != malha.tipoDeIndice) {
+                poolDeGeometria_.associarIndices(
+                    bufferDeComandos, malha.tipoDeIndice);
+                bufferAssociado =
+                    poolDeGeometria_.bufferDeIndices();
+                tipoAssociado = malha.tipoDeIndice;
+            }
+            bufferDeComandos.drawIndexed(
+                desenho.nivel.numIndices, desenho.numInstancias,
+                malha.primeiroIndice +
+                    desenho.nivel.primeiroIndice,
+                malha.deslocamentoDeVertice,
+                desenho.primeiraInstancia);
+        }
+    }
+
+    // Um thread por objeto da cena escreve o comando dele, se
+    // o objeto ficar, antes do passe de renderização. Os
+    // contadores são lidos pela CPU depois da cerca do quadro.
+    // Com `ocluir`, esta é a primeira fase do descarte por
+    // oclusão, e os contadores só são copiados depois da
+    // segunda.
+    void escolherDesenhosNaGpu(
+        vk::CommandBuffer bufferDeComandos,
+        uint32_t deslocamentoDaCena,
+        bool ocluir) {
+        const auto& cena = cenas_[quadroAtual_];
+        // Sem a contagem indireta, os desenhos percorrem as
+        // listas inteiras, e os comandos que sobram precisam
+        // estar zerados.
+        bufferDeComandos.fillBuffer(
+            cena.comandos, 0,
+            contarDesenhos(cena) ? sizeof(ContadoresDaCena)
+                                 : VK_WHOLE_SIZE,
+            0);
+        // A segunda fase começa com um grupo em y e z, e a
+        // primeira aumenta o x com os adiados.
+        if (ocluir) {
+            CabecalhoDosAdiados cabecalho = {{0, 1, 1}, 0};
+            bufferDeComandos.updateBuffer(cena.adiados, 0,
+                                          sizeof(cabecalho),
+                                          &cabecalho);
+        }
+        vk::MemoryBarrier limpeza = {
+            vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eShaderRead |
+                vk::AccessFlagBits::eShaderWrite};
+        bufferDeComandos.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eComputeShader, {},
+            limpeza, {}, {});
+
+        bufferDeComandos.bindPipeline(
+            vk::PipelineBindPoint::eCompute,
+            ocluir ? shaders_.pipelineDaPrimeiraFase
+                   : shaders_.pipelineDeEscolhaDaCena);
+        bufferDeComandos.bindDescriptorSets(
+            vk::PipelineBindPoint::eCompute, layoutDaPipeline_,
+            1, cena.set, deslocamentoDaCena);
+        bufferDeComandos.dispatch(
+            (cena.numObjetos + kObjetosPorGrupoDaCena - 1) /
+                kObjetosPorGrupoDaCena,
+            1, 1);
+
+        if (!ocluir) {
+            copiarContadoresDaCena(bufferDeComandos);
+            return;
+        }
+        // Os desenhos do primeiro passe e o dispatch da
+        // segunda fase leem o que a primeira escreveu, e a
+        // segunda continua as contagens.
+        vk::MemoryBarrier primeiraFase = {
+            vk::AccessFlagBits::eShaderWrite,
+            vk::AccessFlagBits::eIndirectCommandRead |
+                vk::AccessFlagBits::eShaderRead |
+                vk::AccessFlagBits::eShaderWrite};
+        bufferDeComandos.pipelineBarrier(
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eDrawIndirect |
+                vk::PipelineStageFlagBits::eComputeShader,
+            {}, primeiraFase, {}, {});
+    }
+
+    // Uma invocação por objeto adiado pela primeira fase,
+    // depois de a pirâmide ser construída.
+    void escolherAdiadosNaGpu(
+        vk::CommandBuffer bufferDeComandos,
+        uint32_t deslocamentoDaCena) {
+        const auto& cena = cenas_[quadroAtual_];
+        bufferDeComandos.bindPipeline(
+            vk::PipelineBindPoint::eCompute,
+            shaders_.pipelineDaSegundaFase);
+        bufferDeComandos.bindDescriptorSets(
+            vk::PipelineBindPoint::eCompute, layoutDaPipeline_,
+            1, cena.set, deslocamentoDaCena);
+        bufferDeComandos.dispatchIndirect(cena.adiados, 0);
+        copiarContadoresDaCena(bufferDeComandos);
+    }
+
+    // Cada nível é construído a partir do anterior, então os
+    // dispatches esperam um pelo outro. A última barreira
+    // deixa a pirâmide pronta para a segunda fase.
+    void construirPiramide(vk::CommandBuffer bufferDeComandos) {
+        bufferDeComandos.bindPipeline(
+            vk::PipelineBindPoint::eCompute,
+            shaders_.pipelineDaPiramide);
+        auto dimensoes = piramide_.dimensoes;
+        for (auto set : piramide_.sets) {
+            bufferDeComandos.bindDescriptorSets(
+                vk::PipelineBindPoint::eCompute,
+                layoutDaPiramide_, 0, set, {});
+            bufferDeComandos.dispatch(
+                (dimensoes.width + kTexelsPorGrupoDaPiramide -
+                 1) / kTexelsPorGrupoDaPiramide,
+                (dimensoes.height + kTexelsPorGrupoDaPiramide -
+                 1) / kTexelsPorGrupoDaPiramide,
+                1);
+            vk::MemoryBarrier nivel = {
+                vk::AccessFlagBits::eShaderWrite,
+                vk::AccessFlagBits::eShaderRead};
+            bufferDeComandos.pipelineBarrier(
+                vk::PipelineStageFlagBits::eComputeShader,
+                vk::PipelineStageFlagBits::eComputeShader, {},
+                nivel, {}, {});
+            dimensoes.width = std::max(dimensoes.width / 2, 1u);
+            dimensoes.height =
+                std::max(dimensoes.height / 2, 1u);
+        }
+        // A primeira fase do próximo quadro testa os objetos
+        // como eles estavam neste.
+        modeloDaCenaDaPiramide_ = pushConstants_.modelo;
+        visaoProjecaoDaPiramide_ = obu_.projecao * obu_.visao;
+        piramideValida_ = true;
+    }
+
+    void copiarContadoresDaCena(
+        vk::CommandBuffer bufferDeComandos) {
+        const auto& cena = cenas_[quadroAtual_];
+        vk::MemoryBarrier escolha = {
+            vk::AccessFlagBits::eShaderWrite,
+            vk::AccessFlagBits::eIndirectCommandRead |
+                vk::AccessFlagBits::eTransferRead};
+        bufferDeComandos.pipelineBarrier(
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eDrawIndirect |
+                vk::PipelineStageFlagBits::eTransfer,
+            {}, escolha, {}, {});
+        bufferDeComandos.copyBuffer(
+            cena.comandos, cena.leitura,
+            vk::BufferCopy{0, 0, sizeof(ContadoresDaCena)});
+        vk::MemoryBarrier leitura = {
+            vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eHostRead};
+        bufferDeComandos.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eHost, {}, leitura, {},
+            {});
+    }
+
+    // A contagem fica num buffer que a CPU não lê, então uma
+    // lista maior que o limite de desenhos por comando não
+    // pode ser dividida com ela, e é percorrida inteira.
+    bool contarDesenhos(const CenaDoQuadro& cena) const {
+        return possuiContagemIndireta_ &&
+               cena.numObjetos <= maximoDeDesenhosIndiretos_;
+    }
+
+    // Dois desenhos indiretos por passe, um para cada largura
+    // de índice, enquanto a cena couber no limite de desenhos
+    // por comando. As push constants só levam a transformação
+    // da cena.
+    void desenharCena(vk::CommandBuffer bufferDeComandos,
+                      uint32_t primeiraLista) {
+        const auto& cena = cenas_[quadroAtual_];
+        bufferDeComandos.pushConstants<PushConstants>(
+            layoutDaPipeline_, vk::ShaderStageFlagBits::eVertex,
+            0, pushConstants_);
+        for (auto tipo :
+             {vk::IndexType::eUint16, vk::IndexType::eUint32}) {
+            bool indices32 = tipo == vk::IndexType::eUint32;
+            uint32_t lista =
+                primeiraLista + (indices32 ? 1u : 0u);
+            vk::DeviceSize deslocamento =
+                sizeof(ContadoresDaCena) +
+                vk::DeviceSize{lista} * cena.capacidade *
+                    kTamanhoDoComando;
+            poolDeGeometria_.associarIndices(bufferDeComandos,
+                                             tipo);
+            if (contarDesenhos(cena)) {
+                auto comandos =
+                    static_cast<VkBuffer>(cena.comandos);
+                desenharComContagemIndireta_(
+                    static_cast<VkCommandBuffer>(
+                        bufferDeComandos),
+                    comandos, deslocamento, comandos,
+                    offsetof(ContadoresDaCena, numComandos) +
+                        lista * sizeof(uint32_t),
+                    cena.numObjetos, kTamanhoDoComando);
+                continue;
+            }
+            for (uint32_t primeiro = 0;
+                 primeiro < cena.numObjetos;
+                 primeiro += maximoDeDesenhosIndiretos_) {
+                bufferDeComandos.drawIndexedIndirect(
+                    cena.comandos,
+                    deslocamento +
+                        vk::DeviceSize{primeiro} *
+                            kTamanhoDoComando,
+                    std::min(cena.numObjetos - primeiro,
+                             maximoDeDesenhosIndiretos_),
+                    kTamanhoDoComando);
+            }
+        }
+    }
+
+    // Quantos pixels da tela uma unidade da malha cobre, na
+    // distância da origem do objeto até a câmera.
+    float pixelsPorUnidadeDoObjeto(
+        const glm::mat4& modelo,
+        const glm::vec3& camera) const {
+        float escala = std::max(
+            {glm::length(glm::vec3(modelo[0])),
+             glm::length(glm::vec3(modelo[1])),
+             glm::length(glm::vec3(modelo[2]))});
+        float distancia = std::max(
+            glm::distance(glm::vec3(modelo[3]), camera),
+            kPlanoProximo);
+        float alturaDaTela =
+            static_cast<float>(dimensoesDaSwapchain_.height);
+        return escala * alturaDaTela / 2.0f *
+               std::abs(obu_.projecao[1][1]) / distancia;
+    }
+
+    // O índice do nível menos detalhado cujo erro, projetado
+    // na tela, fica abaixo de kErroDosNiveisEmPixels.
+    size_t escolherNivel(
+        const std::vector<NivelDaMalha>& niveis,
+        float pixelsPorUnidade) const {
+        size_t escolhido = 0;
+        while (usarNiveisDeDetalhe_ &&
+               escolhido + 1 < niveis.size() &&
+               niveis[escolhido + 1].erro * pixelsPorUnidade <=
+                   kErroDosNiveisEmPixels) {
+            escolhido++;
+        }
+        return escolhido;
+    }
+
+    void criarPrimitivosDeSincronizacao() {
+        std::generate(semaforosDeImagemDisponivel_.begin(),
+                      semaforosDeImagemDisponivel_.end(),
+                      [this]() { return criarSemaforo(); });
+        std::generate(semaforosDeRenderizacaoCompleta_.begin(),
+                      semaforosDeRenderizacaoCompleta_.end(),
+                      [this]() { return criarSemaforo(); });
+        std::generate(
+            cercasDeQuadros_.begin(), cercasDeQuadros_.end(),
+            [this]() {
+                return criarCerca(
+                    vk::FenceCreateFlagBits::eSignaled);
+            });
+    }
+
+    vk::Semaphore criarSemaforo() {
+        vk::SemaphoreCreateInfo infoSemaforo;
+        return dispositivo_.createSemaphore(infoSemaforo);
+    }
+
+    vk::Fence criarCerca(vk::FenceCreateFlags flags) {
+        vk::FenceCreateInfo info;
+        info.flags = flags;
+        return dispositivo_.createFence(info);
+    }
+
+    void criarPoolDeDescritores() {
+        // Um set para a textura e um para a substituta, e um
+        // de descarte e um da cena por quadro em execução.
+        auto numQuadros =
+            static_cast<uint32_t>(kMaximoQuadrosEmExecucao);
+        std::array<vk::DescriptorPoolSize, 3> tamanhos = {
+            vk::DescriptorPoolSize{
+                vk::DescriptorType::eUniformBufferDynamic,
+                2 + numQuadros},
+            vk::DescriptorPoolSize{
+                vk::DescriptorType::eCombinedImageSampler,
+                2 + numQuadros},
+            vk::DescriptorPoolSize{
+                vk::DescriptorType::eStorageBuffer,
+                (4 + 5) * numQuadros}};
+
+        vk::DescriptorPoolCreateInfo info;
+        info.maxSets = 2 + 2 * numQuadros;
+        info.poolSizeCount =
+            static_cast<uint32_t>(tamanhos.size());
+        info.pPoolSizes = tamanhos.data();
+
+        poolDeDescritores_ =
+            dispositivo_.createDescriptorPool(info);
+    }
+
+    // Só os substitutos são enviados aqui. O modelo e a textura
+    // são pedidos ao carregador e tomam o lugar deles quando
+    // ficam prontos, com o loop principal já rodando.
+    void carregarRecursos() {
+        criarBufferDeMeshlets();
+        criarPoolDeGeometria();
+
+        idDaTextura_ = orcamento_.registrarRecurso(
+            [this]() { despejarTextura(); });
+        criarTexturaSubstituta();
+        amostrador_ = criarAmostrador(VK_LOD_CLAMP_NONE);
+
+        criarArenaDeUniformes();
+        contextoDeEnvio_.submeter();
+
+        criarSetsDeDescritores();
+        criarBuffersDeDescarte();
+        criarCenas();
+
+        criarBuffersDeComandos();
+
+        pedirModelo();
+        pedirTextura();
+
+        if (kAtivarCamadasDeValidacao) {
+            alocador_.imprimirEstatisticas();
+            orcamento_.imprimirEstatisticas();
+            imprimirEstatisticasDoPoolDeGeometria();
+            poolDeAlvos_.imprimirEstatisticas();
+        }
+    }
+
+    // Para as bancadas, que medem com os recursos carregados.
+    void esperarRecursos() {
+        carregador_.esperarTodos();
+        contextoDeEnvio_.submeter();
+    }
+
+    // As conclusões só gravam envios, que vão para a GPU antes
+    // do quadro que já usa os recursos.
+    void concluirCarregamentos() {
+        if (carregador_.concluirProntos() > 0) {
+            contextoDeEnvio_.submeter();
+        }
+    }
+
+    // O pool começa só com a malha substituta.
+    void criarPoolDeGeometria() {
+        criarBuffersDoPoolDeGeometria(bufferDeVertices_,
+                                      alocacaoBufferDeVertices_,
+                                      bufferDeIndices_,
+                                      alocacaoBufferDeIndices_);
+        poolDeGeometria_.iniciar(
+            contextoDeEnvio_,
+            tamanhosDosFluxos(formatoDeVertice_),
+            bufferDeVertices_, kCapacidadeDeVerticesDoPool,
+            bufferDeIndices_, kTamanhoDoBufferDeIndicesDoPool);
+        meshletsDoPool_.emplace(kCapacidadeDeMeshlets *
+                                sizeof(Meshlet));
+        primeiroMeshletDasMalhas_.clear();
+
+        malhaSubstituta_ = adicionarMalha(
+            prepararMalhaSubstituta(formatoDeVertice_));
+        malhasDoModelo_ = {malhaSubstituta_};
+        versaoDaCena_++;
+    }
+
+    void criarBuffersDoPoolDeGeometria(
+        vk::Buffer& bufferDeVertices,
+        Alocacao& alocacaoDeVertices,
+        vk::Buffer& bufferDeIndices,
+        Alocacao& alocacaoDeIndices) {
+        criarBuffer(vk::BufferUsageFlagBits::eVertexBuffer |
+                        vk::BufferUsageFlagBits::eTransferSrc |
+                        vk::BufferUsageFlagBits::eTransferDst,
+                    kCapacidadeDeVerticesDoPool *
+                        tamanhoDoVertice(formatoDeVertice_),
+                    vk::MemoryPropertyFlagBits::eDeviceLocal,
+                    bufferDeVertices, alocacaoDeVertices);
+        // O descarte de meshlets lê os índices como storage.
+        criarBuffer(
+            vk::BufferUsageFlagBits::eIndexBuffer |
+                vk::BufferUsageFlagBits::eStorageBuffer |
+                vk::BufferUsageFlagBits::eTransferSrc |
+                vk::BufferUsageFlagBits::eTransferDst,
+            kTamanhoDoBufferDeIndicesDoPool,
+            vk::MemoryPropertyFlagBits::eDeviceLocal,
+            bufferDeIndices, alocacaoDeIndices);
+    }
+
+    // Os meshlets de todas as malhas do pool, sub-alocados
+    // como as malhas.
+    void criarBufferDeMeshlets() {
+        criarBuffer(vk::BufferUsageFlagBits::eStorageBuffer |
+                        vk::BufferUsageFlagBits::eTransferDst,
+                    kCapacidadeDeMeshlets * sizeof(Meshlet),
+                    vk::MemoryPropertyFlagBits::eDeviceLocal,
+                    bufferDeMeshlets_,
+                    alocacaoBufferDeMeshlets_);
+    }
+
+    // Cada quadro em execução tem o próprio buffer compactado
+    // e os próprios comandos indiretos, que ficam visíveis à
+    // CPU: ela escreve os comandos antes do descarte e lê os
+    // contadores depois que o quadro termina.
+    void criarBuffersDeDescarte() {
+        std::vector<vk::DescriptorSetLayout> layouts(
+            descartes_.size(), layoutDoSetDeDescarte_);
+        vk::DescriptorSetAllocateInfo infoAloc;
+        infoAloc.descriptorPool = poolDeDescritores_;
+        infoAloc.descriptorSetCount =
+            static_cast<uint32_t>(layouts.size());
+        infoAloc.pSetLayouts = layouts.data();
+        auto sets =
+            dispositivo_.allocateDescriptorSets(infoAloc);
+
+        for (size_t i = 0; i < descartes_.size(); i++) {
+            auto& descarte = descartes_[i];
+            criarBuffer(
+                vk::BufferUsageFlagBits::eIndexBuffer |
+                    vk::BufferUsageFlagBits::eStorageBuffer,
+                kCapacidadeDeIndicesCompactados *
+                    sizeof(uint32_t),
+                vk::MemoryPropertyFlagBits::eDeviceLocal,
+                descarte.indices, descarte.alocacaoDosIndices);
+            criarBuffer(
+                vk::BufferUsageFlagBits::eIndirectBuffer |
+                    vk::BufferUsageFlagBits::eStorageBuffer,
+                kDeslocamentoDosComandos +
+                    kMaximoDeDesenhosIndiretos *
+                        kTamanhoDoComando,
+                vk::MemoryPropertyFlagBits::eHostVisible |
+                    vk::MemoryPropertyFlagBits::eHostCoherent,
+                descarte.comandos,
+                descarte.alocacaoDosComandos);
+            contadoresDoDescarte(descarte) = {};
+            descarte.set = sets[i];
+            descarte.versaoDoPool = 0;
+
+            // Os índices do pool, na associação 1, são
+            // escritos no primeiro descarte do quadro.
+            std::array<uint32_t, 3> associacoes = {0, 2, 3};
+            std::array<vk::DescriptorBufferInfo, 3> infos = {
+                vk::DescriptorBufferInfo{bufferDeMeshlets_, 0,
+                                         VK_WHOLE_SIZE},
+                vk::DescriptorBufferInfo{descarte.indices, 0,
+                                         VK_WHOLE_SIZE},
+                vk::DescriptorBufferInfo{descarte.comandos, 0,
+                                         VK_WHOLE_SIZE}};
+            std::array<vk::WriteDescriptorSet, 3> escritas;
+            for (size_t j = 0; j < escritas.size(); j++) {
+                escritas[j] = vk::WriteDescriptorSet{
+                    descarte.set, associacoes[j], 0, 1,
+                    vk::DescriptorType::eStorageBuffer, {},
+                    &infos[j]};
+            }
+            dispositivo_.updateDescriptorSets(escritas, {});
+        }
+    }
+
+    ContadoresDeMeshlets& contadoresDoDescarte(
+        const DescarteDoQuadro& descarte) {
+        return *static_cast<ContadoresDeMeshlets*>(
+            descarte.alocacaoDosComandos.mapeamento);
+    }
+
+    vk::DrawIndexedIndirectCommand* comandosDoDescarte(
+        const DescarteDoQuadro& descarte) {
+        auto bytes = static_cast<char*>(
+            descarte.alocacaoDosComandos.mapeamento);
+        return reinterpret_cast<
+            vk::DrawIndexedIndirectCommand*>(
+            bytes + kDeslocamentoDosComandos);
+    }
+
+    // A cerca do quadro já foi esperada, então os contadores
+    // do descarte dele estão prontos.
+    void lerContadoresDeMeshlets() {
+        auto& contadores =
+            contadoresDoDescarte(descartes_[quadroAtual_]);
+        meshletsVisiveis_ += contadores.meshletsVisiveis;
+        triangulosDesenhados_ +=
+            size_t{contadores.triangulosVisiveis} *
+            instanciasPorDesenho_;
+        contadores = {};
+    }
+
+    // Cada quadro em execução tem a própria cópia da cena, que
+    // cresce quando os objetos não cabem mais nela.
+    void criarCenas() {
+        std::vector<vk::DescriptorSetLayout> layouts(
+            cenas_.size(), layoutDoSetDaCena_);
+        vk::DescriptorSetAllocateInfo infoAloc;
+        infoAloc.descriptorPool = poolDeDescritores_;
+        infoAloc.descriptorSetCount =
+            static_cast<uint32_t>(layouts.size());
+        infoAloc.pSetLayouts = layouts.data();
+        auto sets =
+            dispositivo_.allocateDescriptorSets(infoAloc);
+
+        for (size_t i = 0; i < cenas_.size(); i++) {
+            cenas_[i].set = sets[i];
+            criarBuffersDaCena(cenas_[i],
+                               kCapacidadeInicialDaCena);
+            criarBufferDeInstancias(cenas_[i],
+                                    kCapacidadeInicialDaCena);
+        }
+    }
+
+    void criarBufferDeInstancias(CenaDoQuadro& cena,
+                                 uint32_t capacidade) {
+        criarBuffer(vk::BufferUsageFlagBits::eStorageBuffer,
+                    capacidade * sizeof(Instancia),
+                    vk::MemoryPropertyFlagBits::eHostVisible |
+                        vk::MemoryPropertyFlagBits::
+                            eHostCoherent,
+                    cena.instancias,
+                    cena.alocacaoDasInstancias);
+        cena.capacidadeDeInstancias = capacidade;
+
+        vk::DescriptorBufferInfo info = {cena.instancias, 0,
+                                         VK_WHOLE_SIZE};
+        dispositivo_.updateDescriptorSets(
+            vk::WriteDescriptorSet{
+                cena.set, 4, 0, 1,
+                vk::DescriptorType::eStorageBuffer, {}, &info},
+            {});
+    }
+
+    // A versão zerada faz a cena ser escrita no próximo
+    // quadro dela.
+    void criarBuffersDaCena(CenaDoQuadro& cena,
+                            uint32_t capacidade) {
+        auto visivel =
+            vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent;
+        criarBuffer(vk::BufferUsageFlagBits::eStorageBuffer,
+                    capacidade * sizeof(Instancia), visivel,
+                    cena.objetos, cena.alocacaoDosObjetos);
+        criarBuffer(vk::BufferUsageFlagBits::eStorageBuffer,
+                    kCapacidadeDeMalhasDaCena *
+                        sizeof(MalhaDaCena),
+                    visivel, cena.malhas,
+                    cena.alocacaoDasMalhas);
+        criarBuffer(
+            vk::BufferUsageFlagBits::eIndirectBuffer |
+                vk::BufferUsageFlagBits::eStorageBuffer |
+                vk::BufferUsageFlagBits::eTransferSrc |
+                vk::BufferUsageFlagBits::eTransferDst,
+            sizeof(ContadoresDaCena) +
+                kListasDaCena * vk::DeviceSize{capacidade} *
+                    kTamanhoDoComando,
+            vk::MemoryPropertyFlagBits::eDeviceLocal,
+            cena.comandos, cena.alocacaoDosComandos);
+        criarBuffer(vk::BufferUsageFlagBits::eTransferDst,
+                    sizeof(ContadoresDaCena), visivel,
+                    cena.leitura, cena.alocacaoDaLeitura);
+        criarBuffer(
+            vk::BufferUsageFlagBits::eIndirectBuffer |
+                vk::BufferUsageFlagBits::eStorageBuffer |
+                vk::BufferUsageFlagBits::eTransferDst,
+            sizeof(CabecalhoDosAdiados) +
+                vk::DeviceSize{capacidade} * sizeof(uint32_t),
+            vk::MemoryPropertyFlagBits::eDeviceLocal,
+            cena.adiados, cena.alocacaoDosAdiados);
+        contadoresDaCena(cena) = {};
+        cena.capacidade = capacidade;
+        cena.numObjetos = 0;
+        cena.versao = 0;
+
+        std::array<vk::DescriptorBufferInfo, 5> infos = {
+            vk::DescriptorBufferInfo{cena.objetos, 0,
+                                     VK_WHOLE_SIZE},
+            vk::DescriptorBufferInfo{cena.malhas, 0,
+                                     VK_WHOLE_SIZE},
+            vk::DescriptorBufferInfo{cena.comandos, 0,
+                                     VK_WHOLE_SIZE},
+            vk::DescriptorBufferInfo{bufferDaArenaDeUniformes_,
+                                     0,
+                                     sizeof(ParametrosDaCena)},
+            vk::DescriptorBufferInfo{cena.adiados, 0,
+                                     VK_WHOLE_SIZE}};
+        std::array<uint32_t, 5> associacoes = {0, 1, 2, 3, 6};
+        std::array<vk::WriteDescriptorSet, 5> escritas;
+        for (uint32_t j = 0; j < escritas.size(); j++) {
+            auto tipo =
+                j == 3
+                    ? vk::DescriptorType::eUniformBufferDynamic
+                    : vk::DescriptorType::eStorageBuffer;
+            escritas[j] = vk::WriteDescriptorSet{
+                cena.set, associacoes[j], 0, 1, tipo, {},
+                &infos[j]};
+        }
+        dispositivo_.updateDescriptorSets(escritas, {});
+    }
+
+    void destruirBuffersDaCena(CenaDoQuadro& cena) {
+        dispositivo_.destroyBuffer(cena.adiados);
+        alocador_.liberar(cena.alocacaoDosAdiados);
+        dispositivo_.destroyBuffer(cena.leitura);
+        alocador_.liberar(cena.alocacaoDaLeitura);
+        dispositivo_.destroyBuffer(cena.comandos);
+        alocador_.liberar(cena.alocacaoDosComandos);
+        dispositivo_.destroyBuffer(cena.malhas);
+        alocador_.liberar(cena.alocacaoDasMalhas);
+        dispositivo_.destroyBuffer(cena.objetos);
+        alocador_.liberar(cena.alocacaoDosObjetos);
+    }
+
+    ContadoresDaCena& contadoresDaCena(
+        const CenaDoQuadro& cena) {
+        return *static_cast<ContadoresDaCena*>(
+            cena.alocacaoDaLeitura.mapeamento);
+    }
+
+    // Como lerContadoresDeMeshlets. Só há contadores quando o
+    // quadro desenhou a cena pela GPU.
+    void lerContadoresDaCena() {
+        auto& contadores =
+            contadoresDaCena(cenas_[quadroAtual_]);
+        objetosVisiveis_ += contadores.objetosVisiveis;
+        objetosOclusos_ += contadores.objetosOclusos;
+        triangulosDesenhados_ += contadores.triangulosVisiveis;
+        contadores = {};
+    }
+
+    // Um objeto da cena na GPU por malha do modelo em cada
+    // objeto. A cerca do quadro já foi esperada, então a GPU
+    // não lê mais a cópia dele, que pode ser reescrita ou
+    // trocada.
+    void atualizarCenaDoQuadro() {
+        auto& cena = cenas_[quadroAtual_];
+        if (suportaCenaNaGpu_ &&
+            cena.versaoDaPiramide != versaoDaPiramide_) {
+            vk::DescriptorImageInfo info{
+                amostradorDaPiramide_, piramide_.visao,
+                vk::ImageLayout::eGeneral};
+            vk::WriteDescriptorSet escrita{
+                cena.set, 5, 0, 1,
+                vk::DescriptorType::eCombinedImageSampler,
+                &info};
+            dispositivo_.updateDescriptorSets(escrita, {});
+            cena.versaoDaPiramide = versaoDaPiramide_;
+        }
+        if (cena.versao == versaoDaCena_) {
+            return;
+        }
+
+        size_t numObjetos =
+            objetos_.size() * malhasDoModelo_.size();
+        if (numObjetos > cena.capacidade) {
+            uint32_t capacidade = cena.capacidade;
+            while (capacidade < numObjetos) {
+                capacidade *= 2;
+            }
+            destruirBuffersDaCena(cena);
+            criarBuffersDaCena(cena, capacidade);
+        }
+
+        auto instancias = static_cast<Instancia*>(
+            cena.alocacaoDosObjetos.mapeamento);
+        for (const auto& objeto : objetos_) {
+            for (auto id : malhasDoModelo_) {
+                *instancias++ = instanciaDoObjeto(objeto, id);
+            }
+        }
+        auto malhas = static_cast<MalhaDaCena*>(
+            cena.alocacaoDasMalhas.mapeamento);
+        for (auto id : malhasDoModelo_) {
+            if (id >= kCapacidadeDeMalhasDaCena) {
+                throw std::runtime_error(
+                    "A malha não cabe na tabela da cena.");
+            }
+            malhas[id] = malhaDaCena(id);
+        }
+        cena.numObjetos = static_cast<uint32_t>(numObjetos);
+        cena.versao = versaoDaCena_;
+    }
+
+    MalhaDaCena malhaDaCena(
+        PoolDeGeometria::IdDeMalha id) const {
+        const auto& malha = poolDeGeometria_.malha(id);
+        const auto& niveis = niveisDasMalhas_[id];
+        MalhaDaCena linha{};
+        linha.dequantizacao = dequantizacaoDasMalhas_[id];
+        linha.esfera = esferasDasMalhas_[id];
+        linha.primeiroIndice = malha.primeiroIndice;
+        linha.deslocamentoDeVertice =
+            malha.deslocamentoDeVertice;
+        linha.indices16 =
+            malha.tipoDeIndice == vk::IndexType::eUint16 ? 1u
+                                                         : 0u;
+        linha.numNiveis = static_cast<uint32_t>(
+            std::min(niveis.size(), linha.niveis.size()));
+        std::copy_n(niveis.begin(), linha.numNiveis,
+                    linha.niveis.begin());
+        return linha;
+    }
+
+    // A câmera e os planos do frustum ficam no espaço do mundo,
+    // e a escolha do nível segue pixelsPorUnidadeDoObjeto.
+    ParametrosDaCena parametrosDaCena(
+        const CenaDoQuadro& cena) const {
+        ParametrosDaCena parametros;
+        parametros.modeloDaCena = pushConstants_.modelo;
+        parametros.visaoProjecao = obu_.projecao * obu_.visao;
+        parametros.modeloDaCenaDaPiramide =
+            modeloDaCenaDaPiramide_;
+        parametros.visaoProjecaoDaPiramide =
+            visaoProjecaoDaPiramide_;
+        parametros.planos =
+            planosDoFrustum(parametros.visaoProjecao);
+        float alturaDaTela =
+            static_cast<float>(dimensoesDaSwapchain_.height);
+        parametros.camera = glm::vec4(
+            glm::vec3(glm::inverse(obu_.visao)[3]),
+            alturaDaTela / 2.0f *
+                std::abs(obu_.projecao[1][1]));
+        parametros.numObjetos = cena.numObjetos;
+        parametros.capacidadeDaLista = cena.capacidade;
+        parametros.erroEmPixels = kErroDosNiveisEmPixels;
+        parametros.planoProximo = kPlanoProximo;
+        parametros.usarNiveis = usarNiveisDeDetalhe_ ? 1u : 0u;
+        parametros.piramideValida = piramideValida_ ? 1u : 0u;
+        return parametros;
+    }
+
+    // Não toca em nada da GPU e pode rodar numa thread de
+    // trabalho.
+    // Sem `niveis`, a malha tem um nível só, com todos os
+    // índices, e, sem `meshlets`, eles são gerados dos níveis.
+    MalhaPreparada prepararMalha(
+        FormatoDeVertice formato,
+        const Vertice* vertices,
+        uint32_t numVertices,
+        const void* indices,
+        uint32_t numIndices,
+        vk::IndexType tipoDeIndice,
+        std::vector<NivelDaMalha> niveis = {},
+        std::vector<Meshlet> meshlets = {}) {
+        MalhaPreparada malha;
+        malha.dequantizacao = separarEmFluxos(
+            formato, vertices, numVertices, malha.fluxos);
+        malha.numVertices = numVertices;
+        auto bytesDeIndices = static_cast<const char*>(indices);
+        malha.indices.assign(
+            bytesDeIndices,
+            bytesDeIndices + size_t{numIndices} *
+                                 tamanhoDoIndice(tipoDeIndice));
+        malha.numIndices = numIndices;
+        malha.tipoDeIndice = tipoDeIndice;
+        malha.niveis = std::move(niveis);
+        if (malha.niveis.empty()) {
+            malha.niveis = {{0, numIndices, 0.0f, 0, 0}};
+        }
+        malha.esfera = esferaEnvolvente(vertices, numVertices);
+        malha.meshlets = std::move(meshlets);
+        if (malha.meshlets.empty()) {
+            malha.meshlets = gerarMeshlets(
+                std::vector<Vertice>(vertices,
+                                     vertices + numVertices),
+                alargarIndices(indices, numIndices,
+                               tipoDeIndice),
+                malha.niveis);
+        }
+        return malha;
+    }
+
+    PoolDeGeometria::IdDeMalha adicionarMalha(
+        const MalhaPreparada& malha) {
+        std::vector<const void*> dadosDosFluxos;
+        for (const auto& fluxo : malha.fluxos) {
+            dadosDosFluxos.push_back(fluxo.data());
+        }
+
+        auto id = poolDeGeometria_.adicionar(
+            dadosDosFluxos, malha.numVertices,
+            malha.indices.data(), malha.numIndices,
+            malha.tipoDeIndice);
+        if (!id.has_value()) {
+            // Pode haver espaço suficiente, só que espalhado
+            // entre as malhas já removidas.
+            compactarPoolDeGeometria();
+            id = poolDeGeometria_.adicionar(
+                dadosDosFluxos, malha.numVertices,
+                malha.indices.data(), malha.numIndices,
+                malha.tipoDeIndice);
+        }
+        if (!id.has_value()) {
+            throw std::runtime_error(
+                "A malha não cabe no pool de geometria.");
+        }
+
+        if (id.value() >= dequantizacaoDasMalhas_.size()) {
+            dequantizacaoDasMalhas_.resize(id.value() + 1);
+        }
+        dequantizacaoDasMalhas_[id.value()] =
+            malha.dequantizacao;
+        if (id.value() >= niveisDasMalhas_.size()) {
+            niveisDasMalhas_.resize(id.value() + 1);
+        }
+        niveisDasMalhas_[id.value()] = malha.niveis;
+        if (id.value() >= esferasDasMalhas_.size()) {
+            esferasDasMalhas_.resize(id.value() + 1);
+        }
+        esferasDasMalhas_[id.value()] = malha.esfera;
+        enviarMeshlets(id.value(), malha.meshlets);
+        return id.value();
+    }
+
+    void enviarMeshlets(PoolDeGeometria::IdDeMalha id,
+                        const std::vector<Meshlet>& meshlets) {
+        vk::DeviceSize tamanho =
+            meshlets.size() * sizeof(Meshlet);
+        auto deslocamento =
+            meshletsDoPool_->alocar(tamanho, sizeof(Meshlet));
+        if (!deslocamento.has_value()) {
+            throw std::runtime_error(
+                "Os meshlets não cabem no buffer de meshlets.");
+        }
+        contextoDeEnvio_.enviarParaBuffer(
+            bufferDeMeshlets_, deslocamento.value(),
+            meshlets.data(), tamanho,
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::AccessFlagBits::eShaderRead);
+
+        if (id >= primeiroMeshletDasMalhas_.size()) {
+            primeiroMeshletDasMalhas_.resize(id + 1);
+        }
+        primeiroMeshletDasMalhas_[id] = static_cast<uint32_t>(
+            deslocamento.value() / sizeof(Meshlet));
+    }
+
+    std::vector<PoolDeGeometria::IdDeMalha> adicionarMalhas(
+        const std::vector<MalhaPreparada>& malhas) {
+        std::vector<PoolDeGeometria::IdDeMalha> ids;
+        for (const auto& malha : malhas) {
+            ids.push_back(adicionarMalha(malha));
+        }
+        return ids;
+    }
+
+    // Um cubo com as faces no sentido anti-horário vistas de
+    // fora, como nos OBJ, desenhado no lugar do modelo enquanto
+    // ele carrega.
+    MalhaPreparada prepararMalhaSubstituta(
+        FormatoDeVertice formato) {
+        const std::array<glm::vec2, 4> cantos = {
+            glm::vec2{0.0f, 0.0f}, glm::vec2{1.0f, 0.0f},
+            glm::vec2{1.0f, 1.0f}, glm::vec2{0.0f, 1.0f}};
+
+        std::vector<Vertice> vertices;
+        std::vector<uint16_t> indices;
+        for (int eixo = 0; eixo < 3; eixo++) {
+            for (float sinal : {-1.0f, 1.0f}) {
+                glm::vec3 normal(0.0f), u(0.0f), v(0.0f);
+                normal[eixo] = sinal;
+                u[(eixo + 1) % 3] = sinal;
+                v[(eixo + 2) % 3] = 1.0f;
+
+                auto base =
+                    static_cast<uint16_t>(vertices.size());
+                for (const auto& canto : cantos) {
+                    glm::vec3 posicao =
+                        normal + (canto.x * 2.0f - 1.0f) * u +
+                        (canto.y * 2.0f - 1.0f) * v;
+                    posicao *= kLadoDaMalhaSubstituta / 2.0f;
+                    vertices.push_back(
+                        {posicao, glm::vec3(1.0f), canto});
+                }
+                for (int i : {0, 1, 2, 2, 3, 0}) {
+                    indices.push_back(
+                        static_cast<uint16_t>(base + i));
+                }
+            }
+        }
+
+        return prepararMalha(
+            formato, vertices.data(),
+            static_cast<uint32_t>(vertices.size()),
+            indices.data(),
+            static_cast<uint32_t>(indices.size()),
+            vk::IndexType::eUint16);
+    }
+
+    void removerMalha(PoolDeGeometria::IdDeMalha id) {
+        // Os intervalos da malha podem ser reusados pelo
+        // próximo envio, então só são liberados quando nenhum
+        // quadro em execução puder mais lê-los.
+        filaDeDestruicao_.adiar([this, id]() {
+            poolDeGeometria_.remover(id);
+            meshletsDoPool_->liberar(
+                uint64_t{primeiroMeshletDasMalhas_[id]} *
+                sizeof(Meshlet));
+        });
+    }
+
+    // Copia as malhas para buffers novos sem buracos entre
+    // elas. Os antigos vão para a fila de destruição, porque os
+    // quadros em execução ainda podem lê-los.
+    void compactarPoolDeGeometria() {
+        // A cópia lê os envios ainda não submetidos. Eles podem
+        // estar na fila de transferência, e a de gráficos só
+        // espera cada lote pelo semáforo dele, então a cópia
+        // espera as cercas de todos antes de ser gravada.
+        contextoDeEnvio_.submeter();
+        contextoDeEnvio_.esperar();
+
+        vk::Buffer novoBufferDeVertices, novoBufferDeIndices;
+        Alocacao novaAlocacaoDeVertices, novaAlocacaoDeIndices;
+        criarBuffersDoPoolDeGeometria(
+            novoBufferDeVertices, novaAlocacaoDeVertices,
+            novoBufferDeIndices, novaAlocacaoDeIndices);
+
+        auto comando = iniciarComandoDeUsoUnico();
+        poolDeGeometria_.compactar(
+            comando, novoBufferDeVertices,
+            kCapacidadeDeVerticesDoPool, novoBufferDeIndices,
+            kTamanhoDoBufferDeIndicesDoPool);
+        submeterComandoDeUsoUnico(comando);
+
+        filaDeDestruicao_.adiar(
+            [this, bufferDeVertices = bufferDeVertices_,
+             alocacaoDeVertices = alocacaoBufferDeVertices_,
+             bufferDeIndices = bufferDeIndices_,
+             alocacaoDeIndices =
+                 alocacaoBufferDeIndices_]() mutable {
+                dispositivo_.destroyBuffer(bufferDeIndices);
+                alocador_.liberar(alocacaoDeIndices);
+                dispositivo_.destroyBuffer(bufferDeVertices);
+                alocador_.liberar(alocacaoDeVertices);
+            });
+        bufferDeVertices_ = novoBufferDeVertices;
+        alocacaoBufferDeVertices_ = novaAlocacaoDeVertices;
+        bufferDeIndices_ = novoBufferDeIndices;
+        alocacaoBufferDeIndices_ = novaAlocacaoDeIndices;
+        // As malhas mudaram de lugar nos buffers.
+        versaoDaCena_++;
+    }
+
+    void imprimirEstatisticasDoPoolDeGeometria() {
+        auto vertices =
+            poolDeGeometria_.estatisticasDeVertices();
+        auto indices = poolDeGeometria_.estatisticasDeIndices();
+        std::cout << "Pool de geometria: "
+                  << vertices.bytesUsados << "/"
+                  << vertices.tamanhoTotal
+                  << " vértices, " << indices.bytesUsados << "/"
+                  << indices.tamanhoTotal
+                  << " bytes de índices, fragmentação "
+                  << indices.fragmentacao() << std::endl;
+    }
+
+    // Retorna logo. A preparação roda numa thread de trabalho e
+    // as malhas entram no pool na conclusão, trocando a
+    // substituta.
+    void pedirModelo() {
+        auto formato = formatoDeVertice_;
+        carregador_.pedir([this, formato]() {
+            auto malhas = prepararModelo(formato);
+            return [this, formato,
+                    malhas = std::move(malhas)]() {
+                // O formato pode ter sido trocado, com o modelo
+                // já recarregado, durante a preparação.
+                if (formato == formatoDeVertice_) {
+                    malhasDoModelo_ = adicionarMalhas(malhas);
+                    // A substituta não é mais desenhada, e os
+                    // quadros em execução a liberam.
+                    removerMalha(malhaSubstituta_);
+                    versaoDaCena_++;
+                }
+            };
+        });
+    }
+
+    // Também pede de novo a textura despejada pelo orçamento.
+    void pedirTextura() {
+        pedidoDaTextura_ = carregador_.pedir([this]() {
+            auto textura = std::make_shared<TexturaPreparada>();
+            prepararTextura(kCaminhoDaTextura,
+                            kCaminhoDaTexturaCozida, *textura);
+            return [this, textura]() {
+                enviarTextura(*textura);
+                atualizarDescritorDaTextura();
+            };
+        });
+    }
+
+    // A textura guarda o que for preciso para ser recriada
+    // depois de despejada pelo orçamento.
+    void enviarTextura(const TexturaPreparada& preparada) {
+        enviarTexturaPreparada(preparada, textura_,
+                               alocacaoTextura_,
+                               numNiveisDaTextura_);
+        visaoDaTextura_ = criarVisaoDeImagem(
+            textura_, preparada.formato,
+            vk::ImageAspectFlagBits::eColor,
+            numNiveisDaTextura_);
+        orcamento_.marcarResidente(
+            idDaTextura_,
+            orcamento_.heapDoTipo(
+                alocacaoTextura_.tipoDeMemoria),
+            alocacaoTextura_.tamanho);
+    }
+
+    void despejarTextura() {
+        dispositivo_.destroyImageView(visaoDaTextura_);
+        visaoDaTextura_ = nullptr;
+        dispositivo_.destroyImage(textura_);
+        textura_ = nullptr;
+        alocador_.liberar(alocacaoTextura_);
+    }
+
+    // Pede de novo o que foi despejado, usando a substituta até
+    // ficar pronto. Um recurso só é despejado depois de passar
+    // todos os quadros em execução sem ser desenhado, e daí em
+    // diante o set de descritores dele não é associado, então
+    // nenhum comando pendente ainda referencia o set que é
+    // atualizado na conclusão.
+    void garantirResidencia() {
+        if (!orcamento_.residente(idDaTextura_) &&
+            carregador_.pronto(pedidoDaTextura_)) {
+            pedirTextura();
+        }
+    }
+
+    // Separa as malhas com índices de 16 bits quando eles
+    // endereçam todos os vértices. Caso contrário, a malha usa
+    // índices de 32 bits ou é dividida em submalhas, que ficam
+    // só com o nível de detalhe completo.
+    std::vector<MalhaPreparada> prepararModelo(
+        FormatoDeVertice formato,
+        const std::vector<Vertice>& vertices,
+        const std::vector<uint32_t>& indices) {
+        auto tipoDeIndice =
+            tipoDeIndiceParaVertices(vertices.size());
+        auto numVertices =
+            static_cast<uint32_t>(vertices.size());
+
+        if (tipoDeIndice == vk::IndexType::eUint16 ||
+            !kDividirMalhasGrandes) {
+            std::vector<uint32_t> todosOsNiveis;
+            auto niveis = juntarNiveis(
+                gerarNiveisDeDetalhe(vertices, indices),
+                todosOsNiveis);
+            auto meshlets =
+                gerarMeshlets(vertices, todosOsNiveis, niveis);
+            auto numIndices =
+                static_cast<uint32_t>(todosOsNiveis.size());
+            if (tipoDeIndice == vk::IndexType::eUint16) {
+                auto estreitos =
+                    estreitarIndices(todosOsNiveis);
+                return {prepararMalha(
+                    formato, vertices.data(), numVertices,
+                    estreitos.data(), numIndices, tipoDeIndice,
+                    std::move(niveis), std::move(meshlets))};
+            }
+            return {prepararMalha(
+                formato, vertices.data(), numVertices,
+                todosOsNiveis.data(), numIndices, tipoDeIndice,
+                std::move(niveis), std::move(meshlets))};
+        }
+
+        std::vector<MalhaPreparada> malhas;
+        for (const auto& submalha :
+             dividirEmSubmalhas(vertices, indices)) {
+            malhas.push_back(prepararMalha(
+                formato, submalha.vertices.data(),
+                static_cast<uint32_t>(submalha.vertices.size()),
+                submalha.indices.data(),
+                static_cast<uint32_t>(submalha.indices.size()),
+                vk::IndexType::eUint16));
+        }
+        return malhas;
+    }
+
+    // Os vértices da malha cozida são lidos direto do arquivo
+    // mapeado e separados em fluxos. O OBJ só é importado
+    // quando ela não existe ou é de uma versão antiga do
+    // formato.
+    std::vector<MalhaPreparada> prepararModelo(
+        FormatoDeVertice formato) {
+        MalhaCozida malhaCozida;
+        if (malhaCozida.abrir(kCaminhoDaMalhaCozida)) {
+            const auto& cabecalho = malhaCozida.cabecalho();
+            bool dividir =
+                kDividirMalhasGrandes &&
+                malhaCozida.tipoDeIndice() ==
+                    vk::IndexType::eUint32;
+            if (!dividir) {
+                return {prepararMalha(
+                    formato, malhaCozida.vertices(),
+                    cabecalho.numVertices,
+                    malhaCozida.indices(),
+                    cabecalho.numIndices,
+                    malhaCozida.tipoDeIndice(),
+                    std::vector<NivelDaMalha>(
+                        malhaCozida.niveis(),
+                        malhaCozida.niveis() +
+                            cabecalho.numNiveis),
+                    std::vector<Meshlet>(
+                        malhaCozida.meshlets(),
+                        malhaCozida.meshlets() +
+                            cabecalho.numMeshlets))};
+            }
+
+            // Só o nível completo, que vem primeiro.
+            std::vector<Vertice> vertices(
+                malhaCozida.vertices(),
+                malhaCozida.vertices() + cabecalho.numVertices);
+            auto indicesMapeados =
+                static_cast<const uint32_t*>(
+                    malhaCozida.indices());
+            std::vector<uint32_t> indices(
+                indicesMapeados,
+                indicesMapeados +
+                    malhaCozida.niveis()[0].numIndices);
+            return prepararModelo(formato, vertices, indices);
+        }
+
+        std::vector<Vertice> vertices;
+        std::vector<uint32_t> indices;
+        importarObj(kCaminhoDoModelo, vertices, indices);
+        otimizarMalha(vertices, indices);
+        return prepararModelo(formato, vertices, indices);
+    }
+
+    // Síncrono, sem passar pelo carregador.
+    std::vector<PoolDeGeometria::IdDeMalha> carregarModelo() {
+        return adicionarMalhas(
+            prepararModelo(formatoDeVertice_));
+    }
+
+    // Só grava o envio; ele vai para a GPU no próximo
+    // `contextoDeEnvio_.submeter()`.
+    void atualizarBuffer(vk::Buffer buffer,
+                         size_t tamanho,
+                         const void* dados) {
+        contextoDeEnvio_.enviarParaBuffer(buffer, 0, dados,
+                                          tamanho);
+    }
+
+    void criarBuffer(vk::BufferUsageFlags usos,
+                     size_t tamanho,
+                     vk::MemoryPropertyFlags propriedades,
+                     vk::Buffer& buffer,
+                     Alocacao& alocacao) {
+        vk::BufferCreateInfo infoBuffer;
+        // infoBuffer.flags = {};
+        infoBuffer.size = tamanho;
+        infoBuffer.usage = usos;
+        infoBuffer.sharingMode = vk::SharingMode::eExclusive;
+        // infoBuffer.queueFamilyIndexCount = 0;
+        // infoBuffer.pQueueFamilyIndices = nullptr;
+
+        buffer = dispositivo_.createBuffer(infoBuffer);
+
+        auto requisitosDeMemoria =
+            dispositivo_.getBufferMemoryRequirements(buffer);
+        auto tipoDeMemoria = buscarTipoDeMemoria(
+            requisitosDeMemoria.memoryTypeBits, propriedades,
+            requisitosDeMemoria.size);
+
+        alocacao = alocador_.alocar(requisitosDeMemoria,
+                                    tipoDeMemoria, true);
+
+        dispositivo_.bindBufferMemory(buffer, alocacao.memoria,
+                                      alocacao.deslocamento);
+    }
+
+    // Decodifica a imagem original. Só o nível 0 é preparado.
+    void prepararImagem(const std::string& caminho,
+                        TexturaPreparada& textura) {
+        int largura, altura, _canais;
+        stbi_uc* pixels =
+            stbi_load(caminho.c_str(), &largura, &altura,
+                      &_canais, STBI_rgb_alpha);
+        if (pixels == nullptr) {
+            throw std::runtime_error(
+                "Não foi possível carregar a imagem '" +
+                caminho + "'.");
+        }
+        auto larguraDoNivel = static_cast<uint32_t>(largura);
+        auto alturaDoNivel = static_cast<uint32_t>(altura);
+        textura.texels.emplace_back(
+            pixels, pixels + size_t{larguraDoNivel} *
+                                 alturaDoNivel * 4);
+        stbi_image_free(pixels);
+
+        textura.formato = vk::Format::eR8G8B8A8Srgb;
+        textura.bytesPorBloco = 4;
+        textura.ladoDoBloco = 1;
+        textura.gerarMipmaps = true;
+        textura.niveis = {{textura.texels[0].data(),
+                           larguraDoNivel, alturaDoNivel}};
+    }
+
+    // Os níveis de uma textura cozida, ainda comprimidos e
+    // lidos direto do arquivo mapeado. Sem suporte a BC no
+    // dispositivo, cada nível é descomprimido. Retorna falso se
+    // a textura cozida não existir ou, sem suporte a BC, se
+    // tiver blocos BC7 que o decodificador não aceita.
+    bool prepararTexturaCozida(const std::string& caminho,
+                               TexturaPreparada& textura) {
+        auto& arquivo = textura.arquivo;
+        if (!arquivo.abrir(caminho)) {
+            return false;
+        }
+        if (!formatoBc(arquivo.formato())) {
+            throw std::runtime_error(
+                "A textura '" + caminho +
+                "' não está em BC1, BC3 nem BC7.");
+        }
+
+        textura.formato = arquivo.formato();
+        textura.bytesPorBloco =
+            bytesPorBlocoBc(textura.formato);
+        textura.ladoDoBloco = kLadoDoBlocoBc;
+        textura.gerarMipmaps = false;
+        if (!suportaCompressaoBc_) {
+            textura.formato =
+                formatoDescomprimido(textura.formato);
+            textura.bytesPorBloco = 4;
+            textura.ladoDoBloco = 1;
+        }
+
+        uint32_t numNiveis = arquivo.cabecalho().numNiveis;
+        for (uint32_t i = 0; i < numNiveis; i++) {
+            auto nivel = arquivo.nivel(i);
+            if (nivel.tamanho !=
+                tamanhoComprimido(arquivo.formato(),
+                                  nivel.largura,
+                                  nivel.altura)) {
+                throw std::runtime_error(
+                    "O nível " + std::to_string(i) +
+                    " da textura '" + caminho +
+                    "' tem o tamanho errado.");
+            }
+            // Um arquivo de outro cozinhador pode usar modos
+            // de BC7 além do 6, e então a imagem original é
+            // usada no lugar dele.
+            if (!suportaCompressaoBc_ &&
+                !descomprimivel(arquivo.formato(), nivel.dados,
+                                nivel.tamanho)) {
+                std::cerr << "A textura '" << caminho
+                          << "' usa modos de BC7 que não podem "
+                             "ser descomprimidos; usando a "
+                             "imagem original."
+                          << std::endl;
+                arquivo.fechar();
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < numNiveis; i++) {
+            auto nivel = arquivo.nivel(i);
+
+            const void* dados = nivel.dados;
+            if (!suportaCompressaoBc_) {
+                textura.texels.push_back(descomprimirBc(
+                    arquivo.formato(), nivel.dados,
+                    nivel.largura, nivel.altura));
+                dados = textura.texels.back().data();
+            }
+            textura.niveis.push_back(
+                {dados, nivel.largura, nivel.altura});
+        }
+        return true;
+    }
+
+    // Prefere a textura cozida e, sem ela, decodifica a imagem
+    // original. Pode rodar numa thread de trabalho.
+    void prepararTextura(const std::string& caminho,
+                         const std::string& caminhoCozido,
+                         TexturaPreparada& textura) {
+        if (!prepararTexturaCozida(caminhoCozido, textura)) {
+            prepararImagem(caminho, textura);
+        }
+    }
+
+    // Gera a cadeia de mips inteira na GPU quando só o nível 0
+    // foi preparado e o formato permite o blit com filtro
+    // linear.
+    void enviarTexturaPreparada(const TexturaPreparada& textura,
+                                vk::Image& imagem,
+                                Alocacao& alocacao,
+                                uint32_t& numNiveis) {
+        const auto& base = textura.niveis[0];
+        vk::Extent3D dimensoes{base.largura, base.altura, 1u};
+        vk::ImageUsageFlags usos =
+            vk::ImageUsageFlagBits::eTransferDst |
+            vk::ImageUsageFlagBits::eSampled;
+        numNiveis =
+            static_cast<uint32_t>(textura.niveis.size());
+        if (textura.gerarMipmaps &&
+            suportaBlitLinear(textura.formato)) {
+            numNiveis =
+                numNiveisDeMip(base.largura, base.altura);
+            usos |= vk::ImageUsageFlagBits::eTransferSrc;
+        }
+
+        criarImagem(textura.formato, dimensoes, usos, imagem,
+                    alocacao, numNiveis);
+
+        if (textura.gerarMipmaps) {
+            contextoDeEnvio_.enviarParaImagem(
+                imagem, base.dados, base.largura, base.altura,
+                textura.bytesPorBloco,
+                vk::ImageLayout::eShaderReadOnlyOptimal,
+                vk::PipelineStageFlagBits::eFragmentShader,
+                vk::AccessFlagBits::eShaderRead, numNiveis);
+        } else {
+            contextoDeEnvio_.enviarNiveisParaImagem(
+                imagem, textura.niveis, textura.bytesPorBloco,
+                textura.ladoDoBloco,
+                vk::ImageLayout::eShaderReadOnlyOptimal,
+                vk::PipelineStageFlagBits::eFragmentShader,
+                vk::AccessFlagBits::eShaderRead);
+        }
+    }
+
+    // Um xadrez cinza, amostrado enquanto a textura carrega ou
+    // depois de ela ser despejada.
+    void criarTexturaSubstituta() {
+        const uint32_t lado = kLadoDaTexturaSubstituta;
+        const uint32_t casa = kLadoDaCasaDaTexturaSubstituta;
+        std::vector<uint8_t> texels(size_t{lado} * lado * 4);
+        for (uint32_t y = 0; y < lado; y++) {
+            for (uint32_t x = 0; x < lado; x++) {
+                bool clara = (x / casa + y / casa) % 2 == 0;
+                uint8_t tom = clara ? 160 : 96;
+                auto texel =
+                    &texels[(size_t{y} * lado + x) * 4];
+                texel[0] = texel[1] = texel[2] = tom;
+                texel[3] = 255;
+            }
+        }
+
+        criarImagem(vk::Format::eR8G8B8A8Srgb,
+                    vk::Extent3D{lado, lado, 1u},
+                    vk::ImageUsageFlagBits::eTransferDst |
+                        vk::ImageUsageFlagBits::eSampled,
+                    texturaSubstituta_,
+                    alocacaoTexturaSubstituta_);
+        contextoDeEnvio_.enviarParaImagem(
+            texturaSubstituta_, texels.data(), lado, lado, 4,
+            vk::ImageLayout::eShaderReadOnlyOptimal,
+            vk::PipelineStageFlagBits::eFragmentShader,
+            vk::AccessFlagBits::eShaderRead);
+        visaoDaTexturaSubstituta_ = criarVisaoDeImagem(
+            texturaSubstituta_, vk::Format::eR8G8B8A8Srgb,
+            vk::ImageAspectFlagBits::eColor);
+    }
+
+    bool suportaBlitLinear(vk::Format formato) {
+        auto capacidades =
+            dispositivoFisico_.getFormatProperties(formato)
+                .optimalTilingFeatures;
+        vk::FormatFeatureFlags necessarias =
+            vk::FormatFeatureFlagBits::eBlitSrc |
+            vk::FormatFeatureFlagBits::eBlitDst |
+            vk::FormatFeatureFlagBits::
+                eSampledImageFilterLinear;
+        return (capacidades & necessarias) == necessarias;
+    }
+
+    // Até o nível de 1x1.
+    uint32_t numNiveisDeMip(uint32_t largura, uint32_t altura) {
+        uint32_t numNiveis = 1;
+        for (uint32_t lado = std::max(largura, altura);
+             lado > 1; lado /= 2) {
+            numNiveis++;
+        }
+        return numNiveis;
+    }
+
+    // `maximoLod` 0 amostra só o nível 0.
+    vk::Sampler criarAmostrador(float maximoLod) {
+        vk::SamplerCreateInfo info;
+        info.magFilter = vk::Filter::eLinear;
+        info.minFilter = vk::Filter::eLinear;
+        info.mipmapMode = vk::SamplerMipmapMode::eLinear;
+        info.minLod = 0.0f;
+        info.maxLod = maximoLod;
+
+        return dispositivo_.createSampler(info);
+    }
+
+    // Prefere um tipo cujo heap ainda tenha `tamanho` bytes
+    // livres no orçamento. Se nenhum tiver, fica com o primeiro
+    // adequado e o alocador despeja recursos para abrir espaço.
+    uint32_t buscarTipoDeMemoria(
+        uint32_t filtro,
+        vk::MemoryPropertyFlags propriedades,
+        vk::DeviceSize tamanho = 0) {
+        auto tiposDeMemorias =
+            dispositivoFisico_.getMemoryProperties();
+        std::optional<uint32_t> primeiroAdequado;
+        for (uint32_t i = 0;
+             i < tiposDeMemorias.memoryTypeCount; i++) {
+            const auto& tipoDeMemoria =
+                tiposDeMemorias.memoryTypes[i];
+
+            bool passaPeloFiltro = (1u << i) & filtro;
+            bool possuiAsPropriedades =
+                (tipoDeMemoria.propertyFlags & propriedades) ==
+                propriedades;
+
+            if (!passaPeloFiltro || !possuiAsPropriedades) {
+                continue;
+            }
+            if (orcamento_.cabe(tipoDeMemoria.heapIndex,
+                                tamanho)) {
+                return i;
+            }
+            if (!primeiroAdequado.has_value()) {
+                primeiroAdequado = i;
+            }
+        }
+
+        if (primeiroAdequado.has_value()) {
+            return primeiroAdequado.value();
+        }
+
+        throw std::runtime_error(
+            "Não foi encontrada um tipo de memória adequado.");
+    }
+
+    vk::CommandBuffer iniciarComandoDeUsoUnico() {
+        vk::CommandBufferAllocateInfo infoAlloc;
+        infoAlloc.commandPool = poolDeComandos_;
+        infoAlloc.commandBufferCount = 1;
+
+        vk::CommandBuffer comando =
+            dispositivo_.allocateCommandBuffers(infoAlloc)[0];
+
+        vk::CommandBufferBeginInfo infoBegin;
+        infoBegin.flags =
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+
+        comando.begin(infoBegin);
+
+        return comando;
+    }
+
+    // Não espera a fila: os quadros gravados depois são
+    // submetidos depois dele na mesma fila, e o buffer de
+    // comandos é liberado pela fila de destruição.
+    void submeterComandoDeUsoUnico(vk::CommandBuffer comando) {
+        comando.end();
+
+        vk::SubmitInfo infoSubmit;
+        infoSubmit.commandBufferCount = 1;
+        infoSubmit.pCommandBuffers = &comando;
+
+        filaDeGraficos_.submit(infoSubmit, nullptr);
+
+        filaDeDestruicao_.adiar([this, comando]() {
+            dispositivo_.freeCommandBuffers(poolDeComandos_,
+                                            {comando});
+        });
+    }
+
+    void finalizarComandoDeUsoUnico(vk::CommandBuffer comando) {
+        comando.end();
+
+        vk::SubmitInfo infoSubmit;
+        infoSubmit.commandBufferCount = 1;
+        infoSubmit.pCommandBuffers = &comando;
+
+        filaDeGraficos_.submit(infoSubmit, nullptr);
+        filaDeGraficos_.waitIdle();
+
+        dispositivo_.freeCommandBuffers(poolDeComandos_,
+                                        {comando});
+    }
+
+    void criarArenaDeUniformes() {
+        vk::DeviceSize alinhamento =
+            dispositivoFisico_.getProperties()
+                .limits.minUniformBufferOffsetAlignment;
+        criarBuffer(vk::BufferUsageFlagBits::eUniformBuffer,
+                    ArenaDeUniformes::tamanhoTotal(
+                        kTamanhoDaArenaPorQuadro, alinhamento,
+                        kMaximoQuadrosEmExecucao),
+                    vk::MemoryPropertyFlagBits::eHostVisible |
+                        vk::MemoryPropertyFlagBits::
+                            eHostCoherent,
+                    bufferDaArenaDeUniformes_,
+                    alocacaoArenaDeUniformes_);
+        arenaDeUniformes_.iniciar(
+            bufferDaArenaDeUniformes_,
+            alocacaoArenaDeUniformes_.mapeamento,
+            kTamanhoDaArenaPorQuadro, alinhamento);
+    }
+
+    void atualizarOBU() {
+        glm::vec3 posicaoDaCamera = {-0.2f, -0.5f, -1.0f};
+        glm::vec3 alvoDaCamera = glm::zero<glm::vec3>();
+        glm::vec3 cimaDaCamera = {0.0f, -1.0f, 0.0f};
+        obu_.visao = glm::scale(glm::identity<glm::mat4>(),
+                                {1, -1, -1}) *
+                     glm::lookAt(posicaoDaCamera, alvoDaCamera,
+                                 cimaDaCamera);
+
+        float fovVertical = glm::radians(90.0f);
+        float proporcaoDaTela =
+            static_cast<float>(dimensoesDaSwapchain_.width) /
+            static_cast<float>(dimensoesDaSwapchain_.height);
+        obu_.projecao =
+            glm::perspective(fovVertical, proporcaoDaTela,
+                             kPlanoProximo, 100.0f) *
+            glm::scale(glm::identity<glm::mat4>(), {1, 1, -1});
+    }
+
+    // O set da textura só recebe a imagem quando ela fica
+    // pronta.
+    void criarSetsDeDescritores() {
+        std::array<vk::DescriptorSetLayout, 2> layouts = {
+            layoutDoSetDeDescritores_,
+            layoutDoSetDeDescritores_};
+        vk::DescriptorSetAllocateInfo infoAloc;
+        infoAloc.descriptorPool = poolDeDescritores_;
+        infoAloc.descriptorSetCount =
+            static_cast<uint32_t>(layouts.size());
+        infoAloc.pSetLayouts = layouts.data();
+
+        auto sets =
+            dispositivo_.allocateDescriptorSets(infoAloc);
+        setDeDescritores_ = sets[0];
+        setDaTexturaSubstituta_ = sets[1];
+
+        vk::DescriptorBufferInfo infoOBU = {
+            bufferDaArenaDeUniformes_, 0, sizeof(OBU)};
+
+        vk::DescriptorImageInfo infoTextura = {
+            amostrador_, visaoDaTexturaSubstituta_,
+            vk::ImageLayout::eShaderReadOnlyOptimal};
+
+        std::array<vk::WriteDescriptorSet, 3> escritas = {
+            vk::WriteDescriptorSet{
+                setDeDescritores_,
+                0,
+                0,
+                1,
+                vk::DescriptorType::eUniformBufferDynamic,
+                {},
+                &infoOBU},
+            vk::WriteDescriptorSet{
+                setDaTexturaSubstituta_,
+                0,
+                0,
+                1,
+                vk::DescriptorType::eUniformBufferDynamic,
+                {},
+                &infoOBU},
+            vk::WriteDescriptorSet{
+                setDaTexturaSubstituta_, 1, 0, 1,
+                vk::DescriptorType::eCombinedImageSampler,
+                &infoTextura}};
+
+        dispositivo_.updateDescriptorSets(escritas, {});
+    }
+
+    void atualizarDescritorDaTextura() {
+        vk::DescriptorImageInfo infoTextura = {
+            amostrador_, visaoDaTextura_,
+            vk::ImageLayout::eShaderReadOnlyOptimal};
+
+        vk::WriteDescriptorSet escreverTextura{
+            setDeDescritores_, 1, 0, 1,
+            vk::DescriptorType::eCombinedImageSampler,
+            &infoTextura};
+
+        dispositivo_.updateDescriptorSets(escreverTextura, {});
+    }
+
+    void loopPrincipal() {
+        auto tempoInicial = std::chrono::system_clock::now();
+        while (!glfwWindowShouldClose(janela_)) {
+            auto tempoAtual = std::chrono::system_clock::now();
+            auto tempoDecorrido = tempoAtual - tempoInicial;
+            glfwPollEvents();
+            atualizar(std::chrono::duration<
+                      float, std::chrono::seconds::period>(
+                tempoDecorrido));
+            renderizar();
+            if (precisaRecriarContextoDeRenderizacao_) {
+                recriarContextoDeRenderizacao();
+            }
+        }
+        dispositivo_.waitIdle();
+    }
+
+    void atualizar(
+        std::chrono::duration<float,
+                              std::chrono::seconds::period>
+            tempoDecorrido) {
+        float rotacaoDaCena =
+            glm::half_pi<float>() * tempoDecorrido.count();
+        pushConstants_.modelo =
+            glm::rotate(glm::identity<glm::mat4>(),
+                        rotacaoDaCena, {0.0f, 1.0f, 0.0f});
+        atualizarOBU();
+    }
+
+    void renderizar() {
+        contextoDeEnvio_.reciclar();
+
+        auto cercaAtual = cercasDeQuadros_[quadroAtual_];
+        auto semaforoDeImagemDisponivelAtual =
+            semaforosDeImagemDisponivel_[quadroAtual_];
+        auto semaforoDeRenderizacaoCompletaAtual =
+            semaforosDeRenderizacaoCompleta_[quadroAtual_];
+
+        std::ignore = dispositivo_.waitForFences(
+            cercaAtual, false,
+            std::numeric_limits<uint64_t>::max());
+        filaDeDestruicao_.coletar();
+        lerContadoresDeMeshlets();
+        lerContadoresDaCena();
+
+        auto indiceDaImagem = tentarAdquirirImagem(
+            semaforoDeImagemDisponivelAtual);
+        if (!indiceDaImagem.has_value()) {
+            precisaRecriarContextoDeRenderizacao_ = true;
+            return;
+        }
+
+        esperarCercaDaImagemAtual(indiceDaImagem.value());
+        imagensEmExecucao_[indiceDaImagem.value()] = cercaAtual;
+
+        dispositivo_.resetFences(cercaAtual);
+
+        // A cerca deste quadro já foi esperada, então a GPU não
+        // lê mais a partição dele na arena.
+        arenaDeUniformes_.comecarQuadro(quadroAtual_);
+        uint32_t deslocamentoDaOBU =
+            arenaDeUniformes_.escrever(obu_);
+
+        garantirResidencia();
+        concluirCarregamentos();
+        verificarShadersModificados();
+
+        vk::CommandBuffer bufferDeComandosAtual =
+            buffersDeComandos_[quadroAtual_];
+        auto inicioDaGravacao =
+            std::chrono::steady_clock::now();
+        gravarBufferDeComandos(
+            bufferDeComandosAtual,
+            framebuffers_[indiceDaImagem.value()],
+            deslocamentoDaOBU);
+        msDeGravacao_ +=
+            std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() -
+                inicioDaGravacao)
+                .count();
+        submeterParaRenderizar(
+            bufferDeComandosAtual,
+            semaforoDeImagemDisponivelAtual,
+            semaforoDeRenderizacaoCompletaAtual, cercaAtual);
+
+        precisaRecriarContextoDeRenderizacao_ =
+            tentarApresentarImagem(
+                indiceDaImagem.value(),
+                semaforoDeRenderizacaoCompletaAtual);
+
+        quadroAtual_ =
+            (quadroAtual_ + 1) % kMaximoQuadrosEmExecucao;
+        orcamento_.avancarQuadro();
+        filaDeDestruicao_.avancarQuadro();
+    }
+
+    std::optional<uint32_t> tentarAdquirirImagem(
+        vk::Semaphore semaforoASinalizar) {
+        try {
+            return dispositivo_
+                .acquireNextImageKHR(
+                    swapChain_,
+                    std::numeric_limits<uint64_t>::max(),
+                    semaforoASinalizar, nullptr)
+                .value;
+        } catch (const vk::OutOfDateKHRError&) {
+            return {};
+        }
+    }
+
+    void esperarCercaDaImagemAtual(uint32_t indiceDaImagem) {
+        auto& cercaDaImagemAtual =
+            imagensEmExecucao_[indiceDaImagem];
+        if (cercaDaImagemAtual.has_value()) {
+            std::ignore = dispositivo_.waitForFences(
+                cercaDaImagemAtual.value(), false,
+                std::numeric_limits<uint64_t>::max());
+        }
+    }
+
+    void submeterParaRenderizar(
+        vk::CommandBuffer bufferDeComandos,
+        vk::Semaphore semaforoAEsperar,
+        vk::Semaphore semaforoASinalizar,
+        vk::Fence cercaASinalizar) {
+        vk::PipelineStageFlags estagiosAEsperar =
+            vk::PipelineStageFlagBits::eColorAttachmentOutput;
+        vk::SubmitInfo infoSubmissao;
+        infoSubmissao.waitSemaphoreCount = 1;
+        infoSubmissao.pWaitSemaphores = &semaforoAEsperar;
+        infoSubmissao.pWaitDstStageMask = &estagiosAEsperar;
+        infoSubmissao.commandBufferCount = 1;
+        infoSubmissao.pCommandBuffers = &bufferDeComandos;
+        infoSubmissao.signalSemaphoreCount = 1;
+        infoSubmissao.pSignalSemaphores = &semaforoASinalizar;
+
+        filaDeGraficos_.submit(infoSubmissao, cercaASinalizar);
+    }
+
+    bool tentarApresentarImagem(
+        uint32_t indiceDaImagem,
+        vk::Semaphore semaforoAEsperar) {
+        vk::PresentInfoKHR infoApresentacao;
+        infoApresentacao.waitSemaphoreCount = 1;
+        infoApresentacao.pWaitSemaphores = &semaforoAEsperar;
+        infoApresentacao.swapchainCount = 1;
+        infoApresentacao.pSwapchains = &swapChain_;
+        infoApresentacao.pImageIndices = &indiceDaImagem;
+
+        try {
+            vk::Result resultado =
+                filaDeApresentacao_.presentKHR(
+                    infoApresentacao);
+            if (resultado == vk::Result::eSuboptimalKHR) {
+                return true;
+            }
+        } catch (const vk::OutOfDateKHRError&) {
+            return true;
+        }
+
+        return false;
+    }
+
+    void recriarContextoDeRenderizacao() {
+        esperarDimensoesValidas();
+        // A recarga em andamento cria as pipelines com o passe
+        // atual, que vai para a fila de destruição.
+        if (recarregandoShaders()) {
+            carregador_.esperarTrabalho(*pedidoDeShaders_);
+        }
+        adiarDestruicaoDoContextoDeRenderizacao();
+        criarContextoDeRenderizacao();
+        // A pirâmide segue as dimensões e a profundidade novas.
+        if (suportaOclusao_) {
+            filaDeDestruicao_.adiar(
+                [this, piramide = piramide_]() mutable {
+                    destruirPiramideDeProfundidade(piramide);
+                });
+            piramide_ = criarPiramideDeProfundidade();
+        }
+        precisaRecriarContextoDeRenderizacao_ = false;
+    }
+
+    // Quadros em execução ainda usam o contexto atual, então
+    // ele vai para a fila de destruição em vez de esperarmos a
+    // GPU. A swapchain continua em `swapChain_` para ser
+    // passada como `oldSwapchain` à nova.
+    void adiarDestruicaoDoContextoDeRenderizacao() {
+        filaDeDestruicao_.adiar(
+            [this, framebuffers = framebuffers_,
+             passe = passeDeRenderizacao_,
+             passeDaPrimeiraFase = passeDaPrimeiraFase_,
+             passeDaSegundaFase = passeDaSegundaFase_,
+             visoes = visoesDasImagensDaSwapchain_,
+             swapchain = swapChain_]() mutable {
+                for (auto&& framebuffer : framebuffers) {
+                    dispositivo_.destroyFramebuffer(
+                        framebuffer);
+                }
+                dispositivo_.destroyRenderPass(passe);
+                dispositivo_.destroyRenderPass(
+                    passeDaPrimeiraFase);
+                dispositivo_.destroyRenderPass(
+                    passeDaSegundaFase);
+                for (auto&& visao : visoes) {
+                    dispositivo_.destroyImageView(visao);
+                }
+                dispositivo_.destroySwapchainKHR(swapchain);
+            });
+
+        framebuffers_.clear();
+        visoesDasImagensDaSwapchain_.clear();
+    }
+
+    void esperarDimensoesValidas() {
+        int largura = 0, altura = 0;
+        glfwGetFramebufferSize(janela_, &largura, &altura);
+        while (largura == 0 || altura == 0) {
+            glfwWaitEvents();
+            glfwGetFramebufferSize(janela_, &largura, &altura);
+        }
+    }
+
+    // As bancadas ficam em bancadas.cpp, e cada uma imprime as
+    // próprias medições.
+    void renderizarQuadroDeBancada();
+    double medirQuadros(size_t numQuadros);
+    void bancadaDeEnvio();
+    void bancadaDeMalha();
+    void bancadaDeImportacao(const std::string& caminho);
+    void bancadaDeOtimizacao(const std::string& caminho);
+    void bancadaDeVertices();
+    void bancadaDePassePrevio();
+    void bancadaDeNiveisDeDetalhe();
+    void bancadaDeMeshlets();
+    void bancadaDaCena();
+    void bancadaDeOclusao();
+    std::vector<Objeto> gradeDeObjetos(uint32_t lado) const;
+    void bancadaDeInstancias();
+    void bancadaDeFrustum();
+    void bancadaDeRecarga();
+    void bancadaDeMipmaps();
+    void bancadaDeTextura();
+    void bancadaDeCarregamento();
+    void atualizarBufferPorChamada(vk::Buffer buffer,
+                                   size_t tamanho,
+                                   const void* dados);
+
+    // Recria o pool de geometria e a pipeline no novo formato,
+    // recarregando o modelo.
+    void trocarFormatoDeVertice(FormatoDeVertice formato) {
+        dispositivo_.waitIdle();
+        // As remoções e compactações adiadas se referem ao pool
+        // antigo.
+        filaDeDestruicao_.destruirTudo();
+        for (auto id : malhasDoModelo_) {
+            poolDeGeometria_.remover(id);
+        }
+        dispositivo_.destroyBuffer(bufferDeIndices_);
+        alocador_.liberar(alocacaoBufferDeIndices_);
+        dispositivo_.destroyBuffer(bufferDeVertices_);
+        alocador_.liberar(alocacaoBufferDeVertices_);
+        destruirPipelines();
+
+        formatoDeVertice_ = formato;
+        criarPoolDeGeometria();
+        malhasDoModelo_ = carregarModelo();
+        removerMalha(malhaSubstituta_);
+        versaoDaCena_++;
+        contextoDeEnvio_.submeter();
+        criarPipeline();
+    }
+
+    void destruir() {
+        // A recarga em andamento termina, e as pipelines dela
+        // são destruídas junto com as outras.
+        if (recarregandoShaders()) {
+            carregador_.esperarTrabalho(*pedidoDeShaders_);
+            concluirCarregamentos();
+            contextoDeEnvio_.esperar();
+        }
+        vigiaDeShaders_.parar();
+        carregador_.destruir();
+        filaDeDestruicao_.destruirTudo();
+        dispositivo_.destroySampler(amostrador_);
+        dispositivo_.destroyImageView(
+            visaoDaTexturaSubstituta_);
+        dispositivo_.destroyImage(texturaSubstituta_);
+        alocador_.liberar(alocacaoTexturaSubstituta_);
+        dispositivo_.destroyImageView(visaoDaTextura_);
+        dispositivo_.destroyImage(textura_);
+        alocador_.liberar(alocacaoTextura_);
+        dispositivo_.destroyBuffer(bufferDaArenaDeUniformes_);
+        alocador_.liberar(alocacaoArenaDeUniformes_);
+        dispositivo_.destroyBuffer(bufferDeIndices_);
+        alocador_.liberar(alocacaoBufferDeIndices_);
+        dispositivo_.destroyBuffer(bufferDeVertices_);
+        alocador_.liberar(alocacaoBufferDeVertices_);
+        for (auto&& descarte : descartes_) {
+            dispositivo_.destroyBuffer(descarte.comandos);
+            alocador_.liberar(descarte.alocacaoDosComandos);
+            dispositivo_.destroyBuffer(descarte.indices);
+            alocador_.liberar(descarte.alocacaoDosIndices);
+        }
+        for (auto&& cena : cenas_) {
+            dispositivo_.destroyBuffer(cena.instancias);
+            alocador_.liberar(cena.alocacaoDasInstancias);
+            destruirBuffersDaCena(cena);
+        }
+        dispositivo_.destroyBuffer(bufferDeMeshlets_);
+        alocador_.liberar(alocacaoBufferDeMeshlets_);
+        dispositivo_.destroyDescriptorPool(poolDeDescritores_);
+        for (auto&& cerca : cercasDeQuadros_) {
+            dispositivo_.destroyFence(cerca);
+        }
+        for (auto&& semaforo :
+             semaforosDeRenderizacaoCompleta_) {
+            dispositivo_.destroySemaphore(semaforo);
+        }
+        for (auto&& semaforo : semaforosDeImagemDisponivel_) {
+            dispositivo_.destroySemaphore(semaforo);
+        }
+        destruirShaders(shaders_);
+        if (suportaCenaNaGpu_) {
+            destruirPiramideDeProfundidade(piramide_);
+        }
+        dispositivo_.destroySampler(amostradorDaPiramide_);
+        dispositivo_.destroyPipelineLayout(layoutDaPiramide_);
+        dispositivo_.destroyDescriptorSetLayout(
+            layoutDoSetDaPiramide_);
+        dispositivo_.destroyPipelineLayout(layoutDoDescarte_);
+        dispositivo_.destroyDescriptorSetLayout(
+            layoutDoSetDeDescarte_);
+        dispositivo_.destroyPipelineLayout(layoutDaPipeline_);
+        dispositivo_.destroyDescriptorSetLayout(
+            layoutDoSetDaCena_);
+        dispositivo_.destroyDescriptorSetLayout(
+            layoutDoSetDeDescritores_);
+        destruirContextoDeRenderizacao();
+        contextoDeEnvio_.destruir();
+        anelDePreparo_.destruir();
+        dispositivo_.destroyBuffer(bufferDoAnelDePreparo_);
+        alocador_.liberar(alocacaoDoAnelDePreparo_);
+        dispositivo_.destroyCommandPool(poolDeComandos_);
+        alocador_.destruir();
+        dispositivo_.destroy();
+        instancia_.destroySurfaceKHR(superficie_);
+        instancia_.destroy();
+        glfwDestroyWindow(janela_);
+        glfwTerminate();
+    }
+
+    void destruirContextoDeRenderizacao() {
+        for (auto&& framebuffer : framebuffers_) {
+            dispositivo_.destroyFramebuffer(framebuffer);
+        }
+        framebuffers_.clear();
+        dispositivo_.destroyRenderPass(passeDeRenderizacao_);
+        dispositivo_.destroyRenderPass(passeDaPrimeiraFase_);
+        dispositivo_.destroyRenderPass(passeDaSegundaFase_);
+        poolDeAlvos_.destruir();
+        for (auto&& visao : visoesDasImagensDaSwapchain_) {
+            dispositivo_.destroyImageView(visao);
+        }
+        visoesDasImagensDaSwapchain_.clear();
+        dispositivo_.destroySwapchainKHR(swapChain_);
+    }
+
+#ifdef NDEBUG
+    const bool kAtivarCamadasDeValidacao = false;
+    const bool kRecarregarShaders = false;
+#else
+    const bool kAtivarCamadasDeValidacao = true;
+    const bool kRecarregarShaders = true;
+#endif
+
+    const std::vector<const char*> kCamadasDeValidacao = {
+        "VK_LAYER_KHRONOS_validation"};
+
+    const std::vector<const char*> kExtensoesDeDispositivo = {
+        VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+
+    const int kLarguraDaJanela = 800;
+    const int kAlturaDaJanela = 600;
+    const char* kTituloDaJanela = "Simples Motor Vulkan";
+    GLFWwindow* janela_;
+    vk::SurfaceKHR superficie_;
+
+    vk::Instance instancia_;
+    vk::PhysicalDevice dispositivoFisico_;
+    vk::Device dispositivo_;
+
+    bool possuiExtensaoDeOrcamento_ = false;
+    bool suportaCompressaoBc_ = false;
+    bool suportaPrimeiraInstanciaIndireta_ = false;
+    bool suportaCenaNaGpu_ = false;
+    bool suportaOclusao_ = false;
+    bool possuiContagemIndireta_ = false;
+    uint32_t maximoDeDesenhosIndiretos_ = 1;
+    PFN_vkCmdDrawIndexedIndirectCountKHR
+        desenharComContagemIndireta_ = nullptr;
+    OrcamentoDeMemoria orcamento_;
+    AlocadorDeMemoria alocador_;
+    FilaDeDestruicao filaDeDestruicao_;
+
+    uint32_t familiaDeGraficos_;
+    vk::Queue filaDeGraficos_;
+    uint32_t familiaDeApresentacao_;
+    vk::Queue filaDeApresentacao_;
+    uint32_t familiaDeTransferencia_;
+    vk::Queue filaDeTransferencia_;
+
+    vk::CommandPool poolDeComandos_;
+
+    const vk::DeviceSize kTamanhoDoAnelDePreparo =
+        16 * 1024 * 1024;
+    vk::Buffer bufferDoAnelDePreparo_;
+    Alocacao alocacaoDoAnelDePreparo_;
+    AnelDePreparo anelDePreparo_;
+    ContextoDeEnvio contextoDeEnvio_;
+
+    bool precisaRecriarContextoDeRenderizacao_ = false;
+
+    vk::Format formatoDaSwapchain_;
+    vk::Extent2D dimensoesDaSwapchain_;
+    vk::SwapchainKHR swapChain_;
+    std::vector<vk::Image> imagensDaSwapchain_;
+    std::vector<vk::ImageView> visoesDasImagensDaSwapchain_;
+
+    PoolDeAlvos poolDeAlvos_;
+    vk::Format formatoDaImagemDeProfundidade_;
+    PoolDeAlvos::IdDeAlvo alvoDeProfundidade_;
+
+    std::vector<vk::Framebuffer> framebuffers_;
+
+    vk::RenderPass passeDeRenderizacao_;
+    vk::RenderPass passeDaPrimeiraFase_;
+    vk::RenderPass passeDaSegundaFase_;
+
+    vk::DescriptorSetLayout layoutDoSetDeDescritores_;
+    vk::PipelineLayout layoutDaPipeline_;
+    // Definida pelo CMake quando ele encontra o glslc, para
+    // que a recarga escreva onde os shaders são lidos. Fora do
+    // modo de depuração não há recarga, e os shaders vêm da
+    // pasta ao lado do executável.
+#if defined(SMV_PASTA_DOS_SHADERS_COMPILADOS) && \
+    !defined(NDEBUG)
+    const std::string kPastaDosShadersCompilados =
+        SMV_PASTA_DOS_SHADERS_COMPILADOS;
+#else
+    const std::string kPastaDosShadersCompilados = "shaders";
+#endif
+    const std::string kCaminhoShaderDeVertices =
+        kPastaDosShadersCompilados + "/shader.vert.spv";
+    const std::string kCaminhoShaderDeFragmento =
+        kPastaDosShadersCompilados + "/shader.frag.spv";
+    const std::string kCaminhoShaderDeProfundidade =
+        kPastaDosShadersCompilados + "/profundidade.vert.spv";
+    bool passePrevioDeProfundidade_ = true;
+
+    vk::DescriptorSetLayout layoutDoSetDeDescarte_;
+    vk::PipelineLayout layoutDoDescarte_;
+    const std::string kCaminhoShaderDeDescarte =
+        kPastaDosShadersCompilados + "/meshlets.comp.spv";
+
+    vk::DescriptorSetLayout layoutDoSetDaCena_;
+    const std::string kCaminhoShaderDaCena =
+        kPastaDosShadersCompilados + "/cena.comp.spv";
+
+    vk::DescriptorSetLayout layoutDoSetDaPiramide_;
+    vk::PipelineLayout layoutDaPiramide_;
+    const std::string kCaminhoShaderDaPiramide =
+        kPastaDosShadersCompilados + "/piramide.comp.spv";
+    vk::Sampler amostradorDaPiramide_;
+
+    // Os módulos e as pipelines em uso.
+    ConjuntoDeShaders shaders_;
+
+    // Definidos pelo CMake quando ele encontra o glslc.
+#if defined(SMV_PASTA_DOS_SHADERS) && !defined(NDEBUG)
+    const std::string kPastaDosShaders = SMV_PASTA_DOS_SHADERS;
+    const std::string kCompiladorDeShaders =
+        SMV_COMPILADOR_DE_SHADERS;
+#else
+    const std::string kPastaDosShaders;
+    const std::string kCompiladorDeShaders;
+#endif
+    VigiaDeArquivos vigiaDeShaders_;
+    bool recargaDeShadersAtiva_ = false;
+    std::vector<std::string> shadersModificados_;
+    std::optional<CarregadorDeRecursos::IdDePedido>
+        pedidoDeShaders_;
+    const size_t kQuadrosEntreRecargas = 20;
+
+    std::vector<vk::CommandBuffer> buffersDeComandos_;
+
+    size_t quadroAtual_ = 0;
+    static const size_t kMaximoQuadrosEmExecucao = 2;
+    std::array<vk::Semaphore, kMaximoQuadrosEmExecucao>
+        semaforosDeImagemDisponivel_;
+    std::array<vk::Semaphore, kMaximoQuadrosEmExecucao>
+        semaforosDeRenderizacaoCompleta_;
+    std::array<vk::Fence, kMaximoQuadrosEmExecucao>
+        cercasDeQuadros_;
+    std::vector<std::optional<vk::Fence>> imagensEmExecucao_;
+
+    // O que passar disso no quadro é desenhado sem descarte.
+    const uint32_t kMaximoDeDesenhosIndiretos = 1024;
+    const uint32_t kCapacidadeDeIndicesCompactados =
+        4 * 1024 * 1024;
+    const vk::DeviceSize kDeslocamentoDosComandos =
+        sizeof(ContadoresDeMeshlets);
+    const uint32_t kTamanhoDoComando =
+        sizeof(vk::DrawIndexedIndirectCommand);
+    std::array<DescarteDoQuadro, kMaximoQuadrosEmExecucao>
+        descartes_;
+    std::vector<Desenho> desenhos_;
+    // Junta os objetos com a mesma malha no mesmo nível num
+    // desenho instanciado.
+    bool instanciarObjetos_ = true;
+    std::vector<Instancia> instancias_;
+    DescarteDeFrustum descarteDeObjetos_;
+    uint64_t versaoDoDescarte_ = 0;
+    std::vector<uint32_t> objetosVisiveisNaCpu_;
+    bool descartarObjetos_ = true;
+    std::vector<std::vector<Instancia>> gruposDeInstancias_;
+    bool usarMeshlets_ = true;
+    size_t meshletsVisiveis_ = 0;
+
+    // Com a cena na GPU, os objetos são descartados e os níveis
+    // escolhidos num passe de computação, e o descarte de
+    // meshlets não é usado.
+    bool desenharCenaNaGpu_ = false;
+    const uint32_t kCapacidadeInicialDaCena = 1024;
+    const uint32_t kCapacidadeDeMalhasDaCena = 1024;
+    // O local_size_x de shaders/cena.comp.
+    const uint32_t kObjetosPorGrupoDaCena = 64;
+    std::array<CenaDoQuadro, kMaximoQuadrosEmExecucao> cenas_;
+    // Muda com os objetos ou as malhas do modelo.
+    uint64_t versaoDaCena_ = 1;
+    size_t objetosVisiveis_ = 0;
+    double msDeGravacao_ = 0.0;
+
+    // O descarte por oclusão divide o quadro em duas fases,
+    // com a pirâmide construída entre elas.
+    bool ocluirObjetos_ = true;
+    PiramideDeProfundidade piramide_;
+    // Muda quando a pirâmide é recriada com a tela.
+    uint64_t versaoDaPiramide_ = 0;
+    // Falsa até a primeira pirâmide ser construída.
+    bool piramideValida_ = false;
+    // A pirâmide recém-criada ainda não passou para o layout
+    // geral.
+    bool piramideSemLayout_ = false;
+    glm::mat4 modeloDaCenaDaPiramide_{1.0f};
+    glm::mat4 visaoProjecaoDaPiramide_{1.0f};
+    // O local_size de shaders/piramide.comp, em x e em y.
+    const uint32_t kTexelsPorGrupoDaPiramide = 8;
+    size_t objetosOclusos_ = 0;
+
+    vk::DescriptorPool poolDeDescritores_;
+    vk::DescriptorSet setDeDescritores_;
+    vk::DescriptorSet setDaTexturaSubstituta_;
+
+    CarregadorDeRecursos carregador_;
+    const unsigned kThreadsDeCarregamento = 2;
+
+    const std::string kCaminhoDoModelo =
+        "res/pequena_nozinha.obj";
+    const std::string kCaminhoDaMalhaCozida =
+        "res/pequena_nozinha.malha";
+
+    const uint32_t kCapacidadeDeVerticesDoPool = 256 * 1024;
+    const vk::DeviceSize kTamanhoDoBufferDeIndicesDoPool =
+        4 * 1024 * 1024;
+    // Divide as malhas que precisariam de índices de 32 bits
+    // em submalhas com índices de 16 bits, trocando vértices
+    // repetidos nas bordas por metade da banda de índices.
+    const bool kDividirMalhasGrandes = false;
+    vk::Buffer bufferDeVertices_;
+    Alocacao alocacaoBufferDeVertices_;
+    vk::Buffer bufferDeIndices_;
+    Alocacao alocacaoBufferDeIndices_;
+    PoolDeGeometria poolDeGeometria_;
+    std::vector<PoolDeGeometria::IdDeMalha> malhasDoModelo_;
+    PoolDeGeometria::IdDeMalha malhaSubstituta_;
+    const float kLadoDaMalhaSubstituta = 0.5f;
+    FormatoDeVertice formatoDeVertice_ =
+        FormatoDeVertice::eCompacto;
+    // Indexadas pelo id da malha no pool.
+    std::vector<Dequantizacao> dequantizacaoDasMalhas_;
+    std::vector<std::vector<NivelDaMalha>> niveisDasMalhas_;
+    std::vector<glm::vec4> esferasDasMalhas_;
+    std::vector<uint32_t> primeiroMeshletDasMalhas_;
+    const uint32_t kCapacidadeDeMeshlets = 64 * 1024;
+    vk::Buffer bufferDeMeshlets_;
+    Alocacao alocacaoBufferDeMeshlets_;
+    std::optional<AlocadorDeIntervalos> meshletsDoPool_;
+    // O modelo é desenhado uma vez em cada objeto.
+    std::vector<Objeto> objetos_ = {Objeto{glm::vec3(0.0f)}};
+    bool usarNiveisDeDetalhe_ = true;
+    const float kErroDosNiveisEmPixels = 1.0f;
+    const uint32_t kLadoDaGradeDeObjetos = 16;
+    size_t triangulosDesenhados_ = 0;
+    uint32_t instanciasPorDesenho_ = 1;
+    const uint32_t kInstanciasNaBancadaDeVertices = 256;
+    const float kEscalaNaBancadaDeMipmaps = 1.0f / 16.0f;
+    const size_t kEsferasNaBancadaDeFrustum = 1 << 22;
+
+    PushConstants pushConstants_;
+    OBU obu_;
+    const float kPlanoProximo = 0.1f;
+    const vk::DeviceSize kTamanhoDaArenaPorQuadro = 64 * 1024;
+    vk::Buffer bufferDaArenaDeUniformes_;
+    Alocacao alocacaoArenaDeUniformes_;
+    ArenaDeUniformes arenaDeUniformes_;
+
+    std::string kCaminhoDaTextura = "res/pequena_nozinha.png";
+    const std::string kCaminhoDaTexturaCozida =
+        "res/pequena_nozinha.ktx2";
+    vk::Image textura_;
+    vk::ImageView visaoDaTextura_;
+    uint32_t numNiveisDaTextura_ = 1;
+    vk::Sampler amostrador_;
+    Alocacao alocacaoTextura_;
+    OrcamentoDeMemoria::IdDeRecurso idDaTextura_;
+    CarregadorDeRecursos::IdDePedido pedidoDaTextura_ = 0;
+    const uint32_t kLadoDaTexturaSubstituta = 64;
+    const uint32_t kLadoDaCasaDaTexturaSubstituta = 8;
+    vk::Image texturaSubstituta_;
+    vk::ImageView visaoDaTexturaSubstituta_;
+    Alocacao alocacaoTexturaSubstituta_;
+};
+}  // namespace smv
+
+#endif
@@ -0,0 +1,44 @@
+#include "arena_de_uniformes.hpp"
+
+#include "alocador_de_intervalos.hpp"
+
+namespace smv {
+void ArenaDeUniformes::iniciar(vk::Buffer buffer,
+                               void* mapeamento,
+                               vk::DeviceSize tamanhoPorQuadro,
+                               vk::DeviceSize alinhamento) {
+    buffer_ = buffer;
+    mapeamento_ = static_cast<char*>(mapeamento);
+    alinhamento_ = alinhamento;
+    tamanhoPorQuadro_ =
+        alinharParaCima(tamanhoPorQuadro, alinhamento);
+}
+
+vk::DeviceSize ArenaDeUniformes::tamanhoTotal(
+    vk::DeviceSize tamanhoPorQuadro,
+    vk::DeviceSize alinhamento,
+    size_t numQuadros) {
+    return alinharParaCima(tamanhoPorQuadro, alinhamento) *
+           numQuadros;
+}
+
+void ArenaDeUniformes::comecarQuadro(size_t quadro) {
+    inicioDoQuadro_ = tamanhoPorQuadro_ * quadro;
+    cursor_ = 0;
+}
+
+void* ArenaDeUniformes::reservar(vk::DeviceSize tamanho) {
+    vk::DeviceSize deslocamento =
+        alinharParaCima(cursor_, alinhamento_);
+    if (deslocamento + tamanho > tamanhoPorQuadro_) {
+        throw std::runtime_error(
+            "A partição do quadro na arena de uniformes está "
+            "cheia.");
+    }
+
+    cursor_ = deslocamento + tamanho;
+    ultimoDeslocamento_ =
+        static_cast<uint32_t>(inicioDoQuadro_ + deslocamento);
+    return mapeamento_ + ultimoDeslocamento_;
+}
+}  // namespace smv
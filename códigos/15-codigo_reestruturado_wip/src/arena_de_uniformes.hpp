@@ -0,0 +1,55 @@
+#ifndef SMV_ARENA_DE_UNIFORMES_HPP
+#define SMV_ARENA_DE_UNIFORMES_HPP
+
+#include <cstring>
+#include <stdexcept>
+
+#include <vulkan/vulkan.hpp>
+
+namespace smv {
+// Buffer de uniformes visível pelo hospedeiro e mapeado
+// permanentemente, dividido em uma partição por quadro em
+// execução.
+//
+// Cada quadro escreve seus dados direto na própria partição,
+// que a GPU não está lendo desde que a cerca do quadro tenha
+// sido esperada, e os liga com descritores
+// eUniformBufferDynamic usando o deslocamento devolvido.
+class ArenaDeUniformes {
+  public:
+    void iniciar(vk::Buffer buffer,
+                 void* mapeamento,
+                 vk::DeviceSize tamanhoPorQuadro,
+                 vk::DeviceSize alinhamento);
+
+    static vk::DeviceSize tamanhoTotal(
+        vk::DeviceSize tamanhoPorQuadro,
+        vk::DeviceSize alinhamento,
+        size_t numQuadros);
+
+    void comecarQuadro(size_t quadro);
+
+    template <typename T>
+    uint32_t escrever(const T& dados) {
+        void* destino = reservar(sizeof(T));
+        std::memcpy(destino, &dados, sizeof(T));
+        return ultimoDeslocamento_;
+    }
+
+    vk::Buffer buffer() const { return buffer_; }
+
+  private:
+    void* reservar(vk::DeviceSize tamanho);
+
+    vk::Buffer buffer_;
+    char* mapeamento_ = nullptr;
+    vk::DeviceSize tamanhoPorQuadro_ = 0;
+    vk::DeviceSize alinhamento_ = 1;
+
+    vk::DeviceSize inicioDoQuadro_ = 0;
+    vk::DeviceSize cursor_ = 0;
+    uint32_t ultimoDeslocamento_ = 0;
+};
+}  // namespace smv
+
+#endif
@@ -0,0 +1,82 @@
+#include "arquivo_mapeado.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace smv {
+bool ArquivoMapeado::abrir(const std::string& caminho) {
+    fechar();
+
+#ifdef _WIN32
+    arquivo_ = CreateFileA(caminho.c_str(), GENERIC_READ,
+                           FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (arquivo_ == INVALID_HANDLE_VALUE) {
+        arquivo_ = nullptr;
+        return false;
+    }
+    LARGE_INTEGER tamanho;
+    GetFileSizeEx(arquivo_, &tamanho);
+    tamanho_ = static_cast<size_t>(tamanho.QuadPart);
+    mapeamentoDoArquivo_ = CreateFileMappingA(
+        arquivo_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapeamentoDoArquivo_ != nullptr) {
+        dados_ = static_cast<const char*>(MapViewOfFile(
+            mapeamentoDoArquivo_, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    int descritor = open(caminho.c_str(), O_RDONLY);
+    if (descritor < 0) {
+        return false;
+    }
+    struct stat informacoes;
+    fstat(descritor, &informacoes);
+    tamanho_ = static_cast<size_t>(informacoes.st_size);
+    if (tamanho_ > 0) {
+        void* mapeamento = mmap(nullptr, tamanho_, PROT_READ,
+                                MAP_PRIVATE, descritor, 0);
+        if (mapeamento != MAP_FAILED) {
+            dados_ = static_cast<const char*>(mapeamento);
+        }
+    }
+    // O mapeamento continua válido sem o descritor.
+    close(descritor);
+#endif
+
+    if (dados_ == nullptr) {
+        fechar();
+        return false;
+    }
+    return true;
+}
+
+void ArquivoMapeado::fechar() {
+#ifdef _WIN32
+    if (dados_ != nullptr) {
+        UnmapViewOfFile(dados_);
+    }
+    if (mapeamentoDoArquivo_ != nullptr) {
+        CloseHandle(mapeamentoDoArquivo_);
+    }
+    if (arquivo_ != nullptr) {
+        CloseHandle(arquivo_);
+    }
+    mapeamentoDoArquivo_ = nullptr;
+    arquivo_ = nullptr;
+#else
+    if (dados_ != nullptr) {
+        munmap(const_cast<char*>(dados_), tamanho_);
+    }
+#endif
+    dados_ = nullptr;
+    tamanho_ = 0;
+}
+}  // namespace smv
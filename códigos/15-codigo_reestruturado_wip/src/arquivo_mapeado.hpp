@@ -0,0 +1,35 @@
+#ifndef SMV_ARQUIVO_MAPEADO_HPP
+#define SMV_ARQUIVO_MAPEADO_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace smv {
+// Arquivo mapeado em memória só para leitura, com mmap ou
+// MapViewOfFile no Windows.
+class ArquivoMapeado {
+  public:
+    ArquivoMapeado() = default;
+    ArquivoMapeado(const ArquivoMapeado&) = delete;
+    ArquivoMapeado& operator=(const ArquivoMapeado&) = delete;
+    ~ArquivoMapeado() { fechar(); }
+
+    // Retorna falso se o arquivo não existir ou não puder ser
+    // mapeado.
+    bool abrir(const std::string& caminho);
+    void fechar();
+
+    const char* dados() const { return dados_; }
+    size_t tamanho() const { return tamanho_; }
+
+  private:
+    const char* dados_ = nullptr;
+    size_t tamanho_ = 0;
+#ifdef _WIN32
+    void* arquivo_ = nullptr;
+    void* mapeamentoDoArquivo_ = nullptr;
+#endif
+};
+}  // namespace smv
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SMV_BANCADA_HPP
+#define SMV_BANCADA_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace smv {
+// Tempo médio, em milissegundos, de uma execução de `funcao`
+// ao longo de `repeticoes` execuções.
+template <typename F>
+double medirMilissegundos(size_t repeticoes, F&& funcao) {
+    auto inicio = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repeticoes; i++) {
+        funcao();
+    }
+    auto fim = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double, std::milli> decorrido =
+        fim - inicio;
+    return decorrido.count() / static_cast<double>(repeticoes);
+}
+
+inline void imprimirMedicao(const std::string& nome,
+                            double milissegundos) {
+    std::cout << std::left << std::setw(40) << nome
+              << std::right << std::setw(12) << std::fixed
+              << std::setprecision(3) << milissegundos << " ms"
+              << std::endl;
+}
+
+inline void imprimirVazao(const std::string& nome,
+                          double milissegundos,
+                          size_t bytes) {
+    double mibPorSegundo = static_cast<double>(bytes) /
+                           (1024.0 * 1024.0) /
+                           (milissegundos / 1000.0);
+    std::cout << std::left << std::setw(40) << nome
+              << std::right << std::setw(12) << std::fixed
+              << std::setprecision(3) << milissegundos << " ms"
+              << std::setw(12) << std::setprecision(1)
+              << mibPorSegundo << " MiB/s" << std::endl;
+}
+}  // namespace smv
+
+#endif
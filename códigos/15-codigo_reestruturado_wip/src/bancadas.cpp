@@ -0,0 +1,804 @@
+#include "app.hpp"
+
+#include "bancada.hpp"
+
+namespace smv {
+// Um quadro como os do laço principal, com a recriação do
+// contexto quando a janela muda.
+void App::renderizarQuadroDeBancada() {
+    glfwPollEvents();
+    renderizar();
+    if (precisaRecriarContextoDeRenderizacao_) {
+        recriarContextoDeRenderizacao();
+    }
+}
+
+double App::medirQuadros(size_t numQuadros) {
+    return medirMilissegundos(
+        numQuadros, [this]() { renderizarQuadroDeBancada(); });
+}
+
+void App::bancadaDeEnvio() {
+    const std::array<size_t, 4> tamanhos = {
+        4 * 1024, 256 * 1024, 4 * 1024 * 1024,
+        64 * 1024 * 1024};
+
+    for (size_t tamanho : tamanhos) {
+        std::vector<char> dados(tamanho, 1);
+        vk::Buffer destino;
+        Alocacao alocacaoDestino;
+        criarBuffer(
+            vk::BufferUsageFlagBits::eTransferDst, tamanho,
+            vk::MemoryPropertyFlagBits::eDeviceLocal,
+            destino, alocacaoDestino);
+
+        size_t repeticoes = std::clamp<size_t>(
+            (256 * 1024 * 1024) / tamanho, 4, 256);
+        double msPorChamada =
+            medirMilissegundos(repeticoes, [&]() {
+                atualizarBufferPorChamada(destino, tamanho,
+                                          dados.data());
+            });
+        double msAnel =
+            medirMilissegundos(repeticoes, [&]() {
+                atualizarBuffer(destino, tamanho,
+                                dados.data());
+                contextoDeEnvio_.submeter();
+                contextoDeEnvio_.esperar();
+            });
+
+        std::string kib = std::to_string(tamanho / 1024);
+        imprimirVazao("preparo por chamada " + kib + " KiB",
+                      msPorChamada, tamanho);
+        imprimirVazao("anel de preparo " + kib + " KiB",
+                      msAnel, tamanho);
+
+        dispositivo_.destroyBuffer(destino);
+        alocador_.liberar(alocacaoDestino);
+    }
+
+    // Muitos envios pequenos, como no carregamento de
+    // vários recursos: uma ida e volta por envio contra um
+    // único lote.
+    const size_t kNumEnvios = 256;
+    const size_t kTamanhoDoEnvio = 16 * 1024;
+    std::vector<char> dados(kTamanhoDoEnvio, 1);
+    std::vector<vk::Buffer> destinos(kNumEnvios);
+    std::vector<Alocacao> alocacoes(kNumEnvios);
+    for (size_t i = 0; i < kNumEnvios; i++) {
+        criarBuffer(
+            vk::BufferUsageFlagBits::eTransferDst,
+            kTamanhoDoEnvio,
+            vk::MemoryPropertyFlagBits::eDeviceLocal,
+            destinos[i], alocacoes[i]);
+    }
+
+    double msPorChamada = medirMilissegundos(4, [&]() {
+        for (auto&& destino : destinos) {
+            atualizarBufferPorChamada(
+                destino, kTamanhoDoEnvio, dados.data());
+        }
+    });
+    double msEmLote = medirMilissegundos(4, [&]() {
+        for (auto&& destino : destinos) {
+            atualizarBuffer(destino, kTamanhoDoEnvio,
+                            dados.data());
+        }
+        contextoDeEnvio_.submeter();
+        contextoDeEnvio_.esperar();
+    });
+    imprimirVazao("256 envios de 16 KiB por chamada",
+                  msPorChamada,
+                  kNumEnvios * kTamanhoDoEnvio);
+    imprimirVazao("256 envios de 16 KiB em lote",
+                  msEmLote, kNumEnvios * kTamanhoDoEnvio);
+
+    for (size_t i = 0; i < kNumEnvios; i++) {
+        dispositivo_.destroyBuffer(destinos[i]);
+        alocador_.liberar(alocacoes[i]);
+    }
+}
+
+// Tempo para ter a malha na memória, pronta para ser
+// copiada para o anel de preparo. A primeira carga de cada
+// formato é medida à parte, já que as seguintes encontram o
+// arquivo no cache de páginas do sistema.
+void App::bancadaDeMalha() {
+    auto carregarObj = [this]() {
+        std::vector<Vertice> vertices;
+        std::vector<uint32_t> indices;
+        importarObj(kCaminhoDoModelo, vertices, indices);
+    };
+    // Lê todos os bytes, como a cópia para o anel faria.
+    auto carregarCozida = [this]() {
+        MalhaCozida malha;
+        if (!malha.abrir(kCaminhoDaMalhaCozida)) {
+            throw std::runtime_error(
+                "A malha cozida não foi encontrada.");
+        }
+        const auto& cabecalho = malha.cabecalho();
+        std::vector<Vertice> vertices(
+            malha.vertices(),
+            malha.vertices() + cabecalho.numVertices);
+        auto indices =
+            static_cast<const char*>(malha.indices());
+        uint64_t tamanhoDosIndices =
+            uint64_t{cabecalho.numIndices} *
+            cabecalho.tamanhoDoIndice;
+        std::vector<char> bytesDeIndices(
+            indices, indices + tamanhoDosIndices);
+    };
+
+    imprimirMedicao("malha cozida, primeira carga",
+                    medirMilissegundos(1, carregarCozida));
+    imprimirMedicao("OBJ, primeira carga",
+                    medirMilissegundos(1, carregarObj));
+    imprimirMedicao("malha cozida",
+                    medirMilissegundos(20, carregarCozida));
+    imprimirMedicao("OBJ",
+                    medirMilissegundos(20, carregarObj));
+}
+
+// Importa o OBJ com cada vez mais threads, conferindo que
+// o resultado não muda. Modelos grandes podem ser passados
+// com `--bancada importacao <arquivo.obj>`.
+void App::bancadaDeImportacao(const std::string& caminho) {
+    std::vector<Vertice> verticesEmSerie;
+    std::vector<uint32_t> indicesEmSerie;
+    importarObj(caminho, verticesEmSerie, indicesEmSerie,
+                1);
+
+    unsigned maximoDeThreads =
+        std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> numsDeThreads;
+    for (unsigned n = 1; n < maximoDeThreads; n *= 2) {
+        numsDeThreads.push_back(n);
+    }
+    numsDeThreads.push_back(maximoDeThreads);
+
+    for (unsigned numThreads : numsDeThreads) {
+        std::vector<Vertice> vertices;
+        std::vector<uint32_t> indices;
+        double ms = medirMilissegundos(5, [&]() {
+            vertices.clear();
+            indices.clear();
+            importarObj(caminho, vertices, indices,
+                        numThreads);
+        });
+        if (vertices != verticesEmSerie ||
+            indices != indicesEmSerie) {
+            throw std::runtime_error(
+                "A importação com " +
+                std::to_string(numThreads) +
+                " threads difere da serial.");
+        }
+        imprimirMedicao("importação, " +
+                            std::to_string(numThreads) +
+                            " threads",
+                        ms);
+    }
+}
+
+// Mede cada passo da otimização de malhas e o efeito dele
+// no cache de vértices.
+void App::bancadaDeOtimizacao(const std::string& caminho) {
+    std::vector<Vertice> vertices;
+    std::vector<uint32_t> indices;
+    importarObj(caminho, vertices, indices);
+    imprimirEstatisticasDeCache(
+        "ordem do OBJ",
+        analisarCacheDeVertices(indices, vertices.size()));
+
+    double ms = medirMilissegundos(1, [&]() {
+        indices = otimizarCacheDeVertices(
+            indices, vertices.size());
+    });
+    imprimirMedicao("otimização do cache", ms);
+    imprimirEstatisticasDeCache(
+        "cache otimizado",
+        analisarCacheDeVertices(indices, vertices.size()));
+
+    ms = medirMilissegundos(1, [&]() {
+        indices = otimizarSobreposicao(indices, vertices);
+    });
+    imprimirMedicao("otimização da sobreposição", ms);
+    imprimirEstatisticasDeCache(
+        "sobreposição otimizada",
+        analisarCacheDeVertices(indices, vertices.size()));
+
+    ms = medirMilissegundos(1, [&]() {
+        otimizarBuscaDeVertices(vertices, indices);
+    });
+    imprimirMedicao("otimização da busca", ms);
+}
+
+// Renderiza o modelo com cada formato de vértice, com
+// muitas instâncias por desenho para que a busca e o
+// processamento dos vértices dominem o tempo do quadro.
+void App::bancadaDeVertices() {
+    carregarRecursos();
+    esperarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+    instanciasPorDesenho_ = kInstanciasNaBancadaDeVertices;
+
+    for (auto formato : {FormatoDeVertice::eCompleto,
+                         FormatoDeVertice::eCompacto}) {
+        trocarFormatoDeVertice(formato);
+
+        medirQuadros(10);
+        double ms = medirQuadros(100);
+        dispositivo_.waitIdle();
+
+        size_t bytesDeVertices =
+            poolDeGeometria_.estatisticasDeVertices()
+                .bytesUsados *
+            tamanhoDoVertice(formato);
+        std::string nome =
+            formato == FormatoDeVertice::eCompacto
+                ? "vértices compactos"
+                : "vértices completos";
+        std::cout << nome << ": " << bytesDeVertices
+                  << " bytes de vértices" << std::endl;
+        // Vazão dos vértices lidos pelas instâncias.
+        imprimirVazao(nome + ", por quadro", ms,
+                      bytesDeVertices *
+                          instanciasPorDesenho_);
+    }
+}
+
+// Renderiza o modelo com e sem o passe prévio de
+// profundidade, que lê só o fluxo de posições de cada
+// instância.
+void App::bancadaDePassePrevio() {
+    carregarRecursos();
+    esperarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+    instanciasPorDesenho_ = kInstanciasNaBancadaDeVertices;
+
+    size_t numVertices =
+        poolDeGeometria_.estatisticasDeVertices()
+            .bytesUsados;
+    size_t bytesDePosicoes =
+        numVertices *
+        tamanhosDosFluxos(
+            formatoDeVertice_)[kFluxoDePosicao];
+    std::cout << "passe prévio: " << bytesDePosicoes
+              << " bytes de vértices por instância, contra "
+              << numVertices *
+                     tamanhoDoVertice(formatoDeVertice_)
+              << " com os atributos intercalados"
+              << std::endl;
+
+    for (bool passePrevio : {false, true}) {
+        dispositivo_.waitIdle();
+        destruirPipelines();
+        passePrevioDeProfundidade_ = passePrevio;
+        criarPipeline();
+
+        medirQuadros(10);
+        imprimirMedicao(
+            passePrevio ? "com passe prévio"
+                        : "sem passe prévio",
+            medirQuadros(100));
+    }
+}
+
+// Renderiza uma grade de objetos que se afasta da câmera,
+// só com o nível completo e depois com os níveis de
+// detalhe, e conta os triângulos desenhados.
+void App::bancadaDeNiveisDeDetalhe() {
+    carregarRecursos();
+    esperarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+
+    for (auto id : malhasDoModelo_) {
+        for (const auto& nivel : niveisDasMalhas_[id]) {
+            std::cout << "nível com "
+                      << nivel.numIndices / 3
+                      << " triângulos, erro " << nivel.erro
+                      << std::endl;
+        }
+    }
+
+    objetos_ = gradeDeObjetos(kLadoDaGradeDeObjetos);
+    versaoDaCena_++;
+
+    for (bool usarNiveis : {false, true}) {
+        usarNiveisDeDetalhe_ = usarNiveis;
+        medirQuadros(10);
+        triangulosDesenhados_ = 0;
+        double ms = medirQuadros(100);
+        imprimirMedicao(usarNiveis ? "com níveis de detalhe"
+                                   : "só o nível completo",
+                        ms);
+        std::cout << "    " << triangulosDesenhados_ / 100
+                  << " triângulos por quadro" << std::endl;
+    }
+}
+
+// Renderiza a grade de objetos, com os níveis de detalhe,
+// sem e com o descarte de meshlets, e conta os meshlets e
+// os triângulos desenhados.
+void App::bancadaDeMeshlets() {
+    carregarRecursos();
+    esperarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+
+    for (auto id : malhasDoModelo_) {
+        for (const auto& nivel : niveisDasMalhas_[id]) {
+            std::cout << "nível com "
+                      << nivel.numIndices / 3
+                      << " triângulos em "
+                      << nivel.numMeshlets << " meshlets"
+                      << std::endl;
+        }
+    }
+
+    objetos_ = gradeDeObjetos(kLadoDaGradeDeObjetos);
+    versaoDaCena_++;
+
+    for (bool usar : {false, true}) {
+        usarMeshlets_ = usar;
+        medirQuadros(10);
+        // Os contadores chegam com alguns quadros de
+        // atraso, que se compensam entre o começo e o fim.
+        triangulosDesenhados_ = 0;
+        meshletsVisiveis_ = 0;
+        double ms = medirQuadros(100);
+        imprimirMedicao(usar ? "com descarte de meshlets"
+                             : "sem descarte de meshlets",
+                        ms);
+        std::cout << "    " << triangulosDesenhados_ / 100
+                  << " triângulos por quadro";
+        if (usar) {
+            std::cout << ", " << meshletsVisiveis_ / 100
+                      << " meshlets visíveis";
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Aumenta a grade de objetos de 16 a cerca de 100 mil e
+// compara, com a cena escolhida pela CPU e pela GPU, o
+// tempo de gravar os comandos e o do quadro inteiro.
+void App::bancadaDaCena() {
+    if (!suportaCenaNaGpu_) {
+        throw std::runtime_error(
+            "O dispositivo não desenha a cena pela GPU.");
+    }
+    carregarRecursos();
+    esperarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+    std::cout << "contagem indireta: "
+              << (possuiContagemIndireta_ ? "sim" : "não")
+              << std::endl;
+
+    for (uint32_t lado : {4u, 10u, 32u, 100u, 317u}) {
+        objetos_ = gradeDeObjetos(lado);
+        versaoDaCena_++;
+        std::cout << objetos_.size() *
+                         malhasDoModelo_.size()
+                  << " objetos" << std::endl;
+        for (bool naGpu : {false, true}) {
+            desenharCenaNaGpu_ = naGpu;
+            medirQuadros(10);
+            msDeGravacao_ = 0.0;
+            triangulosDesenhados_ = 0;
+            objetosVisiveis_ = 0;
+            double ms = medirQuadros(100);
+            imprimirMedicao(naGpu ? "  quadro, cena na GPU"
+                                  : "  quadro, cena na CPU",
+                            ms);
+            imprimirMedicao("    gravação dos comandos",
+                            msDeGravacao_ / 100.0);
+            std::cout << "    "
+                      << triangulosDesenhados_ / 100
+                      << " triângulos por quadro";
+            if (naGpu) {
+                std::cout << ", " << objetosVisiveis_ / 100
+                          << " objetos visíveis";
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
+// Com a cena na GPU, compara o quadro sem e com o descarte
+// por oclusão nas grades maiores, em que as linhas da
+// frente escondem boa parte das do fundo.
+void App::bancadaDeOclusao() {
+    if (!suportaOclusao_) {
+        throw std::runtime_error(
+            "O dispositivo não descarta a cena por "
+            "oclusão.");
+    }
+    carregarRecursos();
+    esperarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+
+    desenharCenaNaGpu_ = true;
+    for (uint32_t lado : {100u, 317u}) {
+        objetos_ = gradeDeObjetos(lado);
+        versaoDaCena_++;
+        std::cout << objetos_.size() *
+                         malhasDoModelo_.size()
+                  << " objetos" << std::endl;
+        for (bool ocluir : {false, true}) {
+            ocluirObjetos_ = ocluir;
+            piramideValida_ = false;
+            medirQuadros(10);
+            msDeGravacao_ = 0.0;
+            triangulosDesenhados_ = 0;
+            objetosVisiveis_ = 0;
+            objetosOclusos_ = 0;
+            double ms = medirQuadros(100);
+            imprimirMedicao(ocluir
+                                ? "  quadro, com oclusão"
+                                : "  quadro, sem oclusão",
+                            ms);
+            imprimirMedicao("    gravação dos comandos",
+                            msDeGravacao_ / 100.0);
+            std::cout << "    " << objetosVisiveis_ / 100
+                      << " objetos visíveis, "
+                      << objetosOclusos_ / 100
+                      << " oclusos, "
+                      << triangulosDesenhados_ / 100
+                      << " triângulos por quadro"
+                      << std::endl;
+        }
+    }
+}
+
+// As linhas vão de perto até o fundo, e as colunas abrem
+// com a distância para ficar na tela. A tonalidade muda
+// pela grade.
+std::vector<Objeto> App::gradeDeObjetos(uint32_t lado) const {
+    std::vector<Objeto> objetos;
+    float ultimo = static_cast<float>(lado - 1);
+    for (uint32_t linha = 0; linha < lado; linha++) {
+        float z = 1.0f + 2.0f * static_cast<float>(linha);
+        for (uint32_t coluna = 0; coluna < lado; coluna++) {
+            float u = static_cast<float>(coluna) / ultimo;
+            float v = static_cast<float>(linha) / ultimo;
+            glm::vec4 tonalidade(0.5f + 0.5f * u, 1.0f,
+                                 0.5f + 0.5f * v, 1.0f);
+            objetos.push_back(
+                {{(u - 0.5f) * z, 0.0f, z}, tonalidade, 0});
+        }
+    }
+    return objetos;
+}
+
+// Desenha a grade com 10 e 100 mil objetos pelo caminho da
+// CPU, com um desenho por objeto e com os objetos
+// instanciados, e compara o quadro e a gravação.
+void App::bancadaDeInstancias() {
+    carregarRecursos();
+    esperarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+
+    for (uint32_t lado : {100u, 317u}) {
+        objetos_ = gradeDeObjetos(lado);
+        versaoDaCena_++;
+        std::cout << objetos_.size() << " objetos"
+                  << std::endl;
+        for (bool instanciar : {false, true}) {
+            instanciarObjetos_ = instanciar;
+            medirQuadros(10);
+            msDeGravacao_ = 0.0;
+            triangulosDesenhados_ = 0;
+            double ms = medirQuadros(100);
+            imprimirMedicao(instanciar
+                                ? "  quadro, instanciado"
+                                : "  quadro, um por objeto",
+                            ms);
+            imprimirMedicao("    gravação dos comandos",
+                            msDeGravacao_ / 100.0);
+            std::cout << "    " << desenhos_.size()
+                      << " desenhos, "
+                      << triangulosDesenhados_ / 100
+                      << " triângulos por quadro"
+                      << std::endl;
+        }
+    }
+}
+
+// Descarta kEsferasNaBancadaDeFrustum esferas aleatórias em
+// volta da câmera com cada conjunto de instruções que o
+// processador tem e depois desenha a grade de 100 mil
+// objetos pela CPU sem e com o descarte pelo frustum.
+void App::bancadaDeFrustum() {
+    carregarRecursos();
+    esperarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+
+    glm::vec3 camera(glm::inverse(obu_.visao)[3]);
+    std::mt19937 gerador(42);
+    std::uniform_real_distribution<float> posicao(-50.0f,
+                                                  50.0f);
+    std::uniform_real_distribution<float> raio(0.1f, 1.0f);
+    DescarteDeFrustum descarte;
+    for (size_t i = 0; i < kEsferasNaBancadaDeFrustum;
+         i++) {
+        glm::vec3 centro(posicao(gerador), posicao(gerador),
+                         posicao(gerador));
+        descarte.adicionar(
+            glm::vec4(camera + centro, raio(gerador)));
+    }
+    auto planos = planosDoFrustum(obu_.projecao * obu_.visao);
+    std::vector<uint32_t> visiveis;
+
+    const std::array<
+        std::pair<ConjuntoDeInstrucoes, const char*>, 3>
+        conjuntos = {
+            {{ConjuntoDeInstrucoes::eEscalar, "escalar"},
+             {ConjuntoDeInstrucoes::eSse, "SSE"},
+             {ConjuntoDeInstrucoes::eAvx2, "AVX2"}}};
+    std::cout << kEsferasNaBancadaDeFrustum << " esferas"
+              << std::endl;
+    for (const auto& par : conjuntos) {
+        ConjuntoDeInstrucoes conjunto = par.first;
+        std::string nome = par.second;
+        if (!DescarteDeFrustum::suporta(conjunto)) {
+            std::cout << "  " << nome << " indisponível"
+                      << std::endl;
+            continue;
+        }
+        size_t numVisiveis = 0;
+        auto descartar = [&]() {
+            numVisiveis = descarte.descartar(
+                planos, visiveis, conjunto);
+        };
+        medirMilissegundos(2, descartar);
+        double ms = medirMilissegundos(20, descartar);
+        imprimirMedicao("  " + nome, ms);
+        std::cout << "    "
+                  << static_cast<double>(
+                         kEsferasNaBancadaDeFrustum) /
+                         ms
+                  << " objetos por ms, " << numVisiveis
+                  << " visíveis" << std::endl;
+    }
+
+    objetos_ = gradeDeObjetos(317);
+    versaoDaCena_++;
+    std::cout << objetos_.size() << " objetos" << std::endl;
+    for (bool descartar : {false, true}) {
+        descartarObjetos_ = descartar;
+        medirQuadros(10);
+        msDeGravacao_ = 0.0;
+        triangulosDesenhados_ = 0;
+        objetosVisiveis_ = 0;
+        double ms = medirQuadros(100);
+        imprimirMedicao(descartar
+                            ? "  quadro, com descarte"
+                            : "  quadro, sem descarte",
+                        ms);
+        imprimirMedicao("    gravação dos comandos",
+                        msDeGravacao_ / 100.0);
+        std::cout << "    " << objetosVisiveis_ / 100
+                  << " objetos visíveis, "
+                  << triangulosDesenhados_ / 100
+                  << " triângulos por quadro" << std::endl;
+    }
+}
+
+// Recarrega todos os shaders a cada kQuadrosEntreRecargas
+// quadros, primeiro na thread principal e depois pelo
+// carregador, e compara o quadro médio e o pior quadro.
+void App::bancadaDeRecarga() {
+    if (!recargaDeShadersAtiva_) {
+        throw std::runtime_error(
+            "A recarga de shaders não está disponível.");
+    }
+    carregarRecursos();
+    esperarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+
+    const std::vector<std::string> nomes = {
+        "shader.vert", "shader.frag", "profundidade.vert"};
+    medirQuadros(10);
+
+    for (bool emSegundoPlano : {false, true}) {
+        double total = 0.0;
+        double pior = 0.0;
+        for (size_t i = 0; i < 100; i++) {
+            bool recarregar = i % kQuadrosEntreRecargas == 0;
+            double ms = medirMilissegundos(1, [&]() {
+                if (recarregar && !emSegundoPlano) {
+                    trocarShaders(construirShaders(
+                        nomes, formatoDeVertice_,
+                        passePrevioDeProfundidade_,
+                        passeDeRenderizacao_));
+                } else if (recarregar &&
+                           !recarregandoShaders()) {
+                    recarregarShaders(nomes);
+                }
+                renderizarQuadroDeBancada();
+            });
+            total += ms;
+            pior = std::max(pior, ms);
+        }
+        std::string nome =
+            emSegundoPlano ? "recarga em segundo plano"
+                           : "recarga na thread principal";
+        imprimirMedicao(nome + ", quadro médio",
+                        total / 100.0);
+        imprimirMedicao(nome + ", pior quadro", pior);
+    }
+}
+
+// Renderiza o modelo reduzido, como se estivesse longe, com
+// a textura minificada amostrada só do nível 0 e depois da
+// cadeia de mips inteira.
+void App::bancadaDeMipmaps() {
+    carregarRecursos();
+    esperarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+    pushConstants_.modelo =
+        glm::scale(glm::identity<glm::mat4>(),
+                   glm::vec3(kEscalaNaBancadaDeMipmaps));
+    instanciasPorDesenho_ = kInstanciasNaBancadaDeVertices;
+    std::cout << "textura com " << numNiveisDaTextura_
+              << " níveis de mip" << std::endl;
+
+    for (uint32_t numNiveis : {1u, numNiveisDaTextura_}) {
+        dispositivo_.waitIdle();
+        dispositivo_.destroySampler(amostrador_);
+        amostrador_ = criarAmostrador(
+            static_cast<float>(numNiveis - 1));
+        atualizarDescritorDaTextura();
+
+        medirQuadros(10);
+        imprimirMedicao(
+            numNiveis == 1 ? "só o nível 0"
+                           : "cadeia de mips",
+            medirQuadros(100));
+    }
+}
+
+// Tempo para ter a textura na GPU, com todos os níveis de
+// mip, decodificando a imagem original e gerando os mips
+// com blit ou enviando a textura cozida, e a memória que
+// cada uma ocupa.
+void App::bancadaDeTextura() {
+    auto medir = [this](const std::string& nome,
+                        auto&& carregar) {
+        vk::Image imagem;
+        Alocacao alocacao;
+        vk::DeviceSize bytes = 0;
+        double ms = medirMilissegundos(10, [&]() {
+            carregar(imagem, alocacao);
+            contextoDeEnvio_.submeter();
+            contextoDeEnvio_.esperar();
+            bytes = alocacao.tamanho;
+            dispositivo_.destroyImage(imagem);
+            alocador_.liberar(alocacao);
+        });
+        imprimirMedicao(nome, ms);
+        std::cout << "    " << bytes << " bytes na GPU"
+                  << std::endl;
+    };
+
+    medir("imagem decodificada",
+          [this](vk::Image& imagem, Alocacao& alocacao) {
+              TexturaPreparada textura;
+              prepararImagem(kCaminhoDaTextura, textura);
+              uint32_t _numNiveis;
+              enviarTexturaPreparada(textura, imagem,
+                                     alocacao, _numNiveis);
+          });
+    medir(suportaCompressaoBc_
+              ? "textura cozida"
+              : "textura cozida, descomprimida na CPU",
+          [this](vk::Image& imagem, Alocacao& alocacao) {
+              TexturaPreparada textura;
+              if (!prepararTexturaCozida(
+                      kCaminhoDaTexturaCozida, textura)) {
+                  throw std::runtime_error(
+                      "A textura cozida não foi "
+                      "encontrada ou não pode ser "
+                      "descomprimida.");
+              }
+              uint32_t _numNiveis;
+              enviarTexturaPreparada(textura, imagem,
+                                     alocacao, _numNiveis);
+          });
+}
+
+// Tempo até o primeiro quadro e até o modelo e a textura
+// ficarem prontos, contando os quadros renderizados com os
+// substitutos. O tempo de preparar cada recurso, medido
+// depois, é o que bloqueava o início quando o carregamento
+// era síncrono.
+void App::bancadaDeCarregamento() {
+    using Milissegundos =
+        std::chrono::duration<double, std::milli>;
+
+    auto inicio = std::chrono::steady_clock::now();
+    carregarRecursos();
+    atualizar(std::chrono::duration<
+              float, std::chrono::seconds::period>(0.0f));
+    renderizarQuadroDeBancada();
+    Milissegundos primeiroQuadro =
+        std::chrono::steady_clock::now() - inicio;
+    size_t numQuadros = 1;
+    while (!carregador_.ocioso()) {
+        renderizarQuadroDeBancada();
+        numQuadros++;
+    }
+    Milissegundos prontos =
+        std::chrono::steady_clock::now() - inicio;
+
+    imprimirMedicao("até o primeiro quadro",
+                    primeiroQuadro.count());
+    imprimirMedicao("até os recursos ficarem prontos",
+                    prontos.count());
+    std::cout << "    " << numQuadros
+              << " quadros com os substitutos" << std::endl;
+
+    imprimirMedicao("preparo do modelo",
+                    medirMilissegundos(1, [this]() {
+                        prepararModelo(formatoDeVertice_);
+                    }));
+    imprimirMedicao("preparo da textura",
+                    medirMilissegundos(1, [this]() {
+                        TexturaPreparada textura;
+                        prepararTextura(
+                            kCaminhoDaTextura,
+                            kCaminhoDaTexturaCozida,
+                            textura);
+                    }));
+}
+
+// Caminho antigo de envio, que cria e libera um buffer de
+// preparo a cada chamada. Mantido só como referência para
+// a bancada de envio.
+void App::atualizarBufferPorChamada(vk::Buffer buffer,
+                                    size_t tamanho,
+                                    const void* dados) {
+    vk::BufferCreateInfo infoBuffer;
+    infoBuffer.size = tamanho;
+    infoBuffer.usage = vk::BufferUsageFlagBits::eTransferSrc;
+    infoBuffer.sharingMode = vk::SharingMode::eExclusive;
+    vk::Buffer bufferDePreparo =
+        dispositivo_.createBuffer(infoBuffer);
+
+    auto requisitosDeMemoria =
+        dispositivo_.getBufferMemoryRequirements(
+            bufferDePreparo);
+    vk::MemoryAllocateInfo infoAlloc;
+    infoAlloc.allocationSize = requisitosDeMemoria.size;
+    infoAlloc.memoryTypeIndex = buscarTipoDeMemoria(
+        requisitosDeMemoria.memoryTypeBits,
+        vk::MemoryPropertyFlagBits::eHostVisible |
+            vk::MemoryPropertyFlagBits::eHostCoherent);
+    vk::DeviceMemory memoriaDePreparo =
+        dispositivo_.allocateMemory(infoAlloc);
+    dispositivo_.bindBufferMemory(bufferDePreparo,
+                                  memoriaDePreparo, 0);
+
+    void* dstDados = dispositivo_.mapMemory(
+        memoriaDePreparo, 0, tamanho);
+    std::memcpy(dstDados, dados, tamanho);
+    dispositivo_.unmapMemory(memoriaDePreparo);
+
+    auto comando = iniciarComandoDeUsoUnico();
+    comando.copyBuffer(bufferDePreparo, buffer,
+                       vk::BufferCopy{0, 0, tamanho});
+    finalizarComandoDeUsoUnico(comando);
+
+    dispositivo_.destroyBuffer(bufferDePreparo);
+    dispositivo_.freeMemory(memoriaDePreparo);
+}
+}  // namespace smv
@@ -0,0 +1,144 @@
+#include "carregador_de_recursos.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace smv {
+void CarregadorDeRecursos::iniciar(unsigned numThreads) {
+    encerrar_ = false;
+    for (unsigned i = 0; i < numThreads; i++) {
+        threads_.emplace_back([this]() { trabalhar(); });
+    }
+}
+
+void CarregadorDeRecursos::destruir() {
+    {
+        std::lock_guard<std::mutex> trava(mutex_);
+        encerrar_ = true;
+        fila_.clear();
+    }
+    haTrabalho_.notify_all();
+    for (auto&& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+    feitos_.clear();
+    prontos_.clear();
+    numPendentes_ = 0;
+}
+
+CarregadorDeRecursos::IdDePedido CarregadorDeRecursos::pedir(
+    Trabalho trabalho) {
+    if (threads_.empty()) {
+        throw std::logic_error(
+            "O carregador de recursos não foi iniciado.");
+    }
+
+    auto id = static_cast<IdDePedido>(prontos_.size());
+    prontos_.push_back(false);
+    numPendentes_++;
+    {
+        std::lock_guard<std::mutex> trava(mutex_);
+        fila_.emplace_back(id, std::move(trabalho));
+    }
+    haTrabalho_.notify_one();
+    return id;
+}
+
+bool CarregadorDeRecursos::pronto(IdDePedido id) const {
+    return id < prontos_.size() && prontos_[id];
+}
+
+bool CarregadorDeRecursos::ocioso() const {
+    return numPendentes_ == 0;
+}
+
+size_t CarregadorDeRecursos::concluirProntos() {
+    std::vector<Feito> feitos;
+    {
+        std::lock_guard<std::mutex> trava(mutex_);
+        feitos.swap(feitos_);
+    }
+
+    // O lote inteiro é concluído antes de relançar o primeiro
+    // erro, senão os pedidos seguintes nunca ficariam prontos.
+    std::exception_ptr primeiroErro;
+    for (auto&& feito : feitos) {
+        prontos_[feito.id] = true;
+        numPendentes_--;
+        if (!feito.erro) {
+            try {
+                feito.conclusao();
+            } catch (...) {
+                feito.erro = std::current_exception();
+            }
+        }
+        if (feito.erro && !primeiroErro) {
+            primeiroErro = feito.erro;
+        }
+    }
+    if (primeiroErro) {
+        std::rethrow_exception(primeiroErro);
+    }
+    return feitos.size();
+}
+
+void CarregadorDeRecursos::esperarTodos() {
+    while (!ocioso()) {
+        {
+            std::unique_lock<std::mutex> trava(mutex_);
+            haFeitos_.wait(trava, [this]() {
+                return !feitos_.empty();
+            });
+        }
+        concluirProntos();
+    }
+}
+
+void CarregadorDeRecursos::esperarTrabalho(IdDePedido id) {
+    if (pronto(id)) {
+        return;
+    }
+    std::unique_lock<std::mutex> trava(mutex_);
+    haFeitos_.wait(trava, [this, id]() {
+        return std::any_of(feitos_.begin(), feitos_.end(),
+                           [id](const Feito& feito) {
+                               return feito.id == id;
+                           });
+    });
+}
+
+void CarregadorDeRecursos::trabalhar() {
+    while (true) {
+        std::pair<IdDePedido, Trabalho> pedido;
+        {
+            std::unique_lock<std::mutex> trava(mutex_);
+            haTrabalho_.wait(trava, [this]() {
+                return encerrar_ || !fila_.empty();
+            });
+            if (encerrar_) {
+                return;
+            }
+            pedido = std::move(fila_.front());
+            fila_.pop_front();
+        }
+
+        Feito feito{pedido.first, {}, nullptr};
+        try {
+            feito.conclusao = pedido.second();
+        } catch (...) {
+            feito.erro = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> trava(mutex_);
+            if (encerrar_) {
+                return;
+            }
+            feitos_.push_back(std::move(feito));
+        }
+        haFeitos_.notify_one();
+    }
+}
+}  // namespace smv
@@ -0,0 +1,73 @@
+#ifndef SMV_CARREGADOR_DE_RECURSOS_HPP
+#define SMV_CARREGADOR_DE_RECURSOS_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace smv {
+// Carrega recursos em threads de trabalho sem bloquear o loop
+// de renderização. Cada pedido é um trabalho lento (ler o
+// arquivo, decodificar, preparar os bytes para a GPU), que roda
+// numa thread de trabalho e retorna uma conclusão. A conclusão
+// roda na thread principal, em `concluirProntos`, e é onde o
+// recurso é enviado pelo contexto de envio e passa a ser usado.
+//
+// Uma exceção lançada pelo trabalho ou pela conclusão é
+// relançada na thread principal, em `concluirProntos`, depois
+// que o resto do lote foi concluído.
+class CarregadorDeRecursos {
+  public:
+    using IdDePedido = uint32_t;
+    using Conclusao = std::function<void()>;
+    using Trabalho = std::function<Conclusao()>;
+
+    void iniciar(unsigned numThreads);
+    // Descarta os pedidos que ainda não foram concluídos.
+    void destruir();
+
+    // Retorna logo; o trabalho roda assim que uma thread de
+    // trabalho estiver livre, na ordem dos pedidos.
+    IdDePedido pedir(Trabalho trabalho);
+    // Verdadeiro depois que a conclusão do pedido rodou.
+    bool pronto(IdDePedido id) const;
+    bool ocioso() const;
+
+    // Roda as conclusões dos trabalhos já feitos e retorna
+    // quantas foram.
+    size_t concluirProntos();
+    // Bloqueia até que todos os pedidos estejam prontos.
+    void esperarTodos();
+    // Bloqueia até o trabalho do pedido terminar. A conclusão
+    // dele ainda espera o próximo `concluirProntos`.
+    void esperarTrabalho(IdDePedido id);
+
+  private:
+    struct Feito {
+        IdDePedido id;
+        Conclusao conclusao;
+        std::exception_ptr erro;
+    };
+
+    void trabalhar();
+
+    std::vector<std::thread> threads_;
+    mutable std::mutex mutex_;
+    std::condition_variable haTrabalho_;
+    std::condition_variable haFeitos_;
+    bool encerrar_ = false;
+    std::deque<std::pair<IdDePedido, Trabalho>> fila_;
+    std::vector<Feito> feitos_;
+
+    // Só acessados pela thread principal.
+    std::vector<bool> prontos_;
+    size_t numPendentes_ = 0;
+};
+}  // namespace smv
+
+#endif
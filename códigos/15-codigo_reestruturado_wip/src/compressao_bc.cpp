@@ -0,0 +1,609 @@
+#include "compressao_bc.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace smv {
+namespace {
+enum class TipoBc { eBc1, eBc3, eBc7 };
+
+TipoBc tipoBc(vk::Format formato) {
+    switch (formato) {
+        case vk::Format::eBc1RgbSrgbBlock:
+        case vk::Format::eBc1RgbUnormBlock:
+            return TipoBc::eBc1;
+        case vk::Format::eBc3SrgbBlock:
+        case vk::Format::eBc3UnormBlock:
+            return TipoBc::eBc3;
+        case vk::Format::eBc7SrgbBlock:
+        case vk::Format::eBc7UnormBlock:
+            return TipoBc::eBc7;
+        default:
+            throw std::logic_error(
+                "O formato não é BC1, BC3 nem BC7.");
+    }
+}
+
+using Texel = std::array<uint8_t, 4>;
+using Bloco = std::array<Texel, 16>;
+
+// Os blocos da borda repetem a última linha e coluna.
+Bloco lerBloco(const uint8_t* texels,
+               uint32_t largura,
+               uint32_t altura,
+               uint32_t blocoX,
+               uint32_t blocoY) {
+    Bloco bloco;
+    for (uint32_t y = 0; y < kLadoDoBlocoBc; y++) {
+        for (uint32_t x = 0; x < kLadoDoBlocoBc; x++) {
+            uint32_t origemX = std::min(
+                blocoX * kLadoDoBlocoBc + x, largura - 1);
+            uint32_t origemY = std::min(
+                blocoY * kLadoDoBlocoBc + y, altura - 1);
+            const uint8_t* origem =
+                texels +
+                (size_t{origemY} * largura + origemX) * 4;
+            std::copy(origem, origem + 4,
+                      bloco[y * kLadoDoBlocoBc + x].begin());
+        }
+    }
+    return bloco;
+}
+
+void escreverBloco(const Bloco& bloco,
+                   uint8_t* texels,
+                   uint32_t largura,
+                   uint32_t altura,
+                   uint32_t blocoX,
+                   uint32_t blocoY) {
+    for (uint32_t y = 0; y < kLadoDoBlocoBc; y++) {
+        for (uint32_t x = 0; x < kLadoDoBlocoBc; x++) {
+            uint32_t destinoX = blocoX * kLadoDoBlocoBc + x;
+            uint32_t destinoY = blocoY * kLadoDoBlocoBc + y;
+            if (destinoX >= largura || destinoY >= altura) {
+                continue;
+            }
+            const auto& texel = bloco[y * kLadoDoBlocoBc + x];
+            std::copy(texel.begin(), texel.end(),
+                      texels + (size_t{destinoY} * largura +
+                                destinoX) *
+                                   4);
+        }
+    }
+}
+
+// Os extremos do bloco ao longo do eixo de maior variância
+// dos `C` primeiros canais, achado por iteração de potência
+// sobre a covariância.
+template <size_t C>
+void extremosDoEixoPrincipal(const Bloco& bloco,
+                             std::array<float, C>& inicio,
+                             std::array<float, C>& fim) {
+    std::array<float, C> media{};
+    for (const auto& texel : bloco) {
+        for (size_t c = 0; c < C; c++) {
+            media[c] += texel[c] / 16.0f;
+        }
+    }
+
+    std::array<std::array<float, C>, C> covariancia{};
+    for (const auto& texel : bloco) {
+        for (size_t i = 0; i < C; i++) {
+            for (size_t j = 0; j < C; j++) {
+                covariancia[i][j] += (texel[i] - media[i]) *
+                                     (texel[j] - media[j]);
+            }
+        }
+    }
+
+    std::array<float, C> eixo;
+    eixo.fill(1.0f);
+    for (int iteracao = 0; iteracao < 8; iteracao++) {
+        std::array<float, C> proximo{};
+        float maior = 0.0f;
+        for (size_t i = 0; i < C; i++) {
+            for (size_t j = 0; j < C; j++) {
+                proximo[i] += covariancia[i][j] * eixo[j];
+            }
+            maior = std::max(maior, std::fabs(proximo[i]));
+        }
+        for (size_t i = 0; i < C; i++) {
+            eixo[i] = maior > 0.0f ? proximo[i] / maior : 0.0f;
+        }
+    }
+
+    float comprimento = 0.0f;
+    for (float componente : eixo) {
+        comprimento += componente * componente;
+    }
+    comprimento = std::sqrt(comprimento);
+
+    float menor = 0.0f, maior = 0.0f;
+    if (comprimento > 0.0f) {
+        for (auto& componente : eixo) {
+            componente /= comprimento;
+        }
+        menor = std::numeric_limits<float>::max();
+        maior = std::numeric_limits<float>::lowest();
+        for (const auto& texel : bloco) {
+            float projecao = 0.0f;
+            for (size_t c = 0; c < C; c++) {
+                projecao += (texel[c] - media[c]) * eixo[c];
+            }
+            menor = std::min(menor, projecao);
+            maior = std::max(maior, projecao);
+        }
+    }
+
+    for (size_t c = 0; c < C; c++) {
+        inicio[c] = std::clamp(media[c] + eixo[c] * menor, 0.0f,
+                               255.0f);
+        fim[c] = std::clamp(media[c] + eixo[c] * maior, 0.0f,
+                            255.0f);
+    }
+}
+
+template <size_t C>
+int distancia(const Texel& texel,
+              const std::array<int, C>& cor) {
+    int soma = 0;
+    for (size_t c = 0; c < C; c++) {
+        int diferenca = texel[c] - cor[c];
+        soma += diferenca * diferenca;
+    }
+    return soma;
+}
+
+template <size_t C, size_t N>
+uint32_t maisProxima(
+    const Texel& texel,
+    const std::array<std::array<int, C>, N>& paleta) {
+    uint32_t melhor = 0;
+    for (uint32_t i = 1; i < N; i++) {
+        if (distancia(texel, paleta[i]) <
+            distancia(texel, paleta[melhor])) {
+            melhor = i;
+        }
+    }
+    return melhor;
+}
+
+void escrever16(uint8_t* saida, uint16_t valor) {
+    saida[0] = static_cast<uint8_t>(valor);
+    saida[1] = static_cast<uint8_t>(valor >> 8);
+}
+
+uint16_t ler16(const uint8_t* entrada) {
+    return static_cast<uint16_t>(entrada[0] | entrada[1] << 8);
+}
+
+uint16_t para565(const std::array<float, 3>& cor) {
+    auto r =
+        static_cast<uint16_t>(std::lround(cor[0] * 31 / 255));
+    auto g =
+        static_cast<uint16_t>(std::lround(cor[1] * 63 / 255));
+    auto b =
+        static_cast<uint16_t>(std::lround(cor[2] * 31 / 255));
+    return static_cast<uint16_t>(r << 11 | g << 5 | b);
+}
+
+std::array<int, 3> de565(uint16_t cor) {
+    int r = cor >> 11 & 0x1f;
+    int g = cor >> 5 & 0x3f;
+    int b = cor & 0x1f;
+    return {r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2};
+}
+
+std::array<std::array<int, 3>, 4> paletaDeCor(uint16_t c0,
+                                             uint16_t c1,
+                                             bool quatroCores) {
+    auto e0 = de565(c0);
+    auto e1 = de565(c1);
+    std::array<std::array<int, 3>, 4> paleta{e0, e1};
+    for (size_t c = 0; c < 3; c++) {
+        if (quatroCores) {
+            paleta[2][c] = (2 * e0[c] + e1[c]) / 3;
+            paleta[3][c] = (e0[c] + 2 * e1[c]) / 3;
+        } else {
+            paleta[2][c] = (e0[c] + e1[c]) / 2;
+        }
+    }
+    return paleta;
+}
+
+// Sempre no modo de quatro cores, que é o único do BC3.
+void comprimirCor(const Bloco& bloco, uint8_t* saida) {
+    std::array<float, 3> inicio, fim;
+    extremosDoEixoPrincipal(bloco, inicio, fim);
+    uint16_t c0 = para565(fim);
+    uint16_t c1 = para565(inicio);
+    if (c0 < c1) {
+        std::swap(c0, c1);
+    }
+
+    // Com c0 igual a c1, o índice 0 já dá a cor certa nos dois
+    // modos.
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        auto paleta = paletaDeCor(c0, c1, true);
+        for (uint32_t i = 0; i < 16; i++) {
+            indices |= maisProxima(bloco[i], paleta) << (2 * i);
+        }
+    }
+
+    escrever16(saida, c0);
+    escrever16(saida + 2, c1);
+    for (uint32_t i = 0; i < 4; i++) {
+        saida[4 + i] = static_cast<uint8_t>(indices >> (8 * i));
+    }
+}
+
+void descomprimirCor(const uint8_t* entrada,
+                     Bloco& bloco,
+                     bool bc1) {
+    uint16_t c0 = ler16(entrada);
+    uint16_t c1 = ler16(entrada + 2);
+    bool quatroCores = !bc1 || c0 > c1;
+    auto paleta = paletaDeCor(c0, c1, quatroCores);
+
+    for (uint32_t i = 0; i < 16; i++) {
+        uint32_t indice =
+            entrada[4 + i / 4] >> (2 * (i % 4)) & 3;
+        for (size_t c = 0; c < 3; c++) {
+            bloco[i][c] =
+                static_cast<uint8_t>(paleta[indice][c]);
+        }
+        // No modo de três cores, o índice 3 é preto
+        // transparente.
+        bool transparente = !quatroCores && indice == 3;
+        bloco[i][3] = transparente ? 0 : 255;
+    }
+}
+
+std::array<std::array<int, 1>, 8> paletaDeAlfa(int a0, int a1) {
+    std::array<std::array<int, 1>, 8> paleta{};
+    paleta[0][0] = a0;
+    paleta[1][0] = a1;
+    if (a0 > a1) {
+        for (int i = 2; i < 8; i++) {
+            paleta[static_cast<size_t>(i)][0] =
+                ((8 - i) * a0 + (i - 1) * a1) / 7;
+        }
+    } else {
+        for (int i = 2; i < 6; i++) {
+            paleta[static_cast<size_t>(i)][0] =
+                ((6 - i) * a0 + (i - 1) * a1) / 5;
+        }
+        paleta[6][0] = 0;
+        paleta[7][0] = 255;
+    }
+    return paleta;
+}
+
+// Alfa do BC3 no modo de oito valores, entre o maior e o menor
+// alfa do bloco.
+void comprimirAlfa(const Bloco& bloco, uint8_t* saida) {
+    uint8_t a0 = 0, a1 = 255;
+    for (const auto& texel : bloco) {
+        a0 = std::max(a0, texel[3]);
+        a1 = std::min(a1, texel[3]);
+    }
+
+    uint64_t indices = 0;
+    if (a0 != a1) {
+        auto paleta = paletaDeAlfa(a0, a1);
+        for (uint32_t i = 0; i < 16; i++) {
+            Texel alfa = {bloco[i][3], 0, 0, 0};
+            indices |= uint64_t{maisProxima(alfa, paleta)}
+                       << (3 * i);
+        }
+    }
+
+    saida[0] = a0;
+    saida[1] = a1;
+    for (uint32_t i = 0; i < 6; i++) {
+        saida[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+    }
+}
+
+void descomprimirAlfa(const uint8_t* entrada, Bloco& bloco) {
+    auto paleta = paletaDeAlfa(entrada[0], entrada[1]);
+    uint64_t indices = 0;
+    for (uint32_t i = 0; i < 6; i++) {
+        indices |= uint64_t{entrada[2 + i]} << (8 * i);
+    }
+    for (uint32_t i = 0; i < 16; i++) {
+        bloco[i][3] = static_cast<uint8_t>(
+            paleta[indices >> (3 * i) & 7][0]);
+    }
+}
+
+// O BC7 é lido e escrito do bit menos significativo do
+// primeiro byte em diante.
+class BitsDoBloco {
+  public:
+    explicit BitsDoBloco(uint8_t* bytes) : bytes_(bytes) {}
+
+    void escrever(uint32_t valor, uint32_t numBits) {
+        for (uint32_t i = 0; i < numBits; i++, posicao_++) {
+            if (valor >> i & 1) {
+                bytes_[posicao_ / 8] = static_cast<uint8_t>(
+                    bytes_[posicao_ / 8] | 1 << (posicao_ % 8));
+            }
+        }
+    }
+
+    uint32_t ler(uint32_t numBits) {
+        uint32_t valor = 0;
+        for (uint32_t i = 0; i < numBits; i++, posicao_++) {
+            valor |= uint32_t{bytes_[posicao_ / 8] >>
+                                  (posicao_ % 8) &
+                              1u}
+                     << i;
+        }
+        return valor;
+    }
+
+  private:
+    uint8_t* bytes_;
+    uint32_t posicao_ = 0;
+};
+
+constexpr std::array<int, 16> kPesosDoBc7 = {
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60,
+    64};
+
+std::array<std::array<int, 4>, 16> paletaDoModo6(
+    const std::array<int, 4>& e0,
+    const std::array<int, 4>& e1) {
+    std::array<std::array<int, 4>, 16> paleta;
+    for (size_t i = 0; i < 16; i++) {
+        for (size_t c = 0; c < 4; c++) {
+            paleta[i][c] = ((64 - kPesosDoBc7[i]) * e0[c] +
+                            kPesosDoBc7[i] * e1[c] + 32) >>
+                           6;
+        }
+    }
+    return paleta;
+}
+
+// Escolhe o p-bit que aproxima melhor o extremo com os 7 bits
+// de cada canal.
+void quantizarExtremo(const std::array<float, 4>& extremo,
+                      std::array<uint32_t, 4>& canais,
+                      uint32_t& pBit,
+                      std::array<int, 4>& expandido) {
+    float menorErro = std::numeric_limits<float>::max();
+    for (uint32_t p = 0; p < 2; p++) {
+        std::array<uint32_t, 4> quantizados;
+        float erro = 0.0f;
+        for (size_t c = 0; c < 4; c++) {
+            long q = std::lround(
+                (extremo[c] - static_cast<float>(p)) / 2.0f);
+            quantizados[c] =
+                static_cast<uint32_t>(std::clamp(q, 0l, 127l));
+            float diferenca =
+                extremo[c] -
+                static_cast<float>(quantizados[c] * 2 + p);
+            erro += diferenca * diferenca;
+        }
+        if (erro < menorErro) {
+            menorErro = erro;
+            canais = quantizados;
+            pBit = p;
+        }
+    }
+    for (size_t c = 0; c < 4; c++) {
+        expandido[c] = static_cast<int>(canais[c] << 1 | pBit);
+    }
+}
+
+void comprimirBc7(const Bloco& bloco, uint8_t* saida) {
+    std::array<float, 4> inicio, fim;
+    extremosDoEixoPrincipal(bloco, inicio, fim);
+
+    std::array<std::array<uint32_t, 4>, 2> canais;
+    std::array<uint32_t, 2> pBits;
+    std::array<std::array<int, 4>, 2> extremos;
+    quantizarExtremo(inicio, canais[0], pBits[0], extremos[0]);
+    quantizarExtremo(fim, canais[1], pBits[1], extremos[1]);
+
+    auto paleta = paletaDoModo6(extremos[0], extremos[1]);
+    std::array<uint32_t, 16> indices;
+    for (uint32_t i = 0; i < 16; i++) {
+        indices[i] = maisProxima(bloco[i], paleta);
+    }
+
+    // O bit mais alto do índice do primeiro texel não é
+    // guardado, então ele precisa ser 0. Como os pesos são
+    // simétricos, trocar os extremos inverte os índices sem
+    // mudar as cores.
+    if (indices[0] >= 8) {
+        std::swap(canais[0], canais[1]);
+        std::swap(pBits[0], pBits[1]);
+        for (auto& indice : indices) {
+            indice = 15 - indice;
+        }
+    }
+
+    std::fill(saida, saida + 16, uint8_t{0});
+    BitsDoBloco bits(saida);
+    bits.escrever(1u << 6, 7);
+    for (size_t c = 0; c < 4; c++) {
+        bits.escrever(canais[0][c], 7);
+        bits.escrever(canais[1][c], 7);
+    }
+    bits.escrever(pBits[0], 1);
+    bits.escrever(pBits[1], 1);
+    bits.escrever(indices[0], 3);
+    for (uint32_t i = 1; i < 16; i++) {
+        bits.escrever(indices[i], 4);
+    }
+}
+
+void descomprimirBc7(const uint8_t* entrada, Bloco& bloco) {
+    std::array<uint8_t, 16> copia;
+    std::copy(entrada, entrada + 16, copia.begin());
+    BitsDoBloco bits(copia.data());
+
+    uint32_t modo = 0;
+    while (modo < 8 && bits.ler(1) == 0) {
+        modo++;
+    }
+    if (modo != 6) {
+        throw std::runtime_error(
+            "O decodificador de BC7 só aceita o modo 6.");
+    }
+
+    std::array<std::array<int, 4>, 2> extremos;
+    for (size_t c = 0; c < 4; c++) {
+        extremos[0][c] = static_cast<int>(bits.ler(7));
+        extremos[1][c] = static_cast<int>(bits.ler(7));
+    }
+    for (auto& extremo : extremos) {
+        uint32_t pBit = bits.ler(1);
+        for (auto& canal : extremo) {
+            canal = canal << 1 | static_cast<int>(pBit);
+        }
+    }
+
+    auto paleta = paletaDoModo6(extremos[0], extremos[1]);
+    for (uint32_t i = 0; i < 16; i++) {
+        uint32_t indice = bits.ler(i == 0 ? 3 : 4);
+        for (size_t c = 0; c < 4; c++) {
+            bloco[i][c] =
+                static_cast<uint8_t>(paleta[indice][c]);
+        }
+    }
+}
+}  // namespace
+
+bool formatoBc(vk::Format formato) {
+    switch (formato) {
+        case vk::Format::eBc1RgbSrgbBlock:
+        case vk::Format::eBc1RgbUnormBlock:
+        case vk::Format::eBc3SrgbBlock:
+        case vk::Format::eBc3UnormBlock:
+        case vk::Format::eBc7SrgbBlock:
+        case vk::Format::eBc7UnormBlock:
+            return true;
+        default:
+            return false;
+    }
+}
+
+vk::Format formatoDescomprimido(vk::Format formato) {
+    switch (formato) {
+        case vk::Format::eBc1RgbSrgbBlock:
+        case vk::Format::eBc3SrgbBlock:
+        case vk::Format::eBc7SrgbBlock:
+            return vk::Format::eR8G8B8A8Srgb;
+        case vk::Format::eBc1RgbUnormBlock:
+        case vk::Format::eBc3UnormBlock:
+        case vk::Format::eBc7UnormBlock:
+            return vk::Format::eR8G8B8A8Unorm;
+        default:
+            throw std::logic_error(
+                "O formato não é BC1, BC3 nem BC7.");
+    }
+}
+
+uint32_t bytesPorBlocoBc(vk::Format formato) {
+    return tipoBc(formato) == TipoBc::eBc1 ? 8 : 16;
+}
+
+size_t tamanhoComprimido(vk::Format formato,
+                         uint32_t largura,
+                         uint32_t altura) {
+    size_t blocosX =
+        (largura + kLadoDoBlocoBc - 1) / kLadoDoBlocoBc;
+    size_t blocosY =
+        (altura + kLadoDoBlocoBc - 1) / kLadoDoBlocoBc;
+    return blocosX * blocosY * bytesPorBlocoBc(formato);
+}
+
+std::vector<uint8_t> comprimirBc(vk::Format formato,
+                                 const uint8_t* texels,
+                                 uint32_t largura,
+                                 uint32_t altura) {
+    auto tipo = tipoBc(formato);
+    uint32_t bytesPorBloco = bytesPorBlocoBc(formato);
+    std::vector<uint8_t> blocos(
+        tamanhoComprimido(formato, largura, altura));
+
+    uint8_t* saida = blocos.data();
+    for (uint32_t y = 0; y * kLadoDoBlocoBc < altura; y++) {
+        for (uint32_t x = 0; x * kLadoDoBlocoBc < largura;
+             x++) {
+            auto bloco =
+                lerBloco(texels, largura, altura, x, y);
+            switch (tipo) {
+                case TipoBc::eBc1:
+                    comprimirCor(bloco, saida);
+                    break;
+                case TipoBc::eBc3:
+                    comprimirAlfa(bloco, saida);
+                    comprimirCor(bloco, saida + 8);
+                    break;
+                case TipoBc::eBc7:
+                    comprimirBc7(bloco, saida);
+                    break;
+            }
+            saida += bytesPorBloco;
+        }
+    }
+    return blocos;
+}
+
+bool descomprimivel(vk::Format formato,
+                    const uint8_t* blocos,
+                    size_t tamanho) {
+    if (tipoBc(formato) != TipoBc::eBc7) {
+        return true;
+    }
+    // O modo é o número de bits 0 antes do primeiro bit 1, a
+    // partir do bit mais baixo do bloco.
+    for (size_t i = 0; i < tamanho; i += 16) {
+        if ((blocos[i] & 0x7f) != 0x40) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<uint8_t> descomprimirBc(vk::Format formato,
+                                    const uint8_t* blocos,
+                                    uint32_t largura,
+                                    uint32_t altura) {
+    auto tipo = tipoBc(formato);
+    uint32_t bytesPorBloco = bytesPorBlocoBc(formato);
+    std::vector<uint8_t> texels(size_t{largura} * altura * 4);
+
+    const uint8_t* entrada = blocos;
+    for (uint32_t y = 0; y * kLadoDoBlocoBc < altura; y++) {
+        for (uint32_t x = 0; x * kLadoDoBlocoBc < largura;
+             x++) {
+            Bloco bloco;
+            switch (tipo) {
+                case TipoBc::eBc1:
+                    descomprimirCor(entrada, bloco, true);
+                    break;
+                case TipoBc::eBc3:
+                    descomprimirCor(entrada + 8, bloco, false);
+                    descomprimirAlfa(entrada, bloco);
+                    break;
+                case TipoBc::eBc7:
+                    descomprimirBc7(entrada, bloco);
+                    break;
+            }
+            escreverBloco(bloco, texels.data(), largura, altura,
+                          x, y);
+            entrada += bytesPorBloco;
+        }
+    }
+    return texels;
+}
+}  // namespace smv
@@ -0,0 +1,45 @@
+#ifndef SMV_COMPRESSAO_BC_HPP
+#define SMV_COMPRESSAO_BC_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+namespace smv {
+// Compressão em blocos de 4x4 texels nos formatos BC1 (RGB, 8
+// bytes por bloco), BC3 (RGBA, 16 bytes) e BC7 (RGBA, 16
+// bytes), nas variantes UNORM e SRGB. A entrada e a saída
+// descomprimida são texels RGBA de 8 bits por canal.
+//
+// O codificador de BC7 só usa o modo 6 (um subconjunto,
+// extremos RGBA de 7 bits com p-bit e índices de 4 bits), e o
+// decodificador só aceita esse modo. Texturas BC7 de outros
+// codificadores precisam ser recusadas com descomprimivel antes
+// de descomprimir.
+constexpr uint32_t kLadoDoBlocoBc = 4;
+
+bool formatoBc(vk::Format formato);
+// O formato RGBA8 de mesmo espaço de cor.
+vk::Format formatoDescomprimido(vk::Format formato);
+uint32_t bytesPorBlocoBc(vk::Format formato);
+size_t tamanhoComprimido(vk::Format formato,
+                         uint32_t largura,
+                         uint32_t altura);
+
+std::vector<uint8_t> comprimirBc(vk::Format formato,
+                                 const uint8_t* texels,
+                                 uint32_t largura,
+                                 uint32_t altura);
+// Se descomprimirBc aceita todos os blocos de `tamanho` bytes.
+bool descomprimivel(vk::Format formato,
+                    const uint8_t* blocos,
+                    size_t tamanho);
+// Para dispositivos sem textureCompressionBC.
+std::vector<uint8_t> descomprimirBc(vk::Format formato,
+                                    const uint8_t* blocos,
+                                    uint32_t largura,
+                                    uint32_t altura);
+}  // namespace smv
+
+#endif
@@ -0,0 +1,537 @@
+#include "contexto_de_envio.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+
+namespace smv {
+void ContextoDeEnvio::iniciar(vk::Device dispositivo,
+                              AnelDePreparo& anelDePreparo,
+                              uint32_t familiaDeTransferencia,
+                              vk::Queue filaDeTransferencia,
+                              uint32_t familiaDeGraficos,
+                              vk::Queue filaDeGraficos) {
+    dispositivo_ = dispositivo;
+    anelDePreparo_ = &anelDePreparo;
+    familiaDeTransferencia_ = familiaDeTransferencia;
+    filaDeTransferencia_ = filaDeTransferencia;
+    familiaDeGraficos_ = familiaDeGraficos;
+    filaDeGraficos_ = filaDeGraficos;
+
+    vk::CommandPoolCreateInfo info;
+    info.flags = vk::CommandPoolCreateFlagBits::eTransient;
+    info.queueFamilyIndex = familiaDeTransferencia_;
+    poolDeTransferencia_ = dispositivo_.createCommandPool(info);
+
+    if (usaFilaDedicada()) {
+        info.queueFamilyIndex = familiaDeGraficos_;
+        poolDeGraficos_ = dispositivo_.createCommandPool(info);
+    }
+}
+
+void ContextoDeEnvio::destruir() {
+    esperar();
+    for (auto&& cerca : cercasLivres_) {
+        dispositivo_.destroyFence(cerca);
+    }
+    cercasLivres_.clear();
+    for (auto&& semaforo : semaforosLivres_) {
+        dispositivo_.destroySemaphore(semaforo);
+    }
+    semaforosLivres_.clear();
+    dispositivo_.destroyCommandPool(poolDeGraficos_);
+    dispositivo_.destroyCommandPool(poolDeTransferencia_);
+}
+
+void ContextoDeEnvio::enviarParaBuffer(
+    vk::Buffer destino,
+    vk::DeviceSize deslocamento,
+    const void* dados,
+    vk::DeviceSize tamanho,
+    vk::PipelineStageFlags estagioDestino,
+    vk::AccessFlags acessoDestino) {
+    auto bytes = static_cast<const char*>(dados);
+
+    // Envios maiores que o anel são feitos em pedaços.
+    for (vk::DeviceSize enviado = 0; enviado < tamanho;) {
+        vk::DeviceSize tamanhoDoPedaco = std::min(
+            tamanho - enviado, anelDePreparo_->maiorFatia());
+        auto fatia = reservar(tamanhoDoPedaco, 16);
+        std::memcpy(fatia.dados, bytes + enviado,
+                    tamanhoDoPedaco);
+
+        comando().copyBuffer(
+            fatia.buffer, destino,
+            vk::BufferCopy{fatia.deslocamento,
+                           deslocamento + enviado,
+                           tamanhoDoPedaco});
+
+        enviado += tamanhoDoPedaco;
+    }
+
+    Entrega entrega{};
+    entrega.ehImagem = false;
+    entrega.estagioDestino = estagioDestino;
+    entrega.buffer.srcAccessMask =
+        vk::AccessFlagBits::eTransferWrite;
+    entrega.buffer.dstAccessMask = acessoDestino;
+    entrega.buffer.buffer = destino;
+    entrega.buffer.offset = deslocamento;
+    entrega.buffer.size = tamanho;
+    entregasPendentes_.push_back(entrega);
+}
+
+void ContextoDeEnvio::enviarParaImagem(
+    vk::Image destino,
+    const void* texels,
+    uint32_t largura,
+    uint32_t altura,
+    uint32_t bytesPorTexel,
+    vk::ImageLayout layoutFinal,
+    vk::PipelineStageFlags estagioDestino,
+    vk::AccessFlags acessoDestino,
+    uint32_t numNiveis) {
+    auto barreira = prepararImagem(destino, numNiveis);
+    copiarParaNivel(destino, 0, texels, largura, altura,
+                    bytesPorTexel, 1);
+
+    auto entrega =
+        entregaDeImagem(barreira, layoutFinal, estagioDestino,
+                        acessoDestino);
+    entrega.numNiveis = numNiveis;
+    entrega.dimensoes = vk::Extent2D{largura, altura};
+    if (numNiveis > 1) {
+        entrega.gerarMipmaps = true;
+        entrega.layoutFinal = layoutFinal;
+        entrega.estagioFinal = estagioDestino;
+        entrega.acessoFinal = acessoDestino;
+        entrega.estagioDestino =
+            vk::PipelineStageFlagBits::eTransfer;
+        entrega.imagem.dstAccessMask =
+            vk::AccessFlagBits::eTransferRead |
+            vk::AccessFlagBits::eTransferWrite;
+        entrega.imagem.newLayout =
+            vk::ImageLayout::eTransferDstOptimal;
+    }
+    entregasPendentes_.push_back(entrega);
+}
+
+void ContextoDeEnvio::enviarNiveisParaImagem(
+    vk::Image destino,
+    const std::vector<NivelDeImagem>& niveis,
+    uint32_t bytesPorBloco,
+    uint32_t ladoDoBloco,
+    vk::ImageLayout layoutFinal,
+    vk::PipelineStageFlags estagioDestino,
+    vk::AccessFlags acessoDestino) {
+    auto numNiveis = static_cast<uint32_t>(niveis.size());
+    auto barreira = prepararImagem(destino, numNiveis);
+    for (uint32_t i = 0; i < numNiveis; i++) {
+        copiarParaNivel(destino, i, niveis[i].dados,
+                        niveis[i].largura, niveis[i].altura,
+                        bytesPorBloco, ladoDoBloco);
+    }
+
+    auto entrega =
+        entregaDeImagem(barreira, layoutFinal, estagioDestino,
+                        acessoDestino);
+    entrega.numNiveis = numNiveis;
+    entregasPendentes_.push_back(entrega);
+}
+
+vk::ImageMemoryBarrier ContextoDeEnvio::prepararImagem(
+    vk::Image destino,
+    uint32_t numNiveis) {
+    vk::ImageMemoryBarrier barreira;
+    barreira.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barreira.oldLayout = vk::ImageLayout::eUndefined;
+    barreira.newLayout = vk::ImageLayout::eTransferDstOptimal;
+    barreira.image = destino;
+    barreira.subresourceRange.aspectMask =
+        vk::ImageAspectFlagBits::eColor;
+    barreira.subresourceRange.levelCount = numNiveis;
+    barreira.subresourceRange.layerCount = 1;
+    comando().pipelineBarrier(
+        vk::PipelineStageFlagBits::eTopOfPipe,
+        vk::PipelineStageFlagBits::eTransfer, {}, nullptr,
+        nullptr, barreira);
+    return barreira;
+}
+
+void ContextoDeEnvio::copiarParaNivel(vk::Image destino,
+                                      uint32_t nivel,
+                                      const void* dados,
+                                      uint32_t largura,
+                                      uint32_t altura,
+                                      uint32_t bytesPorBloco,
+                                      uint32_t ladoDoBloco) {
+    // Imagens maiores que o anel são enviadas em faixas de
+    // linhas de blocos. Sem compressão, o bloco é um texel.
+    auto bytes = static_cast<const char*>(dados);
+    uint32_t blocosPorLinha =
+        (largura + ladoDoBloco - 1) / ladoDoBloco;
+    uint32_t linhasDeBlocos =
+        (altura + ladoDoBloco - 1) / ladoDoBloco;
+    vk::DeviceSize bytesPorLinha =
+        static_cast<vk::DeviceSize>(blocosPorLinha) *
+        bytesPorBloco;
+    uint32_t linhasPorPedaco = std::max<uint32_t>(
+        1, static_cast<uint32_t>(anelDePreparo_->maiorFatia() /
+                                 bytesPorLinha));
+    for (uint32_t linha = 0; linha < linhasDeBlocos;
+         linha += linhasPorPedaco) {
+        uint32_t linhas =
+            std::min(linhasPorPedaco, linhasDeBlocos - linha);
+        vk::DeviceSize tamanhoDoPedaco = linhas * bytesPorLinha;
+
+        auto fatia = reservar(tamanhoDoPedaco, bytesPorBloco);
+        std::memcpy(fatia.dados, bytes + linha * bytesPorLinha,
+                    tamanhoDoPedaco);
+
+        // A região de um bloco parcial na borda termina na
+        // borda do nível.
+        uint32_t primeiroTexel = linha * ladoDoBloco;
+        uint32_t texels = std::min(linhas * ladoDoBloco,
+                                   altura - primeiroTexel);
+
+        vk::BufferImageCopy regiao;
+        regiao.bufferOffset = fatia.deslocamento;
+        regiao.imageSubresource.aspectMask =
+            vk::ImageAspectFlagBits::eColor;
+        regiao.imageSubresource.mipLevel = nivel;
+        regiao.imageSubresource.baseArrayLayer = 0;
+        regiao.imageSubresource.layerCount = 1;
+        regiao.imageOffset = vk::Offset3D{
+            0, static_cast<int32_t>(primeiroTexel), 0};
+        regiao.imageExtent = vk::Extent3D{largura, texels, 1u};
+        comando().copyBufferToImage(
+            fatia.buffer, destino,
+            vk::ImageLayout::eTransferDstOptimal, regiao);
+    }
+}
+
+ContextoDeEnvio::Entrega ContextoDeEnvio::entregaDeImagem(
+    const vk::ImageMemoryBarrier& barreira,
+    vk::ImageLayout layoutFinal,
+    vk::PipelineStageFlags estagioDestino,
+    vk::AccessFlags acessoDestino) {
+    Entrega entrega{};
+    entrega.ehImagem = true;
+    entrega.estagioDestino = estagioDestino;
+    entrega.imagem = barreira;
+    entrega.imagem.srcAccessMask =
+        vk::AccessFlagBits::eTransferWrite;
+    entrega.imagem.dstAccessMask = acessoDestino;
+    entrega.imagem.oldLayout =
+        vk::ImageLayout::eTransferDstOptimal;
+    entrega.imagem.newLayout = layoutFinal;
+    return entrega;
+}
+
+FatiaDePreparo ContextoDeEnvio::reservar(
+    vk::DeviceSize tamanho,
+    vk::DeviceSize alinhamento) {
+    auto fatia = anelDePreparo_->reservar(tamanho, alinhamento);
+
+    // Com o anel cheio de fatias deste próprio lote, o lote é
+    // submetido mais cedo para que o envio continue em
+    // pedaços.
+    if (!fatia.has_value()) {
+        if (anelDePreparo_->possuiPendentes()) {
+            submeter();
+        }
+        fatia = anelDePreparo_->reservarEsperando(tamanho,
+                                                  alinhamento);
+    }
+
+    if (!fatia.has_value()) {
+        throw std::runtime_error(
+            "O anel de preparo não comporta o envio.");
+    }
+
+    return fatia.value();
+}
+
+vk::CommandBuffer ContextoDeEnvio::comando() {
+    if (!comandoAtual_) {
+        comandoAtual_ = alocarComando(poolDeTransferencia_);
+
+        vk::CommandBufferBeginInfo info;
+        info.flags =
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+        comandoAtual_.begin(info);
+    }
+
+    return comandoAtual_;
+}
+
+void ContextoDeEnvio::submeter() {
+    if (!comandoAtual_) {
+        return;
+    }
+
+    Lote lote;
+    lote.transferencia = comandoAtual_;
+    lote.cerca = obterCerca();
+    comandoAtual_ = nullptr;
+
+    if (usaFilaDedicada()) {
+        lote.aquisicao = alocarComando(poolDeGraficos_);
+        vk::CommandBufferBeginInfo info;
+        info.flags =
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+        lote.aquisicao.begin(info);
+    }
+
+    gravarEntregas(lote.transferencia, lote.aquisicao);
+    lote.transferencia.end();
+
+    vk::SubmitInfo infoTransferencia;
+    infoTransferencia.commandBufferCount = 1;
+    infoTransferencia.pCommandBuffers = &lote.transferencia;
+
+    if (usaFilaDedicada()) {
+        lote.aquisicao.end();
+
+        if (semaforosLivres_.empty()) {
+            lote.semaforo = dispositivo_.createSemaphore(
+                vk::SemaphoreCreateInfo{});
+        } else {
+            lote.semaforo = semaforosLivres_.back();
+            semaforosLivres_.pop_back();
+        }
+
+        infoTransferencia.signalSemaphoreCount = 1;
+        infoTransferencia.pSignalSemaphores = &lote.semaforo;
+        filaDeTransferencia_.submit(
+            infoTransferencia, anelDePreparo_->fecharLote());
+
+        vk::PipelineStageFlags estagioDeEspera =
+            vk::PipelineStageFlagBits::eAllCommands;
+        vk::SubmitInfo infoAquisicao;
+        infoAquisicao.waitSemaphoreCount = 1;
+        infoAquisicao.pWaitSemaphores = &lote.semaforo;
+        infoAquisicao.pWaitDstStageMask = &estagioDeEspera;
+        infoAquisicao.commandBufferCount = 1;
+        infoAquisicao.pCommandBuffers = &lote.aquisicao;
+        filaDeGraficos_.submit(infoAquisicao, lote.cerca);
+    } else {
+        filaDeTransferencia_.submit(
+            infoTransferencia, anelDePreparo_->fecharLote());
+        // Submissão vazia, só para sabermos quando o buffer de
+        // comandos pode ser liberado.
+        filaDeTransferencia_.submit(nullptr, lote.cerca);
+    }
+
+    lotesEmExecucao_.push_back(lote);
+}
+
+void ContextoDeEnvio::gravarEntregas(
+    vk::CommandBuffer transferencia,
+    vk::CommandBuffer aquisicao) {
+    if (entregasPendentes_.empty()) {
+        return;
+    }
+
+    std::vector<vk::BufferMemoryBarrier> liberacoesDeBuffers,
+        aquisicoesDeBuffers;
+    std::vector<vk::ImageMemoryBarrier> liberacoesDeImagens,
+        aquisicoesDeImagens;
+    std::vector<Entrega> comMipmaps;
+    vk::PipelineStageFlags estagiosDestino;
+
+    for (auto&& entrega : entregasPendentes_) {
+        if (entrega.ehImagem && entrega.gerarMipmaps) {
+            comMipmaps.push_back(entrega);
+        }
+        estagiosDestino |= entrega.estagioDestino;
+
+        if (entrega.ehImagem) {
+            auto liberacao = entrega.imagem;
+            if (usaFilaDedicada()) {
+                liberacao.dstAccessMask = {};
+                liberacao.srcQueueFamilyIndex =
+                    familiaDeTransferencia_;
+                liberacao.dstQueueFamilyIndex =
+                    familiaDeGraficos_;
+                auto aquisicaoDaImagem = liberacao;
+                aquisicaoDaImagem.srcAccessMask = {};
+                aquisicaoDaImagem.dstAccessMask =
+                    entrega.imagem.dstAccessMask;
+                aquisicoesDeImagens.push_back(
+                    aquisicaoDaImagem);
+            }
+            liberacoesDeImagens.push_back(liberacao);
+        } else {
+            auto liberacao = entrega.buffer;
+            if (usaFilaDedicada()) {
+                liberacao.dstAccessMask = {};
+                liberacao.srcQueueFamilyIndex =
+                    familiaDeTransferencia_;
+                liberacao.dstQueueFamilyIndex =
+                    familiaDeGraficos_;
+                auto aquisicaoDoBuffer = liberacao;
+                aquisicaoDoBuffer.srcAccessMask = {};
+                aquisicaoDoBuffer.dstAccessMask =
+                    entrega.buffer.dstAccessMask;
+                aquisicoesDeBuffers.push_back(
+                    aquisicaoDoBuffer);
+            }
+            liberacoesDeBuffers.push_back(liberacao);
+        }
+    }
+    entregasPendentes_.clear();
+
+    if (usaFilaDedicada()) {
+        transferencia.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eBottomOfPipe, {},
+            nullptr, liberacoesDeBuffers, liberacoesDeImagens);
+        aquisicao.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTopOfPipe,
+            estagiosDestino, {}, nullptr, aquisicoesDeBuffers,
+            aquisicoesDeImagens);
+    } else {
+        transferencia.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            estagiosDestino, {}, nullptr, liberacoesDeBuffers,
+            liberacoesDeImagens);
+    }
+
+    // O blit precisa de uma fila de gráficos, que é a da
+    // aquisição quando a transferência é dedicada.
+    for (const auto& entrega : comMipmaps) {
+        gravarMipmaps(usaFilaDedicada() ? aquisicao
+                                        : transferencia,
+                      entrega);
+    }
+}
+
+void ContextoDeEnvio::gravarMipmaps(vk::CommandBuffer comando,
+                                    const Entrega& entrega) {
+    vk::ImageMemoryBarrier barreira;
+    barreira.image = entrega.imagem.image;
+    barreira.subresourceRange.aspectMask =
+        vk::ImageAspectFlagBits::eColor;
+    barreira.subresourceRange.levelCount = 1;
+    barreira.subresourceRange.layerCount = 1;
+
+    auto largura =
+        static_cast<int32_t>(entrega.dimensoes.width);
+    auto altura =
+        static_cast<int32_t>(entrega.dimensoes.height);
+    for (uint32_t nivel = 1; nivel < entrega.numNiveis;
+         nivel++) {
+        // O nível anterior vira a origem do blit.
+        barreira.subresourceRange.baseMipLevel = nivel - 1;
+        barreira.srcAccessMask =
+            vk::AccessFlagBits::eTransferWrite;
+        barreira.dstAccessMask =
+            vk::AccessFlagBits::eTransferRead;
+        barreira.oldLayout =
+            vk::ImageLayout::eTransferDstOptimal;
+        barreira.newLayout =
+            vk::ImageLayout::eTransferSrcOptimal;
+        comando.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            vk::PipelineStageFlagBits::eTransfer, {}, nullptr,
+            nullptr, barreira);
+
+        int32_t larguraDoNivel = std::max(largura / 2, 1);
+        int32_t alturaDoNivel = std::max(altura / 2, 1);
+        vk::ImageBlit blit;
+        blit.srcSubresource = vk::ImageSubresourceLayers{
+            vk::ImageAspectFlagBits::eColor, nivel - 1, 0, 1};
+        blit.srcOffsets[1] = vk::Offset3D{largura, altura, 1};
+        blit.dstSubresource = vk::ImageSubresourceLayers{
+            vk::ImageAspectFlagBits::eColor, nivel, 0, 1};
+        blit.dstOffsets[1] =
+            vk::Offset3D{larguraDoNivel, alturaDoNivel, 1};
+        comando.blitImage(entrega.imagem.image,
+                          vk::ImageLayout::eTransferSrcOptimal,
+                          entrega.imagem.image,
+                          vk::ImageLayout::eTransferDstOptimal,
+                          blit, vk::Filter::eLinear);
+
+        barreira.srcAccessMask =
+            vk::AccessFlagBits::eTransferRead;
+        barreira.dstAccessMask = entrega.acessoFinal;
+        barreira.oldLayout =
+            vk::ImageLayout::eTransferSrcOptimal;
+        barreira.newLayout = entrega.layoutFinal;
+        comando.pipelineBarrier(
+            vk::PipelineStageFlagBits::eTransfer,
+            entrega.estagioFinal, {}, nullptr, nullptr,
+            barreira);
+
+        largura = larguraDoNivel;
+        altura = alturaDoNivel;
+    }
+
+    // O último nível só foi escrito.
+    barreira.subresourceRange.baseMipLevel =
+        entrega.numNiveis - 1;
+    barreira.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barreira.dstAccessMask = entrega.acessoFinal;
+    barreira.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    barreira.newLayout = entrega.layoutFinal;
+    comando.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        entrega.estagioFinal, {}, nullptr, nullptr, barreira);
+}
+
+void ContextoDeEnvio::esperar() {
+    for (auto&& lote : lotesEmExecucao_) {
+        std::ignore = dispositivo_.waitForFences(
+            lote.cerca, false,
+            std::numeric_limits<uint64_t>::max());
+    }
+    reciclar();
+}
+
+void ContextoDeEnvio::reciclar() {
+    while (!lotesEmExecucao_.empty()) {
+        auto& lote = lotesEmExecucao_.front();
+        if (dispositivo_.getFenceStatus(lote.cerca) !=
+            vk::Result::eSuccess) {
+            break;
+        }
+
+        dispositivo_.freeCommandBuffers(poolDeTransferencia_,
+                                        lote.transferencia);
+        if (lote.aquisicao) {
+            dispositivo_.freeCommandBuffers(poolDeGraficos_,
+                                            lote.aquisicao);
+        }
+        if (lote.semaforo) {
+            semaforosLivres_.push_back(lote.semaforo);
+        }
+        dispositivo_.resetFences(lote.cerca);
+        cercasLivres_.push_back(lote.cerca);
+        lotesEmExecucao_.pop_front();
+    }
+
+    anelDePreparo_->reciclar();
+}
+
+vk::CommandBuffer ContextoDeEnvio::alocarComando(
+    vk::CommandPool pool) {
+    vk::CommandBufferAllocateInfo info;
+    info.commandPool = pool;
+    info.commandBufferCount = 1;
+
+    return dispositivo_.allocateCommandBuffers(info)[0];
+}
+
+vk::Fence ContextoDeEnvio::obterCerca() {
+    if (cercasLivres_.empty()) {
+        return dispositivo_.createFence(vk::FenceCreateInfo{});
+    }
+
+    vk::Fence cerca = cercasLivres_.back();
+    cercasLivres_.pop_back();
+    return cerca;
+}
+}  // namespace smv
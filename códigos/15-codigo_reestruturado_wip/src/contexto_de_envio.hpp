@@ -0,0 +1,148 @@
+#ifndef SMV_CONTEXTO_DE_ENVIO_HPP
+#define SMV_CONTEXTO_DE_ENVIO_HPP
+
+#include <deque>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "anel_de_preparo.hpp"
+
+namespace smv {
+// Um nível de mip já pronto, comprimido ou não.
+struct NivelDeImagem {
+    const void* dados;
+    uint32_t largura;
+    uint32_t altura;
+};
+
+// Grava vários envios (cópias e barreiras) num mesmo buffer de
+// comandos e os submete de uma vez, de preferência numa fila
+// só de transferência.
+//
+// Quando a fila de transferência é de outra família, a posse
+// dos recursos é liberada nela e adquirida na fila de
+// gráficos, que espera a transferência por um semáforo. Nada
+// aqui espera a fila ficar ociosa.
+class ContextoDeEnvio {
+  public:
+    void iniciar(vk::Device dispositivo,
+                 AnelDePreparo& anelDePreparo,
+                 uint32_t familiaDeTransferencia,
+                 vk::Queue filaDeTransferencia,
+                 uint32_t familiaDeGraficos,
+                 vk::Queue filaDeGraficos);
+    void destruir();
+
+    void enviarParaBuffer(
+        vk::Buffer destino,
+        vk::DeviceSize deslocamento,
+        const void* dados,
+        vk::DeviceSize tamanho,
+        vk::PipelineStageFlags estagioDestino =
+            vk::PipelineStageFlagBits::eAllCommands,
+        vk::AccessFlags acessoDestino =
+            vk::AccessFlagBits::eMemoryRead);
+    // Envia os texels para o nível 0 da imagem e a deixa em
+    // `layoutFinal`. Com `numNiveis` maior que 1, os outros
+    // níveis são gerados reduzindo o anterior com blitImage na
+    // fila de gráficos, então o formato precisa suportar blit
+    // com filtro linear e a imagem precisa do uso eTransferSrc.
+    void enviarParaImagem(
+        vk::Image destino,
+        const void* texels,
+        uint32_t largura,
+        uint32_t altura,
+        uint32_t bytesPorTexel,
+        vk::ImageLayout layoutFinal,
+        vk::PipelineStageFlags estagioDestino,
+        vk::AccessFlags acessoDestino,
+        uint32_t numNiveis = 1);
+    // Envia níveis prontos, a partir do nível 0, em blocos de
+    // `ladoDoBloco` x `ladoDoBloco` texels. Formatos sem
+    // compressão usam blocos de 1 texel.
+    void enviarNiveisParaImagem(
+        vk::Image destino,
+        const std::vector<NivelDeImagem>& niveis,
+        uint32_t bytesPorBloco,
+        uint32_t ladoDoBloco,
+        vk::ImageLayout layoutFinal,
+        vk::PipelineStageFlags estagioDestino,
+        vk::AccessFlags acessoDestino);
+
+    void submeter();
+    void esperar();
+    void reciclar();
+
+    bool usaFilaDedicada() const {
+        return familiaDeTransferencia_ != familiaDeGraficos_;
+    }
+
+  private:
+    struct Lote {
+        vk::CommandBuffer transferencia;
+        vk::CommandBuffer aquisicao;
+        vk::Semaphore semaforo;
+        vk::Fence cerca;
+    };
+
+    struct Entrega {
+        vk::BufferMemoryBarrier buffer;
+        vk::ImageMemoryBarrier imagem;
+        bool ehImagem;
+        vk::PipelineStageFlags estagioDestino;
+        // Imagens com níveis de mip a gerar chegam à fila de
+        // gráficos em eTransferDstOptimal, e só vão para o
+        // destino final em gravarMipmaps.
+        bool gerarMipmaps;
+        uint32_t numNiveis;
+        vk::Extent2D dimensoes;
+        vk::ImageLayout layoutFinal;
+        vk::PipelineStageFlags estagioFinal;
+        vk::AccessFlags acessoFinal;
+    };
+
+    vk::ImageMemoryBarrier prepararImagem(vk::Image destino,
+                                          uint32_t numNiveis);
+    void copiarParaNivel(vk::Image destino,
+                         uint32_t nivel,
+                         const void* dados,
+                         uint32_t largura,
+                         uint32_t altura,
+                         uint32_t bytesPorBloco,
+                         uint32_t ladoDoBloco);
+    Entrega entregaDeImagem(
+        const vk::ImageMemoryBarrier& barreira,
+        vk::ImageLayout layoutFinal,
+        vk::PipelineStageFlags estagioDestino,
+        vk::AccessFlags acessoDestino);
+    FatiaDePreparo reservar(vk::DeviceSize tamanho,
+                            vk::DeviceSize alinhamento);
+    vk::CommandBuffer comando();
+    void gravarEntregas(vk::CommandBuffer transferencia,
+                        vk::CommandBuffer aquisicao);
+    void gravarMipmaps(vk::CommandBuffer comando,
+                       const Entrega& entrega);
+    vk::CommandBuffer alocarComando(vk::CommandPool pool);
+    vk::Fence obterCerca();
+
+    vk::Device dispositivo_;
+    AnelDePreparo* anelDePreparo_ = nullptr;
+
+    uint32_t familiaDeTransferencia_;
+    vk::Queue filaDeTransferencia_;
+    vk::CommandPool poolDeTransferencia_;
+    uint32_t familiaDeGraficos_;
+    vk::Queue filaDeGraficos_;
+    vk::CommandPool poolDeGraficos_;
+
+    vk::CommandBuffer comandoAtual_;
+    std::vector<Entrega> entregasPendentes_;
+
+    std::deque<Lote> lotesEmExecucao_;
+    std::vector<vk::Fence> cercasLivres_;
+    std::vector<vk::Semaphore> semaforosLivres_;
+};
+}  // namespace smv
+
+#endif
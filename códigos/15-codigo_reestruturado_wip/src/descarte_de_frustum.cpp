@@ -0,0 +1,259 @@
+#include "descarte_de_frustum.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+// O SSE2 faz parte de todo x86-64. O AVX2 é escolhido na hora,
+// pelo processador, e só com GCC ou Clang, que compilam uma
+// função para ele sem compilar o resto do motor.
+#if defined(__SSE2__) || defined(_M_X64)
+#define SMV_POSSUI_SSE
+#include <immintrin.h>
+#endif
+#if defined(SMV_POSSUI_SSE) && defined(__GNUC__)
+#define SMV_POSSUI_AVX2
+#endif
+
+namespace smv {
+namespace {
+constexpr size_t kLarguraDoBloco = 8;
+
+// Esferas da folga, que ficam atrás de qualquer plano.
+constexpr float kRaioDaFolga =
+    std::numeric_limits<float>::lowest();
+
+struct Esferas {
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* raio;
+    size_t tamanho;
+};
+
+// Sem desvios: o índice é sempre escrito, e só a contagem
+// depende da máscara. Então cabe escrever até um índice além
+// dos visíveis, o que a folga dos arrays garante.
+size_t emitir(unsigned mascara,
+              unsigned largura,
+              size_t base,
+              uint32_t* visiveis,
+              size_t numVisiveis) {
+    for (unsigned k = 0; k < largura; k++) {
+        visiveis[numVisiveis] = static_cast<uint32_t>(base + k);
+        numVisiveis += (mascara >> k) & 1u;
+    }
+    return numVisiveis;
+}
+
+size_t descartarEscalar(const Esferas& esferas,
+                        const std::array<glm::vec4, 6>& planos,
+                        uint32_t* visiveis) {
+    size_t numVisiveis = 0;
+    for (size_t i = 0; i < esferas.tamanho; i++) {
+        unsigned dentro = 1;
+        for (const auto& plano : planos) {
+            float distancia = plano.x * esferas.x[i] +
+                              plano.y * esferas.y[i] +
+                              plano.z * esferas.z[i] + plano.w;
+            dentro &= static_cast<unsigned>(
+                distancia + esferas.raio[i] >= 0.0f);
+        }
+        numVisiveis =
+            emitir(dentro, 1, i, visiveis, numVisiveis);
+    }
+    return numVisiveis;
+}
+
+#ifdef SMV_POSSUI_SSE
+size_t descartarSse(const Esferas& esferas,
+                    const std::array<glm::vec4, 6>& planos,
+                    uint32_t* visiveis) {
+    __m128 px[6], py[6], pz[6], pw[6];
+    for (size_t k = 0; k < planos.size(); k++) {
+        px[k] = _mm_set1_ps(planos[k].x);
+        py[k] = _mm_set1_ps(planos[k].y);
+        pz[k] = _mm_set1_ps(planos[k].z);
+        pw[k] = _mm_set1_ps(planos[k].w);
+    }
+    __m128 zero = _mm_setzero_ps();
+
+    size_t numVisiveis = 0;
+    for (size_t i = 0; i < esferas.tamanho; i += 4) {
+        __m128 x = _mm_loadu_ps(esferas.x + i);
+        __m128 y = _mm_loadu_ps(esferas.y + i);
+        __m128 z = _mm_loadu_ps(esferas.z + i);
+        __m128 raio = _mm_loadu_ps(esferas.raio + i);
+        __m128 dentro = _mm_cmpeq_ps(zero, zero);
+        for (size_t k = 0; k < planos.size(); k++) {
+            __m128 distancia = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(px[k], x),
+                           _mm_mul_ps(py[k], y)),
+                _mm_add_ps(_mm_mul_ps(pz[k], z),
+                           _mm_add_ps(pw[k], raio)));
+            dentro = _mm_and_ps(
+                dentro, _mm_cmpge_ps(distancia, zero));
+        }
+        auto mascara =
+            static_cast<unsigned>(_mm_movemask_ps(dentro));
+        numVisiveis =
+            emitir(mascara, 4, i, visiveis, numVisiveis);
+    }
+    return numVisiveis;
+}
+#endif
+
+#ifdef SMV_POSSUI_AVX2
+// Para cada máscara de 8 esferas, as posições das visíveis, um
+// byte cada, juntas no começo.
+constexpr std::array<uint64_t, 256> tabelaDeCompactacao() {
+    std::array<uint64_t, 256> tabela{};
+    for (unsigned mascara = 0; mascara < 256; mascara++) {
+        unsigned n = 0;
+        for (unsigned k = 0; k < 8; k++) {
+            if ((mascara >> k) & 1u) {
+                tabela[mascara] |= uint64_t{k} << (8 * n++);
+            }
+        }
+    }
+    return tabela;
+}
+constexpr auto kTabelaDeCompactacao = tabelaDeCompactacao();
+
+__attribute__((target("avx2,fma"))) size_t descartarAvx2(
+    const Esferas& esferas,
+    const std::array<glm::vec4, 6>& planos,
+    uint32_t* visiveis) {
+    __m256 px[6], py[6], pz[6], pw[6];
+    for (size_t k = 0; k < planos.size(); k++) {
+        px[k] = _mm256_set1_ps(planos[k].x);
+        py[k] = _mm256_set1_ps(planos[k].y);
+        pz[k] = _mm256_set1_ps(planos[k].z);
+        pw[k] = _mm256_set1_ps(planos[k].w);
+    }
+    __m256 zero = _mm256_setzero_ps();
+    __m256i posicoes =
+        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    size_t numVisiveis = 0;
+    for (size_t i = 0; i < esferas.tamanho; i += 8) {
+        __m256 x = _mm256_loadu_ps(esferas.x + i);
+        __m256 y = _mm256_loadu_ps(esferas.y + i);
+        __m256 z = _mm256_loadu_ps(esferas.z + i);
+        __m256 raio = _mm256_loadu_ps(esferas.raio + i);
+        __m256 dentro = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+        for (size_t k = 0; k < planos.size(); k++) {
+            __m256 distancia = _mm256_add_ps(pw[k], raio);
+            distancia = _mm256_fmadd_ps(pz[k], z, distancia);
+            distancia = _mm256_fmadd_ps(py[k], y, distancia);
+            distancia = _mm256_fmadd_ps(px[k], x, distancia);
+            dentro = _mm256_and_ps(
+                dentro,
+                _mm256_cmp_ps(distancia, zero, _CMP_GE_OQ));
+        }
+        // Os 8 índices são escritos de uma vez, com os visíveis
+        // permutados para o começo.
+        auto mascara =
+            static_cast<unsigned>(_mm256_movemask_ps(dentro));
+        __m256i permutacao =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+                reinterpret_cast<const __m128i*>(
+                    &kTabelaDeCompactacao[mascara])));
+        __m256i indices = _mm256_add_epi32(
+            _mm256_set1_epi32(static_cast<int>(i)), posicoes);
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(visiveis + numVisiveis),
+            _mm256_permutevar8x32_epi32(indices, permutacao));
+        numVisiveis += static_cast<unsigned>(
+            __builtin_popcount(mascara));
+    }
+    return numVisiveis;
+}
+#endif
+}  // namespace
+
+void DescarteDeFrustum::limpar() {
+    x_.clear();
+    y_.clear();
+    z_.clear();
+    raio_.clear();
+    tamanho_ = 0;
+}
+
+uint32_t DescarteDeFrustum::adicionar(const glm::vec4& esfera) {
+    if (tamanho_ == x_.size()) {
+        size_t novoTamanho = tamanho_ + kLarguraDoBloco;
+        x_.resize(novoTamanho, 0.0f);
+        y_.resize(novoTamanho, 0.0f);
+        z_.resize(novoTamanho, 0.0f);
+        raio_.resize(novoTamanho, kRaioDaFolga);
+    }
+    x_[tamanho_] = esfera.x;
+    y_[tamanho_] = esfera.y;
+    z_[tamanho_] = esfera.z;
+    raio_[tamanho_] = esfera.w;
+    return static_cast<uint32_t>(tamanho_++);
+}
+
+size_t DescarteDeFrustum::descartar(
+    const std::array<glm::vec4, 6>& planos,
+    std::vector<uint32_t>& visiveis,
+    ConjuntoDeInstrucoes conjunto) const {
+    if (!suporta(conjunto)) {
+        throw std::logic_error(
+            "O processador não tem o conjunto de instruções "
+            "pedido.");
+    }
+    if (visiveis.size() < x_.size()) {
+        visiveis.resize(x_.size());
+    }
+
+    Esferas esferas{x_.data(), y_.data(), z_.data(),
+                    raio_.data(), x_.size()};
+    switch (conjunto) {
+#ifdef SMV_POSSUI_AVX2
+        case ConjuntoDeInstrucoes::eAvx2:
+            return descartarAvx2(esferas, planos,
+                                 visiveis.data());
+#endif
+#ifdef SMV_POSSUI_SSE
+        case ConjuntoDeInstrucoes::eSse:
+            return descartarSse(esferas, planos,
+                                visiveis.data());
+#endif
+        default:
+            return descartarEscalar(esferas, planos,
+                                    visiveis.data());
+    }
+}
+
+bool DescarteDeFrustum::suporta(ConjuntoDeInstrucoes conjunto) {
+    switch (conjunto) {
+        case ConjuntoDeInstrucoes::eEscalar:
+            return true;
+        case ConjuntoDeInstrucoes::eSse:
+#ifdef SMV_POSSUI_SSE
+            return true;
+#else
+            return false;
+#endif
+        case ConjuntoDeInstrucoes::eAvx2:
+#ifdef SMV_POSSUI_AVX2
+            return __builtin_cpu_supports("avx2") &&
+                   __builtin_cpu_supports("fma");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+ConjuntoDeInstrucoes DescarteDeFrustum::melhorConjunto() {
+    for (auto conjunto : {ConjuntoDeInstrucoes::eAvx2,
+                          ConjuntoDeInstrucoes::eSse}) {
+        if (suporta(conjunto)) {
+            return conjunto;
+        }
+    }
+    return ConjuntoDeInstrucoes::eEscalar;
+}
+}  // namespace smv
@@ -0,0 +1,50 @@
+#ifndef SMV_DESCARTE_DE_FRUSTUM_HPP
+#define SMV_DESCARTE_DE_FRUSTUM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace smv {
+enum class ConjuntoDeInstrucoes { eEscalar, eSse, eAvx2 };
+
+// Esferas envolventes guardadas como estrutura de arrays, um
+// array por coordenada, para que o teste contra os planos do
+// frustum rode em 4 esferas por instrução com SSE e em 8 com
+// AVX2. Os arrays são completados até um múltiplo de 8 com
+// esferas que nunca ficam visíveis, então os laços não têm
+// resto.
+class DescarteDeFrustum {
+  public:
+    void limpar();
+    // Retorna o índice da esfera, que é a ordem de adição. O
+    // raio fica no w.
+    uint32_t adicionar(const glm::vec4& esfera);
+    size_t tamanho() const { return tamanho_; }
+
+    // Escreve no começo de `visiveis`, em ordem, os índices das
+    // esferas que não estão inteiramente atrás de nenhum dos
+    // planos e retorna quantas são. Os planos têm as normais
+    // normalizadas e para dentro, como os de Gribb e Hartmann.
+    // `visiveis` só cresce, e o que passa do retorno é lixo.
+    size_t descartar(
+        const std::array<glm::vec4, 6>& planos,
+        std::vector<uint32_t>& visiveis,
+        ConjuntoDeInstrucoes conjunto = melhorConjunto()) const;
+
+    static bool suporta(ConjuntoDeInstrucoes conjunto);
+    static ConjuntoDeInstrucoes melhorConjunto();
+
+  private:
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> z_;
+    std::vector<float> raio_;
+    size_t tamanho_ = 0;
+};
+}  // namespace smv
+
+#endif
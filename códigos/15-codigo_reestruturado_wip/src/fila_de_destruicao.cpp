@@ -0,0 +1,26 @@
+#include "fila_de_destruicao.hpp"
+
+namespace smv {
+void FilaDeDestruicao::adiar(std::function<void()> destruir) {
+    pendentes_.push_back({quadroAtual_, std::move(destruir)});
+}
+
+void FilaDeDestruicao::coletar() {
+    // Os pendentes estão em ordem de quadro.
+    while (!pendentes_.empty() &&
+           pendentes_.front().quadro + quadrosEmExecucao_ <=
+               quadroAtual_) {
+        auto destruir = std::move(pendentes_.front().destruir);
+        pendentes_.pop_front();
+        destruir();
+    }
+}
+
+void FilaDeDestruicao::destruirTudo() {
+    while (!pendentes_.empty()) {
+        auto destruir = std::move(pendentes_.front().destruir);
+        pendentes_.pop_front();
+        destruir();
+    }
+}
+}  // namespace smv
@@ -0,0 +1,44 @@
+#ifndef SMV_FILA_DE_DESTRUICAO_HPP
+#define SMV_FILA_DE_DESTRUICAO_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace smv {
+// Adia a destruição de recursos até que todos os quadros que
+// podem referenciá-los tenham terminado na GPU, para que
+// redimensionar a janela ou descarregar um recurso não precise
+// esperar o dispositivo inteiro ficar ocioso.
+//
+// Um recurso entregue durante o quadro N só é destruído depois
+// que a cerca do quadro N for esperada, o que acontece no
+// começo do quadro N + quadrosEmExecucao.
+class FilaDeDestruicao {
+  public:
+    void iniciar(uint64_t quadrosEmExecucao) {
+        quadrosEmExecucao_ = quadrosEmExecucao;
+    }
+
+    void adiar(std::function<void()> destruir);
+
+    // Chamado depois de esperar a cerca do quadro atual.
+    void coletar();
+    void avancarQuadro() { quadroAtual_++; }
+
+    // Só depois que o dispositivo estiver ocioso.
+    void destruirTudo();
+
+  private:
+    struct Pendente {
+        uint64_t quadro;
+        std::function<void()> destruir;
+    };
+
+    uint64_t quadrosEmExecucao_ = 0;
+    uint64_t quadroAtual_ = 0;
+    std::deque<Pendente> pendentes_;
+};
+}  // namespace smv
+
+#endif
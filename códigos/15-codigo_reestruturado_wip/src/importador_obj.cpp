@@ -0,0 +1,233 @@
+#include "importador_obj.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+namespace smv {
+namespace {
+Vertice montarVertice(const tinyobj::attrib_t& atributos,
+                      const tinyobj::index_t& indice) {
+    Vertice vertice{};
+
+    uint32_t indiceDoVertice =
+        static_cast<uint32_t>(indice.vertex_index);
+    vertice.posicao = {
+        atributos.vertices[(3 * indiceDoVertice) + 0],
+        atributos.vertices[(3 * indiceDoVertice) + 1],
+        atributos.vertices[(3 * indiceDoVertice) + 2]};
+
+    vertice.cor = {atributos.colors[(3 * indiceDoVertice) + 0],
+                   atributos.colors[(3 * indiceDoVertice) + 1],
+                   atributos.colors[(3 * indiceDoVertice) + 2]};
+
+    uint32_t indiceDaCoordTex =
+        static_cast<uint32_t>(indice.texcoord_index);
+    vertice.coordTex = {
+        atributos.texcoords[(2 * indiceDaCoordTex) + 0],
+        1.0f -
+            atributos.texcoords[(2 * indiceDaCoordTex) + 1]};
+
+    return vertice;
+}
+
+void juntarEmSerie(const tinyobj::attrib_t& atributos,
+                   const std::vector<tinyobj::shape_t>& formas,
+                   std::vector<Vertice>& vertices,
+                   std::vector<uint32_t>& indices) {
+    std::unordered_map<Vertice, uint32_t> verticesUnicos;
+    for (const auto& forma : formas) {
+        for (const auto& indice : forma.mesh.indices) {
+            Vertice vertice = montarVertice(atributos, indice);
+            auto id = static_cast<uint32_t>(vertices.size());
+            auto [unico, novo] =
+                verticesUnicos.try_emplace(vertice, id);
+            if (novo) {
+                vertices.push_back(vertice);
+            }
+            indices.push_back(unico->second);
+        }
+    }
+}
+
+// Roda `funcao(i)` numa thread própria para cada i em
+// [0, numThreads) e espera todas terminarem.
+template <typename F>
+void emParalelo(unsigned numThreads, F&& funcao) {
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+    for (unsigned i = 0; i < numThreads; i++) {
+        threads.emplace_back(funcao, i);
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+}
+
+// Os bits baixos do hash também escolhem o balde dentro de
+// cada tabela, então o fragmento vem de uma mistura deles.
+unsigned fragmentoDoVertice(const Vertice& vertice,
+                            unsigned numFragmentos) {
+    uint64_t hash = std::hash<Vertice>()(vertice);
+    hash *= 0x9e3779b97f4a7c15ull;
+    return static_cast<unsigned>((hash >> 32) % numFragmentos);
+}
+
+// Chamamos de canto cada uso de um vértice pelas faces, na
+// ordem em que aparecem no arquivo. A junção é feita em três
+// passos:
+//
+// 1. Cada thread monta os vértices de um trecho contíguo de
+//    cantos e os separa pelo fragmento do seu hash.
+// 2. Cada thread junta os vértices de um fragmento, visitando
+//    os cantos em ordem, e guarda para cada canto o primeiro
+//    canto com o mesmo vértice.
+// 3. Os cantos que são o primeiro uso do seu vértice recebem
+//    ids em ordem, como na junção serial, usando a contagem
+//    de vértices novos dos trechos anteriores.
+void juntarEmParalelo(
+    const tinyobj::attrib_t& atributos,
+    const std::vector<tinyobj::shape_t>& formas,
+    unsigned numThreads,
+    std::vector<Vertice>& vertices,
+    std::vector<uint32_t>& indices) {
+    std::vector<size_t> inicioDaForma;
+    size_t numCantos = 0;
+    for (const auto& forma : formas) {
+        inicioDaForma.push_back(numCantos);
+        numCantos += forma.mesh.indices.size();
+    }
+    if (numCantos == 0) {
+        return;
+    }
+    if (numCantos > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error(
+            "O modelo tem cantos demais para ser importado.");
+    }
+    numThreads = static_cast<unsigned>(
+        std::min<size_t>(numThreads, numCantos));
+
+    auto trecho = [numCantos, numThreads](unsigned t) {
+        return std::make_pair(numCantos * t / numThreads,
+                              numCantos * (t + 1) / numThreads);
+    };
+
+    std::vector<Vertice> cantos(numCantos);
+    // [trecho][fragmento], com os cantos em ordem crescente.
+    std::vector<std::vector<std::vector<uint32_t>>>
+        cantosPorFragmento(
+            numThreads,
+            std::vector<std::vector<uint32_t>>(numThreads));
+    emParalelo(numThreads, [&](unsigned t) {
+        auto [inicio, fim] = trecho(t);
+        size_t forma = static_cast<size_t>(
+            std::upper_bound(inicioDaForma.begin(),
+                             inicioDaForma.end(), inicio) -
+            inicioDaForma.begin() - 1);
+        for (size_t canto = inicio; canto < fim; canto++) {
+            while (canto - inicioDaForma[forma] >=
+                   formas[forma].mesh.indices.size()) {
+                forma++;
+            }
+            const auto& indice =
+                formas[forma]
+                    .mesh.indices[canto - inicioDaForma[forma]];
+            cantos[canto] = montarVertice(atributos, indice);
+            unsigned fragmento =
+                fragmentoDoVertice(cantos[canto], numThreads);
+            cantosPorFragmento[t][fragmento].push_back(
+                static_cast<uint32_t>(canto));
+        }
+    });
+
+    std::vector<uint32_t> primeiroCanto(numCantos);
+    emParalelo(numThreads, [&](unsigned fragmento) {
+        std::unordered_map<Vertice, uint32_t> unicos;
+        for (unsigned t = 0; t < numThreads; t++) {
+            for (uint32_t canto :
+                 cantosPorFragmento[t][fragmento]) {
+                auto [unico, novo] =
+                    unicos.try_emplace(cantos[canto], canto);
+                primeiroCanto[canto] = unico->second;
+            }
+        }
+    });
+
+    std::vector<size_t> primeiroIdDoTrecho(numThreads);
+    emParalelo(numThreads, [&](unsigned t) {
+        auto [inicio, fim] = trecho(t);
+        size_t novos = 0;
+        for (size_t canto = inicio; canto < fim; canto++) {
+            if (primeiroCanto[canto] == canto) {
+                novos++;
+            }
+        }
+        primeiroIdDoTrecho[t] = novos;
+    });
+    size_t idBase = vertices.size();
+    for (auto&& primeiroId : primeiroIdDoTrecho) {
+        size_t novos = primeiroId;
+        primeiroId = idBase;
+        idBase += novos;
+    }
+
+    size_t primeiroIndice = indices.size();
+    vertices.resize(idBase);
+    indices.resize(primeiroIndice + numCantos);
+
+    std::vector<uint32_t> idDoCanto(numCantos);
+    emParalelo(numThreads, [&](unsigned t) {
+        auto [inicio, fim] = trecho(t);
+        size_t id = primeiroIdDoTrecho[t];
+        for (size_t canto = inicio; canto < fim; canto++) {
+            if (primeiroCanto[canto] == canto) {
+                vertices[id] = cantos[canto];
+                idDoCanto[canto] = static_cast<uint32_t>(id++);
+            }
+        }
+    });
+    // O primeiro canto de cada vértice pode estar em outro
+    // trecho, então só lemos os ids depois de todos prontos.
+    emParalelo(numThreads, [&](unsigned t) {
+        auto [inicio, fim] = trecho(t);
+        for (size_t canto = inicio; canto < fim; canto++) {
+            indices[primeiroIndice + canto] =
+                idDoCanto[primeiroCanto[canto]];
+        }
+    });
+}
+}  // namespace
+
+void importarObj(const std::string& caminho,
+                 std::vector<Vertice>& vertices,
+                 std::vector<uint32_t>& indices,
+                 unsigned numThreads) {
+    tinyobj::attrib_t atributos;
+    std::vector<tinyobj::shape_t> formas;
+    std::vector<tinyobj::material_t> _materiais;
+    std::string aviso, erro;
+    if (!tinyobj::LoadObj(&atributos, &formas, &_materiais,
+                          &aviso, &erro, caminho.c_str())) {
+        throw std::runtime_error("Aviso: " + aviso +
+                                 " Erro: " + erro);
+    }
+
+    if (numThreads == 0) {
+        numThreads =
+            std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (numThreads == 1) {
+        juntarEmSerie(atributos, formas, vertices, indices);
+    } else {
+        juntarEmParalelo(atributos, formas, numThreads,
+                         vertices, indices);
+    }
+}
+}  // namespace smv
@@ -0,0 +1,25 @@
+#ifndef SMV_IMPORTADOR_OBJ_HPP
+#define SMV_IMPORTADOR_OBJ_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "vertice.hpp"
+
+namespace smv {
+// Lê um arquivo OBJ e junta os vértices repetidos, gerando
+// índices de 32 bits para os vértices únicos. Quem usa a
+// malha escolhe a largura final dos índices.
+//
+// Com mais de uma thread, a junção é dividida entre elas, mas
+// o resultado é idêntico ao da junção serial: os vértices
+// ficam na ordem do seu primeiro uso. Zero usa todas as
+// threads do sistema.
+void importarObj(const std::string& caminho,
+                 std::vector<Vertice>& vertices,
+                 std::vector<uint32_t>& indices,
+                 unsigned numThreads = 0);
+}  // namespace smv
+
+#endif
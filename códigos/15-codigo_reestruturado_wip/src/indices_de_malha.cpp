@@ -0,0 +1,72 @@
+#include "indices_de_malha.hpp"
+
+#include <limits>
+
+namespace smv {
+std::vector<uint16_t> estreitarIndices(
+    const std::vector<uint32_t>& indices) {
+    std::vector<uint16_t> estreitos(indices.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+        estreitos[i] = static_cast<uint16_t>(indices[i]);
+    }
+    return estreitos;
+}
+
+std::vector<uint32_t> alargarIndices(const void* indices,
+                                     size_t numIndices,
+                                     vk::IndexType tipo) {
+    if (tipo == vk::IndexType::eUint32) {
+        auto largos = static_cast<const uint32_t*>(indices);
+        return {largos, largos + numIndices};
+    }
+    auto estreitos = static_cast<const uint16_t*>(indices);
+    return {estreitos, estreitos + numIndices};
+}
+
+std::vector<Submalha> dividirEmSubmalhas(
+    const std::vector<Vertice>& vertices,
+    const std::vector<uint32_t>& indices) {
+    constexpr uint32_t kSemIndiceLocal =
+        std::numeric_limits<uint32_t>::max();
+
+    std::vector<Submalha> submalhas(1);
+    // Índice de cada vértice da malha na submalha atual.
+    std::vector<uint32_t> indiceLocal(vertices.size(),
+                                      kSemIndiceLocal);
+    // Vértices da malha copiados para a submalha atual, para
+    // limpar `indiceLocal` ao começar a próxima.
+    std::vector<uint32_t> copiados;
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        size_t novos = 0;
+        for (size_t j = i; j < i + 3; j++) {
+            if (indiceLocal[indices[j]] == kSemIndiceLocal) {
+                novos++;
+            }
+        }
+        if (copiados.size() + novos >
+            kMaximoDeVerticesCom16Bits) {
+            for (uint32_t vertice : copiados) {
+                indiceLocal[vertice] = kSemIndiceLocal;
+            }
+            copiados.clear();
+            submalhas.emplace_back();
+        }
+
+        auto& submalha = submalhas.back();
+        for (size_t j = i; j < i + 3; j++) {
+            uint32_t vertice = indices[j];
+            if (indiceLocal[vertice] == kSemIndiceLocal) {
+                indiceLocal[vertice] = static_cast<uint32_t>(
+                    submalha.vertices.size());
+                submalha.vertices.push_back(vertices[vertice]);
+                copiados.push_back(vertice);
+            }
+            submalha.indices.push_back(
+                static_cast<uint16_t>(indiceLocal[vertice]));
+        }
+    }
+
+    return submalhas;
+}
+}  // namespace smv
@@ -0,0 +1,53 @@
+#ifndef SMV_INDICES_DE_MALHA_HPP
+#define SMV_INDICES_DE_MALHA_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "vertice.hpp"
+
+namespace smv {
+// Índices de 16 bits endereçam até o vértice 65535. Não usamos
+// primitive restart, então esse valor não é reservado.
+constexpr size_t kMaximoDeVerticesCom16Bits = 65536;
+
+// A menor largura de índice que endereça todos os vértices.
+inline vk::IndexType tipoDeIndiceParaVertices(
+    size_t numVertices) {
+    return numVertices <= kMaximoDeVerticesCom16Bits
+               ? vk::IndexType::eUint16
+               : vk::IndexType::eUint32;
+}
+
+inline uint32_t tamanhoDoIndice(vk::IndexType tipo) {
+    return tipo == vk::IndexType::eUint16 ? sizeof(uint16_t)
+                                          : sizeof(uint32_t);
+}
+
+// Só pode ser usado quando todos os índices cabem em 16 bits.
+std::vector<uint16_t> estreitarIndices(
+    const std::vector<uint32_t>& indices);
+
+// Lê `numIndices` índices do tipo `tipo` como 32 bits.
+std::vector<uint32_t> alargarIndices(const void* indices,
+                                     size_t numIndices,
+                                     vk::IndexType tipo);
+
+// Parte de uma malha grande endereçável com índices de 16
+// bits, com os próprios vértices.
+struct Submalha {
+    std::vector<Vertice> vertices;
+    std::vector<uint16_t> indices;
+};
+
+// Divide os triângulos da malha, em ordem, entre submalhas de
+// até kMaximoDeVerticesCom16Bits vértices. Os vértices usados
+// por triângulos de submalhas diferentes são repetidos.
+std::vector<Submalha> dividirEmSubmalhas(
+    const std::vector<Vertice>& vertices,
+    const std::vector<uint32_t>& indices);
+}  // namespace smv
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef SMV_LAYOUT_DE_VERTICE_HPP
+#define SMV_LAYOUT_DE_VERTICE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+// Um vértice declara os seus campos uma única vez, numa função
+// estática `campos()` que retorna uma tupla de
+// CampoDeVertice:
+//
+//   static constexpr auto campos() {
+//       return std::make_tuple(
+//           SMV_CAMPO(Vertice, posicao,
+//                     vk::Format::eR32G32B32Sfloat, 0), ...);
+//   }
+//
+// A location de cada atributo é a posição do campo na tupla.
+// As descrições de entrada da Vulkan, a igualdade e o hash são
+// gerados a partir dela.
+#define SMV_CAMPO(Tipo, membro, formato, associacao)       \
+    ::smv::CampoDeVertice<Tipo, decltype(Tipo::membro)> { \
+        &Tipo::membro,                                     \
+            static_cast<uint32_t>(offsetof(Tipo, membro)), \
+            formato, associacao                            \
+    }
+
+namespace smv {
+template <typename V, typename T>
+struct CampoDeVertice {
+    using Tipo = T;
+
+    T V::*membro;
+    // Deslocamento do campo na struct.
+    uint32_t deslocamento;
+    vk::Format formato;
+    uint32_t associacao;
+};
+
+// Os formatos de atributo de vértice usados pelo motor.
+constexpr uint32_t tamanhoDoFormato(vk::Format formato) {
+    switch (formato) {
+        case vk::Format::eR32G32B32A32Sfloat:
+            return 16;
+        case vk::Format::eR32G32B32Sfloat:
+            return 12;
+        case vk::Format::eR32G32Sfloat:
+        case vk::Format::eR16G16B16A16Unorm:
+        case vk::Format::eR16G16B16A16Snorm:
+        case vk::Format::eR16G16B16A16Sfloat:
+            return 8;
+        case vk::Format::eR32Sfloat:
+        case vk::Format::eR16G16Unorm:
+        case vk::Format::eR16G16Snorm:
+        case vk::Format::eR16G16Sfloat:
+        case vk::Format::eR8G8B8A8Unorm:
+        case vk::Format::eR8G8B8A8Snorm:
+            return 4;
+        case vk::Format::eR8G8Unorm:
+            return 2;
+        default:
+            throw std::logic_error(
+                "Formato de vértice sem tamanho conhecido.");
+    }
+}
+
+namespace detalhe {
+template <typename V, typename F>
+constexpr void paraCadaCampo(F&& funcao) {
+    std::apply(
+        [&funcao](const auto&... campos) {
+            (funcao(campos), ...);
+        },
+        V::campos());
+}
+
+// Combinação de hashes da Boost.
+inline void combinarHash(size_t& semente, size_t hash) {
+    semente ^= hash + 0x9e3779b9 + (semente << 6) +
+               (semente >> 2);
+}
+
+template <typename T>
+size_t hashDoCampo(const T& valor) {
+    return std::hash<T>()(valor);
+}
+
+template <typename T, size_t N>
+size_t hashDoCampo(const std::array<T, N>& valor) {
+    size_t semente = 0;
+    for (const auto& elemento : valor) {
+        combinarHash(semente, std::hash<T>()(elemento));
+    }
+    return semente;
+}
+}  // namespace detalhe
+
+template <typename V>
+constexpr uint32_t kNumAtributos = static_cast<uint32_t>(
+    std::tuple_size_v<decltype(V::campos())>);
+
+template <typename V>
+constexpr uint32_t numAssociacoes() {
+    uint32_t num = 0;
+    detalhe::paraCadaCampo<V>([&num](const auto& campo) {
+        num = std::max(num, campo.associacao + 1);
+    });
+    return num;
+}
+
+// Cada associação é um fluxo com os campos dela em ordem e sem
+// espaço entre eles. Com uma associação só, esse é o layout da
+// própria struct, e um vetor dela pode ir direto para a GPU.
+template <typename V>
+constexpr uint32_t tamanhoDoFluxo(uint32_t associacao) {
+    uint32_t tamanho = 0;
+    detalhe::paraCadaCampo<V>([&](const auto& campo) {
+        if (campo.associacao == associacao) {
+            tamanho += tamanhoDoFormato(campo.formato);
+        }
+    });
+    return tamanho;
+}
+
+// Confere em tempo de compilação que o formato de cada campo
+// tem o tamanho do tipo dele e, com uma associação só, que o
+// fluxo tem exatamente o layout da struct.
+template <typename V>
+constexpr bool layoutValido() {
+    bool valido = true;
+    uint32_t deslocamentoNoFluxo = 0;
+    detalhe::paraCadaCampo<V>([&](const auto& campo) {
+        using Tipo =
+            typename std::decay_t<decltype(campo)>::Tipo;
+        valido = valido && sizeof(Tipo) ==
+                               tamanhoDoFormato(campo.formato);
+        if (numAssociacoes<V>() == 1) {
+            valido = valido &&
+                     campo.deslocamento == deslocamentoNoFluxo;
+        }
+        deslocamentoNoFluxo += tamanhoDoFormato(campo.formato);
+    });
+    if (numAssociacoes<V>() == 1) {
+        valido = valido && tamanhoDoFluxo<V>(0) == sizeof(V);
+    }
+    return valido;
+}
+
+template <typename V>
+constexpr std::array<vk::VertexInputAttributeDescription,
+                     kNumAtributos<V>>
+descricaoDeAtributos() {
+    static_assert(layoutValido<V>(),
+                  "Os formatos não batem com os campos.");
+
+    std::array<vk::VertexInputAttributeDescription,
+               kNumAtributos<V>>
+        atributos{};
+    std::array<uint32_t, numAssociacoes<V>()> deslocamentos{};
+    uint32_t location = 0;
+    detalhe::paraCadaCampo<V>([&](const auto& campo) {
+        atributos[location] =
+            vk::VertexInputAttributeDescription{
+                location, campo.associacao, campo.formato,
+                deslocamentos[campo.associacao]};
+        deslocamentos[campo.associacao] +=
+            tamanhoDoFormato(campo.formato);
+        location++;
+    });
+    return atributos;
+}
+
+template <typename V>
+constexpr std::array<vk::VertexInputBindingDescription,
+                     numAssociacoes<V>()>
+descricaoDeAssociacoes() {
+    std::array<vk::VertexInputBindingDescription,
+               numAssociacoes<V>()>
+        associacoes{};
+    for (uint32_t i = 0; i < associacoes.size(); i++) {
+        associacoes[i] = vk::VertexInputBindingDescription{
+            i, tamanhoDoFluxo<V>(i),
+            vk::VertexInputRate::eVertex};
+    }
+    return associacoes;
+}
+
+// As descrições de um formato escolhido em tempo de execução.
+struct EntradaDeVertices {
+    std::vector<vk::VertexInputBindingDescription> associacoes;
+    std::vector<vk::VertexInputAttributeDescription> atributos;
+};
+
+template <typename V>
+EntradaDeVertices entradaDeVertices() {
+    constexpr auto associacoes = descricaoDeAssociacoes<V>();
+    constexpr auto atributos = descricaoDeAtributos<V>();
+    return {{associacoes.begin(), associacoes.end()},
+            {atributos.begin(), atributos.end()}};
+}
+
+// Só as associações pedidas e os atributos delas, mantendo os
+// números de associação e as locations. Um passe que não lê
+// os outros fluxos não busca os bytes deles.
+template <typename V>
+EntradaDeVertices entradaDeVertices(
+    const std::vector<uint32_t>& associacoes) {
+    auto entrada = entradaDeVertices<V>();
+    auto pedida = [&associacoes](uint32_t associacao) {
+        return std::find(associacoes.begin(), associacoes.end(),
+                         associacao) != associacoes.end();
+    };
+    entrada.associacoes.erase(
+        std::remove_if(entrada.associacoes.begin(),
+                       entrada.associacoes.end(),
+                       [&pedida](const auto& descricao) {
+                           return !pedida(descricao.binding);
+                       }),
+        entrada.associacoes.end());
+    entrada.atributos.erase(
+        std::remove_if(entrada.atributos.begin(),
+                       entrada.atributos.end(),
+                       [&pedida](const auto& descricao) {
+                           return !pedida(descricao.binding);
+                       }),
+        entrada.atributos.end());
+    return entrada;
+}
+
+// Copia os campos de uma associação de cada vértice, em ordem,
+// para `destino`, que deve ter espaço para
+// `numVertices * tamanhoDoFluxo<V>(associacao)` bytes.
+template <typename V>
+void copiarFluxo(uint32_t associacao,
+                 const V* vertices,
+                 size_t numVertices,
+                 void* destino) {
+    auto bytes = static_cast<char*>(destino);
+    for (size_t i = 0; i < numVertices; i++) {
+        detalhe::paraCadaCampo<V>([&](const auto& campo) {
+            if (campo.associacao != associacao) {
+                return;
+            }
+            const auto& valor = vertices[i].*campo.membro;
+            std::memcpy(bytes, &valor, sizeof(valor));
+            bytes += sizeof(valor);
+        });
+    }
+}
+
+template <typename V>
+bool verticesIguais(const V& a, const V& b) {
+    bool iguais = true;
+    detalhe::paraCadaCampo<V>([&](const auto& campo) {
+        iguais = iguais && a.*campo.membro == b.*campo.membro;
+    });
+    return iguais;
+}
+
+template <typename V>
+size_t hashDoVertice(const V& vertice) {
+    size_t semente = 0;
+    detalhe::paraCadaCampo<V>([&](const auto& campo) {
+        detalhe::combinarHash(
+            semente,
+            detalhe::hashDoCampo(vertice.*campo.membro));
+    });
+    return semente;
+}
+}  // namespace smv
+
+#endif
@@ -0,0 +1,171 @@
+#include "malha_cozida.hpp"
+
+#include "alocador_de_intervalos.hpp"
+#include "indices_de_malha.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace smv {
+namespace {
+const uint64_t kAlinhamentoDosFluxos = 16;
+}  // namespace
+
+void escreverMalhaCozida(
+    const std::string& caminho,
+    const std::vector<Vertice>& vertices,
+    const std::vector<uint32_t>& indices,
+    const std::vector<NivelDaMalha>& niveis,
+    const std::vector<Meshlet>& meshlets) {
+    auto tipoDeIndice =
+        tipoDeIndiceParaVertices(vertices.size());
+
+    CabecalhoDeMalha cabecalho{};
+    cabecalho.magica = kMagicaDaMalha;
+    cabecalho.versao = kVersaoDaMalha;
+    cabecalho.tamanhoDoVertice = sizeof(Vertice);
+    cabecalho.tamanhoDoIndice = tamanhoDoIndice(tipoDeIndice);
+    cabecalho.numVertices =
+        static_cast<uint32_t>(vertices.size());
+    cabecalho.numIndices =
+        static_cast<uint32_t>(indices.size());
+    cabecalho.deslocamentoDosVertices = alinharParaCima(
+        sizeof(CabecalhoDeMalha), kAlinhamentoDosFluxos);
+    cabecalho.deslocamentoDosIndices = alinharParaCima(
+        cabecalho.deslocamentoDosVertices +
+            vertices.size() * sizeof(Vertice),
+        kAlinhamentoDosFluxos);
+    cabecalho.numNiveis = static_cast<uint32_t>(niveis.size());
+    cabecalho.deslocamentoDosNiveis = alinharParaCima(
+        cabecalho.deslocamentoDosIndices +
+            indices.size() * cabecalho.tamanhoDoIndice,
+        kAlinhamentoDosFluxos);
+    cabecalho.numMeshlets =
+        static_cast<uint32_t>(meshlets.size());
+    cabecalho.deslocamentoDosMeshlets = alinharParaCima(
+        cabecalho.deslocamentoDosNiveis +
+            niveis.size() * sizeof(NivelDaMalha),
+        kAlinhamentoDosFluxos);
+
+    cabecalho.minimo =
+        glm::vec3(std::numeric_limits<float>::max());
+    cabecalho.maximo =
+        glm::vec3(std::numeric_limits<float>::lowest());
+    for (const auto& vertice : vertices) {
+        cabecalho.minimo = glm::min(cabecalho.minimo,
+                                    vertice.posicao);
+        cabecalho.maximo = glm::max(cabecalho.maximo,
+                                    vertice.posicao);
+    }
+
+    std::ofstream arquivo(caminho, std::ios::binary);
+    if (!arquivo) {
+        throw std::runtime_error(
+            "Não foi possível criar o arquivo '" + caminho +
+            "'.");
+    }
+
+    auto escreverEmPosicao = [&arquivo](uint64_t posicao,
+                                        const void* dados,
+                                        size_t tamanho) {
+        // Preenche o espaço de alinhamento com zeros.
+        while (static_cast<uint64_t>(arquivo.tellp()) <
+               posicao) {
+            arquivo.put('\0');
+        }
+        arquivo.write(static_cast<const char*>(dados),
+                      static_cast<std::streamsize>(tamanho));
+    };
+    escreverEmPosicao(0, &cabecalho, sizeof(cabecalho));
+    escreverEmPosicao(cabecalho.deslocamentoDosVertices,
+                      vertices.data(),
+                      vertices.size() * sizeof(Vertice));
+    if (tipoDeIndice == vk::IndexType::eUint16) {
+        auto estreitos = estreitarIndices(indices);
+        escreverEmPosicao(cabecalho.deslocamentoDosIndices,
+                          estreitos.data(),
+                          estreitos.size() * sizeof(uint16_t));
+    } else {
+        escreverEmPosicao(cabecalho.deslocamentoDosIndices,
+                          indices.data(),
+                          indices.size() * sizeof(uint32_t));
+    }
+    escreverEmPosicao(cabecalho.deslocamentoDosNiveis,
+                      niveis.data(),
+                      niveis.size() * sizeof(NivelDaMalha));
+    escreverEmPosicao(cabecalho.deslocamentoDosMeshlets,
+                      meshlets.data(),
+                      meshlets.size() * sizeof(Meshlet));
+
+    if (!arquivo) {
+        throw std::runtime_error(
+            "Não foi possível escrever o arquivo '" + caminho +
+            "'.");
+    }
+}
+
+bool MalhaCozida::abrir(const std::string& caminho) {
+    if (!arquivo_.abrir(caminho)) {
+        return false;
+    }
+
+    if (arquivo_.tamanho() < sizeof(CabecalhoDeMalha) ||
+        cabecalho().magica != kMagicaDaMalha) {
+        fechar();
+        throw std::runtime_error("'" + caminho +
+                                 "' não é uma malha cozida.");
+    }
+
+    const auto& c = cabecalho();
+    if (c.versao != kVersaoDaMalha ||
+        c.tamanhoDoVertice != sizeof(Vertice) ||
+        (c.tamanhoDoIndice != sizeof(uint16_t) &&
+         c.tamanhoDoIndice != sizeof(uint32_t))) {
+        fechar();
+        return false;
+    }
+
+    uint64_t fimDosVertices =
+        c.deslocamentoDosVertices +
+        uint64_t{c.numVertices} * c.tamanhoDoVertice;
+    uint64_t fimDosIndices =
+        c.deslocamentoDosIndices +
+        uint64_t{c.numIndices} * c.tamanhoDoIndice;
+    uint64_t fimDosNiveis =
+        c.deslocamentoDosNiveis +
+        uint64_t{c.numNiveis} * sizeof(NivelDaMalha);
+    uint64_t fimDosMeshlets =
+        c.deslocamentoDosMeshlets +
+        uint64_t{c.numMeshlets} * sizeof(Meshlet);
+    if (std::max({fimDosVertices, fimDosIndices, fimDosNiveis,
+                  fimDosMeshlets}) > arquivo_.tamanho()) {
+        fechar();
+        throw std::runtime_error("A malha cozida '" + caminho +
+                                 "' está truncada.");
+    }
+
+    if (c.numNiveis == 0) {
+        fechar();
+        throw std::runtime_error("A malha cozida '" + caminho +
+                                 "' não tem níveis.");
+    }
+    for (uint32_t i = 0; i < c.numNiveis; i++) {
+        const auto& nivel = niveis()[i];
+        uint64_t fimDoNivel =
+            uint64_t{nivel.primeiroIndice} + nivel.numIndices;
+        uint64_t fimDosMeshletsDoNivel =
+            uint64_t{nivel.primeiroMeshlet} + nivel.numMeshlets;
+        if (fimDoNivel > c.numIndices ||
+            fimDosMeshletsDoNivel > c.numMeshlets) {
+            fechar();
+            throw std::runtime_error(
+                "A malha cozida '" + caminho +
+                "' tem um nível fora dos índices.");
+        }
+    }
+
+    return true;
+}
+}  // namespace smv
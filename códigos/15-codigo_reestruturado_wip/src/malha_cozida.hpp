@@ -0,0 +1,104 @@
+#ifndef SMV_MALHA_COZIDA_HPP
+#define SMV_MALHA_COZIDA_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "arquivo_mapeado.hpp"
+#include "meshlets.hpp"
+#include "simplificacao_de_malha.hpp"
+#include "vertice.hpp"
+
+namespace smv {
+// Malha já importada e sem vértices repetidos, no formato em
+// que vai para a GPU:
+//
+//   [CabecalhoDeMalha][vértices][índices][níveis][meshlets]
+//
+// Os fluxos começam em múltiplos de 16 bytes e tudo está em
+// little-endian. Os índices têm 16 bits quando endereçam todos
+// os vértices e 32 bits caso contrário. Eles trazem todos os
+// níveis de detalhe, e cada NivelDaMalha aponta o trecho de
+// um, e os meshlets dele; o primeiro nível é a malha completa.
+struct CabecalhoDeMalha {
+    std::array<char, 4> magica;
+    uint32_t versao;
+    uint32_t tamanhoDoVertice;
+    uint32_t tamanhoDoIndice;
+    uint32_t numVertices;
+    uint32_t numIndices;
+    uint64_t deslocamentoDosVertices;
+    uint64_t deslocamentoDosIndices;
+    glm::vec3 minimo;
+    glm::vec3 maximo;
+    uint32_t numNiveis;
+    uint32_t numMeshlets;
+    uint64_t deslocamentoDosNiveis;
+    uint64_t deslocamentoDosMeshlets;
+};
+static_assert(sizeof(CabecalhoDeMalha) == 88,
+              "O cabeçalho faz parte do formato do arquivo.");
+static_assert(sizeof(NivelDaMalha) == 20,
+              "Os níveis fazem parte do formato do arquivo.");
+
+constexpr std::array<char, 4> kMagicaDaMalha = {'S', 'M', 'V',
+                                                'M'};
+// Deve ser incrementada sempre que o cabeçalho ou o Vertice
+// mudarem.
+constexpr uint32_t kVersaoDaMalha = 4;
+
+void escreverMalhaCozida(
+    const std::string& caminho,
+    const std::vector<Vertice>& vertices,
+    const std::vector<uint32_t>& indices,
+    const std::vector<NivelDaMalha>& niveis,
+    const std::vector<Meshlet>& meshlets);
+
+// Arquivo de malha cozida mapeado em memória só para leitura.
+// Os vértices e índices apontam direto para o mapeamento, sem
+// cópias intermediárias.
+class MalhaCozida {
+  public:
+    // Retorna falso se o arquivo não existir ou for de outra
+    // versão do formato, caso em que ele deve ser cozido de
+    // novo. Lança uma exceção se o arquivo estiver corrompido.
+    bool abrir(const std::string& caminho);
+    void fechar() { arquivo_.fechar(); }
+
+    const CabecalhoDeMalha& cabecalho() const {
+        return *reinterpret_cast<const CabecalhoDeMalha*>(
+            arquivo_.dados());
+    }
+    const Vertice* vertices() const {
+        return reinterpret_cast<const Vertice*>(
+            arquivo_.dados() +
+            cabecalho().deslocamentoDosVertices);
+    }
+    const void* indices() const {
+        return arquivo_.dados() +
+               cabecalho().deslocamentoDosIndices;
+    }
+    const NivelDaMalha* niveis() const {
+        return reinterpret_cast<const NivelDaMalha*>(
+            arquivo_.dados() +
+            cabecalho().deslocamentoDosNiveis);
+    }
+    const Meshlet* meshlets() const {
+        return reinterpret_cast<const Meshlet*>(
+            arquivo_.dados() +
+            cabecalho().deslocamentoDosMeshlets);
+    }
+    vk::IndexType tipoDeIndice() const {
+        return cabecalho().tamanhoDoIndice == sizeof(uint16_t)
+                   ? vk::IndexType::eUint16
+                   : vk::IndexType::eUint32;
+    }
+
+  private:
+    ArquivoMapeado arquivo_;
+};
+}  // namespace smv
+
+#endif
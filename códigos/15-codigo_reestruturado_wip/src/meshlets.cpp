@@ -0,0 +1,168 @@
+#include "meshlets.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace smv {
+namespace {
+// Abaixo disso, as normais se espalham demais para que o cone
+// descarte alguma coisa.
+constexpr float kMenorCossenoDoCone = 0.1f;
+
+Meshlet limitarMeshlet(const std::vector<Vertice>& vertices,
+                       const uint32_t* indices,
+                       uint32_t primeiroIndice,
+                       uint32_t numTriangulos) {
+    Meshlet meshlet{};
+    meshlet.primeiroIndice = primeiroIndice;
+    meshlet.numTriangulos = numTriangulos;
+
+    const uint32_t* triangulos = indices + primeiroIndice;
+    size_t numIndices = size_t{numTriangulos} * 3;
+    glm::vec3 minimo(std::numeric_limits<float>::max());
+    glm::vec3 maximo(std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < numIndices; i++) {
+        minimo = glm::min(minimo,
+                          vertices[triangulos[i]].posicao);
+        maximo = glm::max(maximo,
+                          vertices[triangulos[i]].posicao);
+    }
+    meshlet.centro = (minimo + maximo) * 0.5f;
+    for (size_t i = 0; i < numIndices; i++) {
+        meshlet.raio = std::max(
+            meshlet.raio,
+            glm::distance(meshlet.centro,
+                          vertices[triangulos[i]].posicao));
+    }
+
+    std::vector<glm::vec3> normais;
+    glm::vec3 soma(0.0f);
+    for (size_t i = 0; i < numIndices; i += 3) {
+        glm::vec3 p0 = vertices[triangulos[i]].posicao;
+        glm::vec3 p1 = vertices[triangulos[i + 1]].posicao;
+        glm::vec3 p2 = vertices[triangulos[i + 2]].posicao;
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float comprimento = glm::length(normal);
+        if (comprimento > 0.0f) {
+            normais.push_back(normal / comprimento);
+            soma += normais.back();
+        }
+    }
+    float comprimentoDaSoma = glm::length(soma);
+    if (comprimentoDaSoma <= 0.0f) {
+        meshlet.corteDoCone = 1.0f;
+        return meshlet;
+    }
+    glm::vec3 eixo = soma / comprimentoDaSoma;
+    float menorCosseno = 1.0f;
+    for (const auto& normal : normais) {
+        menorCosseno =
+            std::min(menorCosseno, glm::dot(normal, eixo));
+    }
+    if (menorCosseno > kMenorCossenoDoCone) {
+        meshlet.eixoDoCone = eixo;
+        meshlet.corteDoCone =
+            std::sqrt(1.0f - menorCosseno * menorCosseno);
+    } else {
+        meshlet.corteDoCone = 1.0f;
+    }
+    return meshlet;
+}
+}  // namespace
+
+std::vector<Meshlet> gerarMeshlets(
+    const std::vector<Vertice>& vertices,
+    const std::vector<uint32_t>& indices,
+    std::vector<NivelDaMalha>& niveis) {
+    std::vector<Meshlet> meshlets;
+    // Em qual meshlet cada vértice entrou por último.
+    std::vector<uint32_t> marca(
+        vertices.size(), std::numeric_limits<uint32_t>::max());
+
+    for (auto& nivel : niveis) {
+        nivel.primeiroMeshlet =
+            static_cast<uint32_t>(meshlets.size());
+
+        uint32_t inicio = nivel.primeiroIndice;
+        uint32_t numVertices = 0;
+        uint32_t numTriangulos = 0;
+        auto fecharMeshlet = [&]() {
+            meshlets.push_back(limitarMeshlet(
+                vertices, indices.data(), inicio,
+                numTriangulos));
+            inicio += numTriangulos * 3;
+            numVertices = 0;
+            numTriangulos = 0;
+        };
+
+        uint32_t fim = inicio + nivel.numIndices;
+        for (uint32_t t = inicio; t < fim; t += 3) {
+            auto id = static_cast<uint32_t>(meshlets.size());
+            uint32_t novos = 0;
+            for (uint32_t i = t; i < t + 3; i++) {
+                if (marca[indices[i]] != id) {
+                    novos++;
+                }
+            }
+            bool cheio =
+                numVertices + novos >
+                    kMaximoDeVerticesPorMeshlet ||
+                numTriangulos == kMaximoDeTriangulosPorMeshlet;
+            if (cheio) {
+                fecharMeshlet();
+                id++;
+            }
+            for (uint32_t i = t; i < t + 3; i++) {
+                if (marca[indices[i]] != id) {
+                    marca[indices[i]] = id;
+                    numVertices++;
+                }
+            }
+            numTriangulos++;
+        }
+        if (numTriangulos > 0) {
+            fecharMeshlet();
+        }
+
+        nivel.numMeshlets =
+            static_cast<uint32_t>(meshlets.size()) -
+            nivel.primeiroMeshlet;
+    }
+    return meshlets;
+}
+
+glm::vec4 esferaEnvolvente(const Vertice* vertices,
+                           size_t numVertices) {
+    glm::vec3 minimo(std::numeric_limits<float>::max());
+    glm::vec3 maximo(std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < numVertices; i++) {
+        minimo = glm::min(minimo, vertices[i].posicao);
+        maximo = glm::max(maximo, vertices[i].posicao);
+    }
+    glm::vec3 centro = (minimo + maximo) * 0.5f;
+    float raio = 0.0f;
+    for (size_t i = 0; i < numVertices; i++) {
+        raio = std::max(
+            raio, glm::distance(centro, vertices[i].posicao));
+    }
+    return glm::vec4(centro, raio);
+}
+
+glm::vec4 juntarEsferas(const glm::vec4& a,
+                        const glm::vec4& b) {
+    glm::vec3 centroA(a);
+    glm::vec3 centroB(b);
+    float distancia = glm::distance(centroA, centroB);
+    if (distancia + b.w <= a.w) {
+        return a;
+    }
+    if (distancia + a.w <= b.w) {
+        return b;
+    }
+    float raio = (distancia + a.w + b.w) * 0.5f;
+    glm::vec3 centro = centroA + (centroB - centroA) *
+                                     ((raio - a.w) / distancia);
+    return glm::vec4(centro, raio);
+}
+}  // namespace smv
@@ -0,0 +1,53 @@
+#ifndef SMV_MESHLETS_HPP
+#define SMV_MESHLETS_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "simplificacao_de_malha.hpp"
+#include "vertice.hpp"
+
+namespace smv {
+constexpr uint32_t kMaximoDeVerticesPorMeshlet = 64;
+constexpr uint32_t kMaximoDeTriangulosPorMeshlet = 124;
+
+// Triângulos consecutivos de um nível da malha, com os limites
+// usados para descartá-los juntos na GPU. O layout é o std430
+// do shader de descarte.
+struct Meshlet {
+    // Esfera que contém os vértices.
+    glm::vec3 centro;
+    float raio;
+    // Todas as normais dos triângulos ficam no cone em volta do
+    // eixo, e o meshlet está de costas para quem o vê de dentro
+    // do cone oposto. Um eixo nulo nunca é descartado assim.
+    glm::vec3 eixoDoCone;
+    float corteDoCone;
+    // Nos índices da malha.
+    uint32_t primeiroIndice;
+    uint32_t numTriangulos;
+    uint32_t reservado[2];
+};
+static_assert(sizeof(Meshlet) == 48,
+              "O meshlet é lido pelo shader em std430.");
+
+// Corta os triângulos de cada nível, na ordem em que estão, em
+// meshlets de até kMaximoDeVerticesPorMeshlet vértices e
+// kMaximoDeTriangulosPorMeshlet triângulos. Como a ordem já é
+// a otimizada para o cache, os triângulos de um meshlet são
+// vizinhos. Preenche o trecho de meshlets de cada nível.
+std::vector<Meshlet> gerarMeshlets(
+    const std::vector<Vertice>& vertices,
+    const std::vector<uint32_t>& indices,
+    std::vector<NivelDaMalha>& niveis);
+
+// A esfera que contém todos os vértices, com o centro na caixa
+// envolvente e o raio no w.
+glm::vec4 esferaEnvolvente(const Vertice* vertices,
+                           size_t numVertices);
+
+// A menor esfera que contém as duas.
+glm::vec4 juntarEsferas(const glm::vec4& a, const glm::vec4& b);
+}  // namespace smv
+
+#endif
@@ -0,0 +1,156 @@
+#include "orcamento_de_memoria.hpp"
+
+#include <iostream>
+
+namespace smv {
+void OrcamentoDeMemoria::iniciar(
+    vk::PhysicalDevice dispositivoFisico,
+    bool possuiExtensaoDeOrcamento,
+    uint64_t quadrosEmExecucao) {
+    dispositivoFisico_ = dispositivoFisico;
+    possuiExtensaoDeOrcamento_ = possuiExtensaoDeOrcamento;
+    quadrosEmExecucao_ = quadrosEmExecucao;
+    propriedades_ = dispositivoFisico.getMemoryProperties();
+
+    heaps_.resize(propriedades_.memoryHeapCount);
+    for (uint32_t i = 0; i < propriedades_.memoryHeapCount;
+         i++) {
+        heaps_[i].tamanho = propriedades_.memoryHeaps[i].size;
+    }
+    atualizar();
+}
+
+void OrcamentoDeMemoria::atualizar() {
+    if (possuiExtensaoDeOrcamento_) {
+        auto cadeia = dispositivoFisico_.getMemoryProperties2<
+            vk::PhysicalDeviceMemoryProperties2,
+            vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+        const auto& orcamento = cadeia.get<
+            vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+
+        for (size_t i = 0; i < heaps_.size(); i++) {
+            heaps_[i].orcamento = orcamento.heapBudget[i];
+            heaps_[i].usoInformado = orcamento.heapUsage[i];
+        }
+        return;
+    }
+
+    for (auto&& heap : heaps_) {
+        heap.orcamento = static_cast<vk::DeviceSize>(
+            static_cast<double>(heap.tamanho) *
+            kFracaoDoHeapSemExtensao);
+        heap.usoInformado = heap.bytesAlocados;
+    }
+}
+
+uint32_t OrcamentoDeMemoria::heapDoTipo(
+    uint32_t tipoDeMemoria) const {
+    return propriedades_.memoryTypes[tipoDeMemoria].heapIndex;
+}
+
+bool OrcamentoDeMemoria::cabe(uint32_t heap,
+                              vk::DeviceSize tamanho) {
+    atualizar();
+    return heaps_[heap].usoInformado + tamanho <=
+           heaps_[heap].orcamento;
+}
+
+void OrcamentoDeMemoria::registrarAlocacao(
+    uint32_t heap,
+    vk::DeviceSize tamanho) {
+    heaps_[heap].bytesAlocados += tamanho;
+}
+
+void OrcamentoDeMemoria::registrarLiberacao(
+    uint32_t heap,
+    vk::DeviceSize tamanho) {
+    heaps_[heap].bytesAlocados -= tamanho;
+}
+
+void OrcamentoDeMemoria::somarUsoDeRecursos(
+    uint32_t heap,
+    vk::DeviceSize tamanho) {
+    heaps_[heap].bytesDeRecursos += tamanho;
+}
+
+void OrcamentoDeMemoria::subtrairUsoDeRecursos(
+    uint32_t heap,
+    vk::DeviceSize tamanho) {
+    heaps_[heap].bytesDeRecursos -= tamanho;
+}
+
+OrcamentoDeMemoria::IdDeRecurso
+OrcamentoDeMemoria::registrarRecurso(
+    std::function<void()> despejar) {
+    Recurso recurso;
+    recurso.despejar = std::move(despejar);
+    recursos_.push_back(std::move(recurso));
+    return static_cast<IdDeRecurso>(recursos_.size() - 1);
+}
+
+void OrcamentoDeMemoria::marcarResidente(
+    IdDeRecurso id,
+    uint32_t heap,
+    vk::DeviceSize bytes) {
+    auto& recurso = recursos_[id];
+    recurso.residente = true;
+    recurso.heap = heap;
+    recurso.bytes = bytes;
+    recurso.ultimoUso = quadroAtual_;
+    heaps_[heap].numRecursosResidentes++;
+}
+
+bool OrcamentoDeMemoria::residente(IdDeRecurso id) const {
+    return recursos_[id].residente;
+}
+
+void OrcamentoDeMemoria::usar(IdDeRecurso id) {
+    recursos_[id].ultimoUso = quadroAtual_;
+}
+
+bool OrcamentoDeMemoria::despejarMenosUsado(uint32_t heap) {
+    Recurso* menosUsado = nullptr;
+    for (auto&& recurso : recursos_) {
+        bool emUsoPelaGpu =
+            recurso.ultimoUso + quadrosEmExecucao_ >=
+            quadroAtual_;
+        if (!recurso.residente || recurso.heap != heap ||
+            emUsoPelaGpu) {
+            continue;
+        }
+        if (menosUsado == nullptr ||
+            recurso.ultimoUso < menosUsado->ultimoUso) {
+            menosUsado = &recurso;
+        }
+    }
+
+    if (menosUsado == nullptr) {
+        return false;
+    }
+
+    menosUsado->residente = false;
+    heaps_[heap].numRecursosResidentes--;
+    menosUsado->despejar();
+    return true;
+}
+
+std::vector<EstatisticasDoHeap>
+OrcamentoDeMemoria::estatisticas() {
+    atualizar();
+    return heaps_;
+}
+
+void OrcamentoDeMemoria::imprimirEstatisticas() {
+    auto heaps = estatisticas();
+    for (size_t i = 0; i < heaps.size(); i++) {
+        const auto& heap = heaps[i];
+        std::cout << "Heap " << i << ": " << heap.usoInformado
+                  << "/" << heap.orcamento << " bytes do "
+                  << "orçamento, " << heap.bytesAlocados
+                  << " alocados pelo motor ("
+                  << heap.bytesDeRecursos << " em recursos), "
+                  << heap.numRecursosResidentes
+                  << " recursos residentes" << std::endl;
+    }
+}
+}  // namespace smv
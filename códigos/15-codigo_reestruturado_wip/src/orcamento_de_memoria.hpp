@@ -0,0 +1,90 @@
+#ifndef SMV_ORCAMENTO_DE_MEMORIA_HPP
+#define SMV_ORCAMENTO_DE_MEMORIA_HPP
+
+#include <functional>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+namespace smv {
+struct EstatisticasDoHeap {
+    vk::DeviceSize tamanho = 0;
+    vk::DeviceSize orcamento = 0;
+    // Uso informado pelo driver com VK_EXT_memory_budget, ou
+    // igual a `bytesAlocados` sem a extensão.
+    vk::DeviceSize usoInformado = 0;
+    // Memória de dispositivo alocada pelo motor.
+    vk::DeviceSize bytesAlocados = 0;
+    // Parte dela entregue a buffers e imagens.
+    vk::DeviceSize bytesDeRecursos = 0;
+    uint32_t numRecursosResidentes = 0;
+};
+
+// Acompanha o orçamento de cada heap de memória e o uso que o
+// motor faz dele, e despeja os recursos recarregáveis usados
+// há mais tempo quando uma alocação passaria do orçamento.
+class OrcamentoDeMemoria {
+  public:
+    using IdDeRecurso = uint32_t;
+
+    void iniciar(vk::PhysicalDevice dispositivoFisico,
+                 bool possuiExtensaoDeOrcamento,
+                 uint64_t quadrosEmExecucao);
+
+    uint32_t heapDoTipo(uint32_t tipoDeMemoria) const;
+    bool cabe(uint32_t heap, vk::DeviceSize tamanho);
+
+    void registrarAlocacao(uint32_t heap,
+                           vk::DeviceSize tamanho);
+    void registrarLiberacao(uint32_t heap,
+                            vk::DeviceSize tamanho);
+    void somarUsoDeRecursos(uint32_t heap,
+                            vk::DeviceSize tamanho);
+    void subtrairUsoDeRecursos(uint32_t heap,
+                               vk::DeviceSize tamanho);
+
+    // `despejar` deve destruir os objetos da GPU do recurso,
+    // deixando-o num estado em que possa ser recarregado.
+    IdDeRecurso registrarRecurso(
+        std::function<void()> despejar);
+    void marcarResidente(IdDeRecurso id,
+                         uint32_t heap,
+                         vk::DeviceSize bytes);
+    bool residente(IdDeRecurso id) const;
+    void usar(IdDeRecurso id);
+    void avancarQuadro() { quadroAtual_++; }
+
+    // Despeja o recurso residente no heap usado há mais
+    // tempo, desde que nenhum quadro em execução o use.
+    bool despejarMenosUsado(uint32_t heap);
+
+    std::vector<EstatisticasDoHeap> estatisticas();
+    void imprimirEstatisticas();
+
+  private:
+    struct Recurso {
+        std::function<void()> despejar;
+        bool residente = false;
+        uint32_t heap = 0;
+        vk::DeviceSize bytes = 0;
+        uint64_t ultimoUso = 0;
+    };
+
+    void atualizar();
+
+    // Sem a extensão, deixamos uma folga para o resto do
+    // sistema em vez de contar com o heap inteiro.
+    static constexpr double kFracaoDoHeapSemExtensao = 0.8;
+
+    vk::PhysicalDevice dispositivoFisico_;
+    bool possuiExtensaoDeOrcamento_ = false;
+    vk::PhysicalDeviceMemoryProperties propriedades_;
+
+    std::vector<EstatisticasDoHeap> heaps_;
+    std::vector<Recurso> recursos_;
+    uint64_t quadroAtual_ = 0;
+    uint64_t quadrosEmExecucao_ = 0;
+};
+}  // namespace smv
+
+#endif
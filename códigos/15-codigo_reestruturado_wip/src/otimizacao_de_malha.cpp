@@ -0,0 +1,354 @@
+#include "otimizacao_de_malha.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace smv {
+namespace {
+// Constantes do artigo "Linear-Speed Vertex Cache
+// Optimisation", de Tom Forsyth.
+constexpr uint32_t kTamanhoDoCacheDeForsyth = 32;
+constexpr float kPotenciaDeDecaimentoDoCache = 1.5f;
+constexpr float kPontuacaoDoUltimoTriangulo = 0.75f;
+constexpr float kEscalaDoBonusDeValencia = 2.0f;
+constexpr float kPotenciaDoBonusDeValencia = 0.5f;
+
+constexpr uint32_t kForaDoCache =
+    std::numeric_limits<uint32_t>::max();
+
+float pontuacaoDoVertice(uint32_t posicaoNoCache,
+                         uint32_t triangulosRestantes) {
+    if (triangulosRestantes == 0) {
+        return -1.0f;
+    }
+
+    float pontuacao = 0.0f;
+    if (posicaoNoCache < 3) {
+        // Os vértices do último triângulo recebem uma
+        // pontuação fixa, para não favorecer tiras longas.
+        pontuacao = kPontuacaoDoUltimoTriangulo;
+    } else if (posicaoNoCache != kForaDoCache) {
+        float escala = 1.0f / (kTamanhoDoCacheDeForsyth - 3);
+        pontuacao = std::pow(
+            1.0f - static_cast<float>(posicaoNoCache - 3) *
+                       escala,
+            kPotenciaDeDecaimentoDoCache);
+    }
+
+    // Vértices com poucos triângulos restantes são terminados
+    // primeiro, para saírem do caminho.
+    pontuacao +=
+        kEscalaDoBonusDeValencia *
+        std::pow(static_cast<float>(triangulosRestantes),
+                 -kPotenciaDoBonusDeValencia);
+    return pontuacao;
+}
+}  // namespace
+
+EstatisticasDeCache analisarCacheDeVertices(
+    const std::vector<uint32_t>& indices,
+    size_t numVertices,
+    uint32_t tamanhoDoCache) {
+    EstatisticasDeCache estatisticas;
+    if (indices.empty()) {
+        return estatisticas;
+    }
+
+    // Momento em que cada vértice entrou no cache. Ele ainda
+    // está lá se entrou há menos de `tamanhoDoCache` entradas.
+    std::vector<uint64_t> entradaNoCache(
+        numVertices, std::numeric_limits<uint64_t>::max());
+    std::vector<bool> usado(numVertices);
+    uint64_t numEntradas = 0;
+    uint32_t numVerticesUsados = 0;
+    for (uint32_t indice : indices) {
+        if (!usado[indice]) {
+            usado[indice] = true;
+            numVerticesUsados++;
+        }
+        bool noCache =
+            entradaNoCache[indice] !=
+                std::numeric_limits<uint64_t>::max() &&
+            numEntradas - entradaNoCache[indice] <
+                tamanhoDoCache;
+        if (!noCache) {
+            entradaNoCache[indice] = numEntradas++;
+            estatisticas.numTransformacoes++;
+        }
+    }
+
+    estatisticas.acmr =
+        static_cast<float>(estatisticas.numTransformacoes) /
+        static_cast<float>(indices.size() / 3);
+    estatisticas.atvr =
+        static_cast<float>(estatisticas.numTransformacoes) /
+        static_cast<float>(numVerticesUsados);
+    return estatisticas;
+}
+
+void imprimirEstatisticasDeCache(
+    const std::string& nome,
+    const EstatisticasDeCache& estatisticas) {
+    std::cout << std::left << std::setw(40) << nome
+              << std::right << std::fixed
+              << std::setprecision(3) << "ACMR "
+              << estatisticas.acmr << ", ATVR "
+              << estatisticas.atvr << ", "
+              << estatisticas.numTransformacoes
+              << " vértices transformados" << std::endl;
+}
+
+std::vector<uint32_t> otimizarCacheDeVertices(
+    const std::vector<uint32_t>& indices,
+    size_t numVertices) {
+    size_t numTriangulos = indices.size() / 3;
+
+    // Os triângulos de cada vértice ficam em
+    // triangulosDoVertice[inicio[v], inicio[v + 1]), com os
+    // ainda não emitidos nas primeiras `restantes[v]` posições.
+    std::vector<uint32_t> inicio(numVertices + 1);
+    for (size_t i = 0; i < numTriangulos * 3; i++) {
+        inicio[indices[i] + 1]++;
+    }
+    for (size_t v = 0; v < numVertices; v++) {
+        inicio[v + 1] += inicio[v];
+    }
+    std::vector<uint32_t> triangulosDoVertice(numTriangulos *
+                                              3);
+    std::vector<uint32_t> restantes(numVertices);
+    for (size_t i = 0; i < numTriangulos * 3; i++) {
+        uint32_t v = indices[i];
+        triangulosDoVertice[inicio[v] + restantes[v]++] =
+            static_cast<uint32_t>(i / 3);
+    }
+
+    std::vector<uint32_t> posicaoNoCache(numVertices,
+                                         kForaDoCache);
+    std::vector<float> pontuacaoDosVertices(numVertices);
+    for (size_t v = 0; v < numVertices; v++) {
+        pontuacaoDosVertices[v] =
+            pontuacaoDoVertice(kForaDoCache, restantes[v]);
+    }
+
+    auto pontuarTriangulo = [&](size_t t) {
+        return pontuacaoDosVertices[indices[3 * t + 0]] +
+               pontuacaoDosVertices[indices[3 * t + 1]] +
+               pontuacaoDosVertices[indices[3 * t + 2]];
+    };
+    std::vector<bool> emitido(numTriangulos);
+    size_t melhor = 0;
+    float melhorPontuacao = -1.0f;
+    for (size_t t = 0; t < numTriangulos; t++) {
+        float pontuacao = pontuarTriangulo(t);
+        if (pontuacao > melhorPontuacao) {
+            melhorPontuacao = pontuacao;
+            melhor = t;
+        }
+    }
+
+    std::vector<uint32_t> otimizados;
+    otimizados.reserve(numTriangulos * 3);
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> novoCache;
+    size_t proximoNaoEmitido = 0;
+    while (otimizados.size() < numTriangulos * 3) {
+        // Sem candidatos no cache, seguimos a ordem original.
+        if (melhor == numTriangulos) {
+            while (emitido[proximoNaoEmitido]) {
+                proximoNaoEmitido++;
+            }
+            melhor = proximoNaoEmitido;
+        }
+
+        emitido[melhor] = true;
+        novoCache.clear();
+        for (size_t i = 3 * melhor; i < 3 * melhor + 3; i++) {
+            uint32_t v = indices[i];
+            otimizados.push_back(v);
+
+            auto ativos =
+                triangulosDoVertice.begin() + inicio[v];
+            auto fimDosAtivos = ativos + restantes[v];
+            auto triangulo =
+                std::find(ativos, fimDosAtivos,
+                          static_cast<uint32_t>(melhor));
+            std::iter_swap(triangulo, fimDosAtivos - 1);
+            restantes[v]--;
+
+            if (std::find(novoCache.begin(), novoCache.end(),
+                          v) == novoCache.end()) {
+                novoCache.push_back(v);
+            }
+        }
+        for (uint32_t v : cache) {
+            if (std::find(novoCache.begin(), novoCache.end(),
+                          v) == novoCache.end()) {
+                novoCache.push_back(v);
+            }
+        }
+
+        // Os vértices que saíram do cache também mudam de
+        // pontuação, e com eles os seus triângulos.
+        for (size_t i = 0; i < novoCache.size(); i++) {
+            uint32_t v = novoCache[i];
+            posicaoNoCache[v] = i < kTamanhoDoCacheDeForsyth
+                                    ? static_cast<uint32_t>(i)
+                                    : kForaDoCache;
+            pontuacaoDosVertices[v] = pontuacaoDoVertice(
+                posicaoNoCache[v], restantes[v]);
+        }
+        melhor = numTriangulos;
+        melhorPontuacao = -1.0f;
+        for (size_t i = 0; i < novoCache.size(); i++) {
+            uint32_t v = novoCache[i];
+            for (uint32_t j = inicio[v];
+                 j < inicio[v] + restantes[v]; j++) {
+                uint32_t t = triangulosDoVertice[j];
+                float pontuacao = pontuarTriangulo(t);
+                bool candidato = i < kTamanhoDoCacheDeForsyth;
+                if (candidato && pontuacao > melhorPontuacao) {
+                    melhorPontuacao = pontuacao;
+                    melhor = t;
+                }
+            }
+        }
+
+        if (novoCache.size() > kTamanhoDoCacheDeForsyth) {
+            novoCache.resize(kTamanhoDoCacheDeForsyth);
+        }
+        std::swap(cache, novoCache);
+    }
+
+    return otimizados;
+}
+
+std::vector<uint32_t> otimizarSobreposicao(
+    const std::vector<uint32_t>& indices,
+    const std::vector<Vertice>& vertices) {
+    size_t numTriangulos = indices.size() / 3;
+
+    struct Grupo {
+        size_t primeiroTriangulo;
+        size_t numTriangulos;
+        float ordem;
+    };
+    std::vector<Grupo> grupos;
+
+    // Um triângulo cujos três vértices faltam no cache é um
+    // bom ponto de corte: começar um grupo nele não custa
+    // nenhuma transformação a mais.
+    std::vector<uint64_t> entradaNoCache(
+        vertices.size(), std::numeric_limits<uint64_t>::max());
+    uint64_t numEntradas = 0;
+    for (size_t t = 0; t < numTriangulos; t++) {
+        uint32_t faltas = 0;
+        for (size_t i = 3 * t; i < 3 * t + 3; i++) {
+            uint32_t v = indices[i];
+            bool noCache =
+                entradaNoCache[v] !=
+                    std::numeric_limits<uint64_t>::max() &&
+                numEntradas - entradaNoCache[v] <
+                    kTamanhoDoCacheDeReferencia;
+            if (!noCache) {
+                entradaNoCache[v] = numEntradas++;
+                faltas++;
+            }
+        }
+        if (grupos.empty() || faltas == 3) {
+            grupos.push_back({t, 0, 0.0f});
+        }
+        grupos.back().numTriangulos++;
+    }
+
+    auto posicao = [&](size_t i) {
+        return vertices[indices[i]].posicao;
+    };
+    // Os centros dos triângulos pesados pela área.
+    glm::vec3 centroDaMalha(0.0f);
+    float areaDaMalha = 0.0f;
+    std::vector<glm::vec3> centroDoGrupo(grupos.size(),
+                                         glm::vec3(0.0f));
+    std::vector<glm::vec3> normalDoGrupo(grupos.size(),
+                                         glm::vec3(0.0f));
+    for (size_t g = 0; g < grupos.size(); g++) {
+        float areaDoGrupo = 0.0f;
+        for (size_t t = grupos[g].primeiroTriangulo;
+             t < grupos[g].primeiroTriangulo +
+                     grupos[g].numTriangulos;
+             t++) {
+            glm::vec3 a = posicao(3 * t + 0);
+            glm::vec3 b = posicao(3 * t + 1);
+            glm::vec3 c = posicao(3 * t + 2);
+            glm::vec3 normal = glm::cross(b - a, c - a);
+            float area = glm::length(normal);
+            glm::vec3 centro = (a + b + c) / 3.0f;
+
+            centroDoGrupo[g] += centro * area;
+            normalDoGrupo[g] += normal;
+            areaDoGrupo += area;
+            centroDaMalha += centro * area;
+            areaDaMalha += area;
+        }
+        if (areaDoGrupo > 0.0f) {
+            centroDoGrupo[g] /= areaDoGrupo;
+        }
+    }
+    if (areaDaMalha > 0.0f) {
+        centroDaMalha /= areaDaMalha;
+    }
+
+    for (size_t g = 0; g < grupos.size(); g++) {
+        float comprimento = glm::length(normalDoGrupo[g]);
+        if (comprimento > 0.0f) {
+            grupos[g].ordem =
+                glm::dot(centroDoGrupo[g] - centroDaMalha,
+                         normalDoGrupo[g] / comprimento);
+        }
+    }
+    std::stable_sort(grupos.begin(), grupos.end(),
+                     [](const Grupo& a, const Grupo& b) {
+                         return a.ordem > b.ordem;
+                     });
+
+    std::vector<uint32_t> ordenados;
+    ordenados.reserve(numTriangulos * 3);
+    for (const auto& grupo : grupos) {
+        auto primeiro = indices.begin() +
+                        static_cast<std::ptrdiff_t>(
+                            3 * grupo.primeiroTriangulo);
+        auto fim = primeiro + static_cast<std::ptrdiff_t>(
+                                  3 * grupo.numTriangulos);
+        ordenados.insert(ordenados.end(), primeiro, fim);
+    }
+    return ordenados;
+}
+
+void otimizarBuscaDeVertices(std::vector<Vertice>& vertices,
+                             std::vector<uint32_t>& indices) {
+    constexpr uint32_t kSemNovoIndice =
+        std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> novoIndice(vertices.size(),
+                                     kSemNovoIndice);
+    std::vector<Vertice> reordenados;
+    reordenados.reserve(vertices.size());
+    for (auto&& indice : indices) {
+        if (novoIndice[indice] == kSemNovoIndice) {
+            novoIndice[indice] =
+                static_cast<uint32_t>(reordenados.size());
+            reordenados.push_back(vertices[indice]);
+        }
+        indice = novoIndice[indice];
+    }
+    vertices = std::move(reordenados);
+}
+
+void otimizarMalha(std::vector<Vertice>& vertices,
+                   std::vector<uint32_t>& indices) {
+    indices = otimizarCacheDeVertices(indices, vertices.size());
+    indices = otimizarSobreposicao(indices, vertices);
+    otimizarBuscaDeVertices(vertices, indices);
+}
+}  // namespace smv
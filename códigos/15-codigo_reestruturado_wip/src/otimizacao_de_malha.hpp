@@ -0,0 +1,58 @@
+#ifndef SMV_OTIMIZACAO_DE_MALHA_HPP
+#define SMV_OTIMIZACAO_DE_MALHA_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "vertice.hpp"
+
+namespace smv {
+// Eficiência do cache pós-transformação de vértices, simulado
+// como uma FIFO. ACMR é a média de vértices transformados por
+// triângulo (de 0,5 a 3) e ATVR a média por vértice único (1
+// é o ideal).
+struct EstatisticasDeCache {
+    uint32_t numTransformacoes = 0;
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+// Tamanho típico do cache das GPUs atuais, usado só para
+// medir. A otimização não depende dele.
+constexpr uint32_t kTamanhoDoCacheDeReferencia = 16;
+
+EstatisticasDeCache analisarCacheDeVertices(
+    const std::vector<uint32_t>& indices,
+    size_t numVertices,
+    uint32_t tamanhoDoCache = kTamanhoDoCacheDeReferencia);
+void imprimirEstatisticasDeCache(
+    const std::string& nome,
+    const EstatisticasDeCache& estatisticas);
+
+// Reordena os triângulos para reusar os vértices que ainda
+// estão no cache, com o algoritmo de Tom Forsyth.
+std::vector<uint32_t> otimizarCacheDeVertices(
+    const std::vector<uint32_t>& indices,
+    size_t numVertices);
+
+// Divide os triângulos, já otimizados para o cache, em grupos
+// que começam onde o cache seria esvaziado de qualquer forma,
+// e desenha primeiro os grupos voltados para fora da malha,
+// que tendem a cobrir os de dentro.
+std::vector<uint32_t> otimizarSobreposicao(
+    const std::vector<uint32_t>& indices,
+    const std::vector<Vertice>& vertices);
+
+// Reordena os vértices na ordem do primeiro uso pelos índices,
+// para que a busca na memória seja quase sequencial, e
+// descarta os que não são usados.
+void otimizarBuscaDeVertices(std::vector<Vertice>& vertices,
+                             std::vector<uint32_t>& indices);
+
+// Roda as três otimizações acima, em ordem.
+void otimizarMalha(std::vector<Vertice>& vertices,
+                   std::vector<uint32_t>& indices);
+}  // namespace smv
+
+#endif
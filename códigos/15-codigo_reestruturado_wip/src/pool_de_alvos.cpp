@@ -0,0 +1,212 @@
+#include "pool_de_alvos.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+namespace smv {
+void PoolDeAlvos::iniciar(vk::PhysicalDevice dispositivoFisico,
+                          vk::Device dispositivo,
+                          AlocadorDeMemoria& alocador,
+                          FilaDeDestruicao& filaDeDestruicao) {
+    dispositivo_ = dispositivo;
+    alocador_ = &alocador;
+    filaDeDestruicao_ = &filaDeDestruicao;
+    propriedades_ = dispositivoFisico.getMemoryProperties();
+}
+
+void PoolDeAlvos::destruir() {
+    for (auto&& alvo : alvos_) {
+        dispositivo_.destroyImageView(alvo.visao);
+        dispositivo_.destroyImage(alvo.imagem);
+    }
+    alvos_.clear();
+    for (auto&& regiao : regioes_) {
+        alocador_->liberar(regiao.alocacao);
+    }
+    regioes_.clear();
+    compilados_.clear();
+}
+
+PoolDeAlvos::IdDeAlvo PoolDeAlvos::declarar(
+    const DescricaoDeAlvo& descricao) {
+    declarados_.push_back(descricao);
+    return static_cast<IdDeAlvo>(declarados_.size() - 1);
+}
+
+void PoolDeAlvos::compilar() {
+    if (declarados_ == compilados_) {
+        return;
+    }
+
+    adiarDestruicao();
+    estatisticas_ = {};
+    estatisticas_.numAlvos =
+        static_cast<uint32_t>(declarados_.size());
+
+    alvos_.resize(declarados_.size());
+    std::vector<vk::MemoryRequirements> requisitos(
+        declarados_.size());
+    for (size_t i = 0; i < declarados_.size(); i++) {
+        const auto& descricao = declarados_[i];
+
+        vk::ImageCreateInfo info;
+        info.imageType = vk::ImageType::e2D;
+        info.format = descricao.formato;
+        info.extent = vk::Extent3D(descricao.dimensoes, 1);
+        info.mipLevels = 1;
+        info.arrayLayers = 1;
+        info.samples = vk::SampleCountFlagBits::e1;
+        info.tiling = vk::ImageTiling::eOptimal;
+        info.usage = descricao.usos;
+        info.sharingMode = vk::SharingMode::eExclusive;
+        info.initialLayout = vk::ImageLayout::eUndefined;
+
+        alvos_[i].imagem = dispositivo_.createImage(info);
+        requisitos[i] =
+            dispositivo_.getImageMemoryRequirements(
+                alvos_[i].imagem);
+        estatisticas_.bytesSemAliasing += requisitos[i].size;
+    }
+
+    // Os alvos são distribuídos em ordem de primeiro uso, cada
+    // um na primeira região que já estiver livre, como numa
+    // coloração de intervalos.
+    std::vector<size_t> ordem(declarados_.size());
+    std::iota(ordem.begin(), ordem.end(), 0);
+    std::stable_sort(ordem.begin(), ordem.end(),
+                     [this](size_t a, size_t b) {
+                         return declarados_[a].primeiroPasse <
+                                declarados_[b].primeiroPasse;
+                     });
+
+    std::vector<size_t> regiaoDoAlvo(declarados_.size());
+    for (size_t i : ordem) {
+        const auto& descricao = declarados_[i];
+        bool transitoria =
+            static_cast<bool>(descricao.usos &
+                              vk::ImageUsageFlagBits::
+                                  eTransientAttachment);
+
+        auto regiao = std::find_if(
+            regioes_.begin(), regioes_.end(),
+            [&](const Regiao& r) {
+                return r.ultimoPasse <
+                           descricao.primeiroPasse &&
+                       r.transitoria == transitoria &&
+                       (r.tiposDeMemoria &
+                        requisitos[i].memoryTypeBits) != 0;
+            });
+        if (regiao == regioes_.end()) {
+            regioes_.emplace_back();
+            regiao = regioes_.end() - 1;
+            regiao->transitoria = transitoria;
+        }
+
+        regiao->tamanho =
+            std::max(regiao->tamanho, requisitos[i].size);
+        regiao->alinhamento = std::max(regiao->alinhamento,
+                                       requisitos[i].alignment);
+        regiao->tiposDeMemoria &= requisitos[i].memoryTypeBits;
+        regiao->ultimoPasse = descricao.ultimoPasse;
+        regiaoDoAlvo[i] = static_cast<size_t>(
+            std::distance(regioes_.begin(), regiao));
+    }
+
+    for (auto&& regiao : regioes_) {
+        uint32_t tipo = escolherTipoDeMemoria(
+            regiao.tiposDeMemoria, regiao.transitoria);
+        regiao.alocacao = alocador_->alocar(
+            {regiao.tamanho, regiao.alinhamento,
+             regiao.tiposDeMemoria},
+            tipo, false);
+
+        estatisticas_.numRegioes++;
+        estatisticas_.bytesAlocados += regiao.tamanho;
+        if (propriedades_.memoryTypes[tipo].propertyFlags &
+            vk::MemoryPropertyFlagBits::eLazilyAllocated) {
+            estatisticas_.numRegioesPreguicosas++;
+        }
+    }
+
+    for (size_t i = 0; i < declarados_.size(); i++) {
+        const auto& regiao = regioes_[regiaoDoAlvo[i]];
+        dispositivo_.bindImageMemory(
+            alvos_[i].imagem, regiao.alocacao.memoria,
+            regiao.alocacao.deslocamento);
+
+        vk::ImageViewCreateInfo info;
+        info.image = alvos_[i].imagem;
+        info.viewType = vk::ImageViewType::e2D;
+        info.format = declarados_[i].formato;
+        info.subresourceRange.aspectMask =
+            declarados_[i].aspectos;
+        info.subresourceRange.baseMipLevel = 0;
+        info.subresourceRange.levelCount = 1;
+        info.subresourceRange.baseArrayLayer = 0;
+        info.subresourceRange.layerCount = 1;
+        alvos_[i].visao = dispositivo_.createImageView(info);
+    }
+
+    compilados_ = declarados_;
+}
+
+void PoolDeAlvos::imprimirEstatisticas() const {
+    std::cout << "Alvos de renderização: "
+              << estatisticas_.numAlvos << " alvos em "
+              << estatisticas_.numRegioes << " regiões ("
+              << estatisticas_.numRegioesPreguicosas
+              << " preguiçosas), "
+              << estatisticas_.bytesAlocados
+              << " bytes alocados contra "
+              << estatisticas_.bytesSemAliasing
+              << " sem aliasing" << std::endl;
+}
+
+void PoolDeAlvos::adiarDestruicao() {
+    filaDeDestruicao_->adiar(
+        [this, alvos = alvos_, regioes = regioes_]() mutable {
+            for (auto&& alvo : alvos) {
+                dispositivo_.destroyImageView(alvo.visao);
+                dispositivo_.destroyImage(alvo.imagem);
+            }
+            for (auto&& regiao : regioes) {
+                alocador_->liberar(regiao.alocacao);
+            }
+        });
+    alvos_.clear();
+    regioes_.clear();
+    compilados_.clear();
+}
+
+uint32_t PoolDeAlvos::escolherTipoDeMemoria(
+    uint32_t filtro,
+    bool transitoria) const {
+    std::vector<vk::MemoryPropertyFlags> preferencias;
+    if (transitoria) {
+        preferencias.push_back(
+            vk::MemoryPropertyFlagBits::eDeviceLocal |
+            vk::MemoryPropertyFlagBits::eLazilyAllocated);
+    }
+    preferencias.push_back(
+        vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    for (auto propriedades : preferencias) {
+        for (uint32_t i = 0; i < propriedades_.memoryTypeCount;
+             i++) {
+            bool passaPeloFiltro = (1u << i) & filtro;
+            bool possuiAsPropriedades =
+                (propriedades_.memoryTypes[i].propertyFlags &
+                 propriedades) == propriedades;
+            if (passaPeloFiltro && possuiAsPropriedades) {
+                return i;
+            }
+        }
+    }
+
+    throw std::runtime_error(
+        "Não foi encontrado um tipo de memória para os alvos "
+        "de renderização.");
+}
+}  // namespace smv
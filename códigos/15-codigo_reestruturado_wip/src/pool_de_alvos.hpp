@@ -0,0 +1,111 @@
+#ifndef SMV_POOL_DE_ALVOS_HPP
+#define SMV_POOL_DE_ALVOS_HPP
+
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "alocador_de_memoria.hpp"
+#include "fila_de_destruicao.hpp"
+
+namespace smv {
+struct DescricaoDeAlvo {
+    vk::Format formato;
+    vk::Extent2D dimensoes;
+    vk::ImageUsageFlags usos;
+    vk::ImageAspectFlags aspectos;
+    // Intervalo, na ordem dos passes do quadro, em que o alvo
+    // é lido ou escrito.
+    uint32_t primeiroPasse = 0;
+    uint32_t ultimoPasse = 0;
+
+    bool operator==(const DescricaoDeAlvo& outra) const {
+        return formato == outra.formato &&
+               dimensoes == outra.dimensoes &&
+               usos == outra.usos &&
+               aspectos == outra.aspectos &&
+               primeiroPasse == outra.primeiroPasse &&
+               ultimoPasse == outra.ultimoPasse;
+    }
+};
+
+struct AlvoDeRenderizacao {
+    vk::Image imagem;
+    vk::ImageView visao;
+};
+
+struct EstatisticasDeAlvos {
+    uint32_t numAlvos = 0;
+    uint32_t numRegioes = 0;
+    uint32_t numRegioesPreguicosas = 0;
+    // Soma dos requisitos de cada alvo, como se nenhum
+    // dividisse memória.
+    vk::DeviceSize bytesSemAliasing = 0;
+    vk::DeviceSize bytesAlocados = 0;
+};
+
+// Cria os anexos de renderização (profundidade, alvos de
+// pós-processamento etc.) de um quadro a partir de uma lista
+// de descrições.
+//
+// Alvos com eTransientAttachment vão para memória
+// eLazilyAllocated quando o dispositivo a oferece, e alvos
+// cujos intervalos de passes não se sobrepõem dividem a mesma
+// memória. Como o conteúdo de um alvo com memória dividida não
+// sobrevive ao passe de outro, ele deve sempre começar em
+// eUndefined, e passes que usam alvos na mesma memória precisam
+// de uma dependência entre eles.
+//
+// Se a lista compilada for igual à anterior, como ao recriar
+// a swapchain com as mesmas dimensões, os alvos são reusados.
+class PoolDeAlvos {
+  public:
+    using IdDeAlvo = uint32_t;
+
+    void iniciar(vk::PhysicalDevice dispositivoFisico,
+                 vk::Device dispositivo,
+                 AlocadorDeMemoria& alocador,
+                 FilaDeDestruicao& filaDeDestruicao);
+    void destruir();
+
+    void comecar() { declarados_.clear(); }
+    IdDeAlvo declarar(const DescricaoDeAlvo& descricao);
+    void compilar();
+
+    const AlvoDeRenderizacao& alvo(IdDeAlvo id) const {
+        return alvos_[id];
+    }
+
+    EstatisticasDeAlvos estatisticas() const {
+        return estatisticas_;
+    }
+    void imprimirEstatisticas() const;
+
+  private:
+    struct Regiao {
+        Alocacao alocacao;
+        vk::DeviceSize tamanho = 0;
+        vk::DeviceSize alinhamento = 1;
+        uint32_t tiposDeMemoria = ~0u;
+        bool transitoria = false;
+        uint32_t ultimoPasse = 0;
+    };
+
+    void adiarDestruicao();
+    uint32_t escolherTipoDeMemoria(uint32_t filtro,
+                                   bool transitoria) const;
+
+    vk::Device dispositivo_;
+    AlocadorDeMemoria* alocador_ = nullptr;
+    FilaDeDestruicao* filaDeDestruicao_ = nullptr;
+    vk::PhysicalDeviceMemoryProperties propriedades_;
+
+    std::vector<DescricaoDeAlvo> declarados_;
+    std::vector<DescricaoDeAlvo> compilados_;
+    std::vector<AlvoDeRenderizacao> alvos_;
+    std::vector<Regiao> regioes_;
+    EstatisticasDeAlvos estatisticas_;
+};
+}  // namespace smv
+
+#endif
@@ -0,0 +1,248 @@
+#include "pool_de_geometria.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "indices_de_malha.hpp"
+
+namespace smv {
+void PoolDeGeometria::iniciar(
+    ContextoDeEnvio& contextoDeEnvio,
+    std::vector<vk::DeviceSize> tamanhosDosFluxos,
+    vk::Buffer bufferDeVertices,
+    uint32_t capacidadeDeVertices,
+    vk::Buffer bufferDeIndices,
+    vk::DeviceSize tamanhoDoBufferDeIndices) {
+    contextoDeEnvio_ = &contextoDeEnvio;
+    tamanhosDosFluxos_ = std::move(tamanhosDosFluxos);
+    capacidadeDeVertices_ = capacidadeDeVertices;
+    bufferDeVertices_ = bufferDeVertices;
+    bufferDeIndices_ = bufferDeIndices;
+    versaoDosBuffers_++;
+    vertices_.emplace(capacidadeDeVertices);
+    registros_.clear();
+    idsLivres_.clear();
+    indices_.emplace(tamanhoDoBufferDeIndices);
+}
+
+vk::DeviceSize PoolDeGeometria::inicioDoFluxo(
+    uint32_t fluxo,
+    uint32_t capacidade) const {
+    vk::DeviceSize inicio = 0;
+    for (uint32_t i = 0; i < fluxo; i++) {
+        inicio += capacidade * tamanhosDosFluxos_[i];
+    }
+    return inicio;
+}
+
+vk::DeviceSize
+PoolDeGeometria::Registro::deslocamentoDosIndices() const {
+    return vk::DeviceSize{malha.primeiroIndice} *
+           tamanhoDoIndice(malha.tipoDeIndice);
+}
+
+vk::DeviceSize PoolDeGeometria::Registro::tamanhoDosIndices()
+    const {
+    return vk::DeviceSize{malha.numIndices} *
+           tamanhoDoIndice(malha.tipoDeIndice);
+}
+
+std::optional<PoolDeGeometria::IdDeMalha>
+PoolDeGeometria::adicionar(
+    const std::vector<const void*>& fluxos,
+    uint32_t numVertices,
+    const void* indices,
+    uint32_t numIndices,
+    vk::IndexType tipoDeIndice) {
+    if (fluxos.size() != tamanhosDosFluxos_.size()) {
+        throw std::logic_error(
+            "A malha não tem um vetor para cada fluxo.");
+    }
+
+    auto primeiroVertice = vertices_->alocar(numVertices, 1);
+    if (!primeiroVertice.has_value()) {
+        return {};
+    }
+    // Alinhar ao tamanho do índice deixa o deslocamento
+    // expressável como primeiro índice.
+    vk::DeviceSize tamanhoDoIndice =
+        smv::tamanhoDoIndice(tipoDeIndice);
+    auto deslocamentoDosIndices = indices_->alocar(
+        numIndices * tamanhoDoIndice, tamanhoDoIndice);
+    if (!deslocamentoDosIndices.has_value()) {
+        vertices_->liberar(primeiroVertice.value());
+        return {};
+    }
+
+    Registro registro;
+    registro.ativo = true;
+    registro.numVertices = numVertices;
+    registro.malha.numIndices = numIndices;
+    registro.malha.primeiroIndice = static_cast<uint32_t>(
+        deslocamentoDosIndices.value() / tamanhoDoIndice);
+    registro.malha.tipoDeIndice = tipoDeIndice;
+    registro.malha.deslocamentoDeVertice =
+        static_cast<int32_t>(primeiroVertice.value());
+
+    for (uint32_t i = 0; i < fluxos.size(); i++) {
+        contextoDeEnvio_->enviarParaBuffer(
+            bufferDeVertices_,
+            inicioDoFluxo(i, capacidadeDeVertices_) +
+                primeiroVertice.value() * tamanhosDosFluxos_[i],
+            fluxos[i], numVertices * tamanhosDosFluxos_[i],
+            vk::PipelineStageFlagBits::eVertexInput,
+            vk::AccessFlagBits::eVertexAttributeRead);
+    }
+    contextoDeEnvio_->enviarParaBuffer(
+        bufferDeIndices_, deslocamentoDosIndices.value(),
+        indices, registro.tamanhoDosIndices(),
+        vk::PipelineStageFlagBits::eVertexInput,
+        vk::AccessFlagBits::eIndexRead);
+
+    if (!idsLivres_.empty()) {
+        IdDeMalha id = idsLivres_.back();
+        idsLivres_.pop_back();
+        registros_[id] = registro;
+        return id;
+    }
+    registros_.push_back(registro);
+    return static_cast<IdDeMalha>(registros_.size() - 1);
+}
+
+void PoolDeGeometria::remover(IdDeMalha id) {
+    auto& registro = registros_.at(id);
+    if (!registro.ativo) {
+        throw std::logic_error("A malha já foi removida.");
+    }
+
+    vertices_->liberar(static_cast<uint64_t>(
+        registro.malha.deslocamentoDeVertice));
+    indices_->liberar(registro.deslocamentoDosIndices());
+    registro = {};
+    idsLivres_.push_back(id);
+}
+
+void PoolDeGeometria::compactar(
+    vk::CommandBuffer comando,
+    vk::Buffer novoBufferDeVertices,
+    uint32_t novaCapacidadeDeVertices,
+    vk::Buffer novoBufferDeIndices,
+    vk::DeviceSize novoTamanhoDoBufferDeIndices) {
+    AlocadorDeIntervalos novosVertices(
+        novaCapacidadeDeVertices);
+    AlocadorDeIntervalos novosIndices(
+        novoTamanhoDoBufferDeIndices);
+    std::vector<vk::BufferCopy> copiasDeVertices;
+    std::vector<vk::BufferCopy> copiasDeIndices;
+
+    // As malhas mantêm a ordem em que estavam no buffer de
+    // índices. O primeiro índice é contado em índices de
+    // larguras diferentes, então a ordem vem do deslocamento
+    // em bytes.
+    std::vector<Registro*> ativos;
+    for (auto&& registro : registros_) {
+        if (registro.ativo) {
+            ativos.push_back(&registro);
+        }
+    }
+    std::sort(ativos.begin(), ativos.end(),
+              [](const Registro* a, const Registro* b) {
+                  return a->deslocamentoDosIndices() <
+                         b->deslocamentoDosIndices();
+              });
+
+    for (auto registro : ativos) {
+        auto primeiroVertice =
+            novosVertices.alocar(registro->numVertices, 1);
+        auto deslocamentoDosIndices = novosIndices.alocar(
+            registro->tamanhoDosIndices(),
+            tamanhoDoIndice(registro->malha.tipoDeIndice));
+        if (!primeiroVertice.has_value() ||
+            !deslocamentoDosIndices.has_value()) {
+            throw std::runtime_error(
+                "As malhas não cabem nos novos buffers do pool "
+                "de geometria.");
+        }
+
+        auto verticeAntigo = static_cast<vk::DeviceSize>(
+            registro->malha.deslocamentoDeVertice);
+        for (uint32_t i = 0; i < tamanhosDosFluxos_.size();
+             i++) {
+            auto tamanho = tamanhosDosFluxos_[i];
+            copiasDeVertices.push_back(vk::BufferCopy{
+                inicioDoFluxo(i, capacidadeDeVertices_) +
+                    verticeAntigo * tamanho,
+                inicioDoFluxo(i, novaCapacidadeDeVertices) +
+                    primeiroVertice.value() * tamanho,
+                registro->numVertices * tamanho});
+        }
+        copiasDeIndices.push_back(vk::BufferCopy{
+            registro->deslocamentoDosIndices(),
+            deslocamentoDosIndices.value(),
+            registro->tamanhoDosIndices()});
+
+        registro->malha.deslocamentoDeVertice =
+            static_cast<int32_t>(primeiroVertice.value());
+        registro->malha.primeiroIndice = static_cast<uint32_t>(
+            deslocamentoDosIndices.value() /
+            tamanhoDoIndice(registro->malha.tipoDeIndice));
+    }
+
+    // Espera os envios e desenhos anteriores que usaram os
+    // buffers antigos.
+    vk::MemoryBarrier antes{vk::AccessFlagBits::eMemoryWrite,
+                            vk::AccessFlagBits::eTransferRead};
+    comando.pipelineBarrier(
+        vk::PipelineStageFlagBits::eAllCommands,
+        vk::PipelineStageFlagBits::eTransfer, {}, antes, {},
+        {});
+
+    if (!copiasDeVertices.empty()) {
+        comando.copyBuffer(bufferDeVertices_,
+                           novoBufferDeVertices,
+                           copiasDeVertices);
+        comando.copyBuffer(bufferDeIndices_,
+                           novoBufferDeIndices,
+                           copiasDeIndices);
+    }
+
+    // Os quadros submetidos depois na mesma fila leem os novos
+    // buffers como vértices e índices, e o descarte de meshlets
+    // lê os índices num shader de computação.
+    vk::MemoryBarrier depois{
+        vk::AccessFlagBits::eTransferWrite,
+        vk::AccessFlagBits::eVertexAttributeRead |
+            vk::AccessFlagBits::eIndexRead |
+            vk::AccessFlagBits::eShaderRead};
+    comando.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eVertexInput |
+            vk::PipelineStageFlagBits::eComputeShader,
+        {}, depois, {}, {});
+
+    bufferDeVertices_ = novoBufferDeVertices;
+    capacidadeDeVertices_ = novaCapacidadeDeVertices;
+    bufferDeIndices_ = novoBufferDeIndices;
+    versaoDosBuffers_++;
+    vertices_.emplace(std::move(novosVertices));
+    indices_.emplace(std::move(novosIndices));
+}
+
+void PoolDeGeometria::associarVertices(
+    vk::CommandBuffer comando) const {
+    std::vector<vk::Buffer> buffers(tamanhosDosFluxos_.size(),
+                                    bufferDeVertices_);
+    std::vector<vk::DeviceSize> deslocamentos;
+    for (uint32_t i = 0; i < tamanhosDosFluxos_.size(); i++) {
+        deslocamentos.push_back(
+            inicioDoFluxo(i, capacidadeDeVertices_));
+    }
+    comando.bindVertexBuffers(0, buffers, deslocamentos);
+}
+
+void PoolDeGeometria::associarIndices(
+    vk::CommandBuffer comando,
+    vk::IndexType tipoDeIndice) const {
+    comando.bindIndexBuffer(bufferDeIndices_, 0, tipoDeIndice);
+}
+}  // namespace smv
@@ -0,0 +1,134 @@
+#ifndef SMV_POOL_DE_GEOMETRIA_HPP
+#define SMV_POOL_DE_GEOMETRIA_HPP
+
+#include <optional>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "alocador_de_intervalos.hpp"
+#include "contexto_de_envio.hpp"
+
+namespace smv {
+// Argumentos de drawIndexed de uma malha dentro do pool. O
+// primeiro índice é contado em índices de `tipoDeIndice`, com
+// o buffer de índices associado a partir do começo.
+struct Malha {
+    uint32_t numIndices = 0;
+    uint32_t primeiroIndice = 0;
+    int32_t deslocamentoDeVertice = 0;
+    vk::IndexType tipoDeIndice = vk::IndexType::eUint16;
+};
+
+// Guarda os vértices e índices de todas as malhas em um único
+// buffer de vértices e um único buffer de índices, que são
+// associados uma vez por quadro. Cada malha ocupa um intervalo
+// de cada buffer e é desenhada só com os seus deslocamentos.
+// Malhas com índices de 16 e de 32 bits dividem o buffer de
+// índices, que é associado de novo ao trocar de largura.
+//
+// Os vértices ficam separados em fluxos, um por associação,
+// cada um numa região própria do buffer de vértices com
+// `capacidadeDeVertices` vértices. Uma malha ocupa o mesmo
+// intervalo de vértices em todas as regiões.
+//
+// Os buffers pertencem a quem chama; o pool só decide onde
+// cada malha fica e grava os envios e as cópias. Como eles
+// têm tamanho fixo, remover uma malha não devolve memória ao
+// heap, e por isso as malhas não são despejadas pelo
+// orçamento de memória.
+class PoolDeGeometria {
+  public:
+    using IdDeMalha = uint32_t;
+
+    void iniciar(ContextoDeEnvio& contextoDeEnvio,
+                 std::vector<vk::DeviceSize> tamanhosDosFluxos,
+                 vk::Buffer bufferDeVertices,
+                 uint32_t capacidadeDeVertices,
+                 vk::Buffer bufferDeIndices,
+                 vk::DeviceSize tamanhoDoBufferDeIndices);
+
+    // Reserva os intervalos da malha e grava o envio dos dados.
+    // Retorna vazio se não houver espaço contíguo suficiente,
+    // caso em que compactar o pool pode resolver. `fluxos`
+    // tem os vértices de cada fluxo, na ordem das associações.
+    std::optional<IdDeMalha> adicionar(
+        const std::vector<const void*>& fluxos,
+        uint32_t numVertices,
+        const void* indices,
+        uint32_t numIndices,
+        vk::IndexType tipoDeIndice);
+    // A GPU não pode mais estar lendo a malha, já que os
+    // intervalos dela podem ser reusados na hora.
+    void remover(IdDeMalha id);
+
+    const Malha& malha(IdDeMalha id) const {
+        return registros_[id].malha;
+    }
+
+    // Grava em `comando` a cópia de todas as malhas para o
+    // início dos novos buffers, sem buracos entre elas, e passa
+    // a usá-los. Os antigos só podem ser destruídos depois que
+    // `comando` terminar de executar.
+    void compactar(vk::CommandBuffer comando,
+                   vk::Buffer novoBufferDeVertices,
+                   uint32_t novaCapacidadeDeVertices,
+                   vk::Buffer novoBufferDeIndices,
+                   vk::DeviceSize novoTamanhoDoBufferDeIndices);
+
+    // Associa cada fluxo à associação de mesmo número. Uma
+    // pipeline que não lê um fluxo simplesmente o ignora.
+    void associarVertices(vk::CommandBuffer comando) const;
+    void associarIndices(vk::CommandBuffer comando,
+                         vk::IndexType tipoDeIndice) const;
+
+    vk::Buffer bufferDeVertices() const {
+        return bufferDeVertices_;
+    }
+    vk::Buffer bufferDeIndices() const {
+        return bufferDeIndices_;
+    }
+    // Muda sempre que o pool passa a usar outros buffers, para
+    // quem guarda os buffers em descritores.
+    uint32_t versaoDosBuffers() const {
+        return versaoDosBuffers_;
+    }
+    // Em número de vértices e em bytes de índices.
+    EstatisticasDeIntervalos estatisticasDeVertices() const {
+        return vertices_->estatisticas();
+    }
+    EstatisticasDeIntervalos estatisticasDeIndices() const {
+        return indices_->estatisticas();
+    }
+
+  private:
+    struct Registro {
+        Malha malha;
+        uint32_t numVertices = 0;
+        bool ativo = false;
+
+        vk::DeviceSize deslocamentoDosIndices() const;
+        vk::DeviceSize tamanhoDosIndices() const;
+    };
+
+    ContextoDeEnvio* contextoDeEnvio_ = nullptr;
+    // Início da região do fluxo num buffer de vértices com
+    // a capacidade dada.
+    vk::DeviceSize inicioDoFluxo(uint32_t fluxo,
+                                 uint32_t capacidade) const;
+
+    std::vector<vk::DeviceSize> tamanhosDosFluxos_;
+    uint32_t capacidadeDeVertices_ = 0;
+
+    vk::Buffer bufferDeVertices_;
+    vk::Buffer bufferDeIndices_;
+    uint32_t versaoDosBuffers_ = 0;
+    std::optional<AlocadorDeIntervalos> vertices_;
+    std::optional<AlocadorDeIntervalos> indices_;
+
+    std::vector<Registro> registros_;
+    std::vector<IdDeMalha> idsLivres_;
+};
+}  // namespace smv
+
+#endif
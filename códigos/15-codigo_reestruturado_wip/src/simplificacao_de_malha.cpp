@@ -0,0 +1,453 @@
+#include "simplificacao_de_malha.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+#include "otimizacao_de_malha.hpp"
+
+namespace smv {
+namespace {
+// Um nível precisa ter pelo menos esta fração dos triângulos do
+// anterior a menos para entrar na cadeia.
+constexpr float kReducaoMinimaPorNivel = 0.1f;
+constexpr size_t kMinimoDeTriangulos = 8;
+// Cada passe só considera esta fração das arestas, as de menor
+// erro.
+constexpr double kFracaoDeArestasPorPasse = 0.25;
+constexpr uint32_t kNenhum =
+    std::numeric_limits<uint32_t>::max();
+
+// Matriz simétrica 4x4 que, aplicada a um ponto, soma os
+// quadrados das distâncias dele aos planos acumulados, cada um
+// com o peso da área do triângulo.
+struct Quadrica {
+    std::array<double, 10> a{};
+    double peso = 0.0;
+
+    void adicionarPlano(const glm::vec3& normal,
+                        float distancia,
+                        float area) {
+        const double plano[4] = {normal.x, normal.y, normal.z,
+                                 distancia};
+        size_t k = 0;
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t j = i; j < 4; j++) {
+                a[k++] += area * plano[i] * plano[j];
+            }
+        }
+        peso += area;
+    }
+
+    Quadrica& operator+=(const Quadrica& outra) {
+        for (size_t k = 0; k < a.size(); k++) {
+            a[k] += outra.a[k];
+        }
+        peso += outra.peso;
+        return *this;
+    }
+
+    // Erro quadrático médio no ponto.
+    double avaliar(const glm::vec3& ponto) const {
+        if (peso <= 0.0) {
+            return 0.0;
+        }
+        const double p[4] = {ponto.x, ponto.y, ponto.z, 1.0};
+        double soma = 0.0;
+        size_t k = 0;
+        for (size_t i = 0; i < 4; i++) {
+            for (size_t j = i; j < 4; j++) {
+                double termo = a[k++] * p[i] * p[j];
+                soma += i == j ? termo : 2.0 * termo;
+            }
+        }
+        return std::max(soma, 0.0) / peso;
+    }
+};
+
+struct Colapso {
+    uint32_t origem;
+    uint32_t destino;
+    double erro;
+};
+
+uint64_t chaveDaAresta(uint32_t a, uint32_t b) {
+    return uint64_t{std::min(a, b)} << 32 | std::max(a, b);
+}
+
+bool degenerado(const uint32_t* triangulo) {
+    return triangulo[0] == triangulo[1] ||
+           triangulo[1] == triangulo[2] ||
+           triangulo[2] == triangulo[0];
+}
+
+class Simplificador {
+  public:
+    Simplificador(const std::vector<Vertice>& vertices,
+                  const std::vector<uint32_t>& indices)
+        : vertices_(vertices),
+          indices_(indices),
+          grupo_(vertices.size()),
+          proximaCopia_(vertices.size()),
+          travado_(vertices.size()),
+          quadricas_(vertices.size()) {
+        agruparPorPosicao();
+        acumularQuadricas();
+    }
+
+    const std::vector<uint32_t>& indices() const {
+        return indices_;
+    }
+    float erro() const { return erro_; }
+
+    // Colapsa arestas até restarem no máximo `alvo` índices,
+    // ou até nenhuma aresta poder ser colapsada.
+    void simplificar(size_t alvo) {
+        while (indices_.size() > alvo) {
+            if (passe(alvo) == 0) {
+                break;
+            }
+        }
+    }
+
+  private:
+    // Os vértices de uma costura só diferem nos atributos,
+    // então as costuras e as bordas são achadas pelas
+    // posições.
+    void agruparPorPosicao() {
+        std::unordered_map<glm::vec3, uint32_t> porPosicao;
+        for (size_t i = 0; i < vertices_.size(); i++) {
+            auto v = static_cast<uint32_t>(i);
+            auto [primeira, nova] = porPosicao.emplace(
+                vertices_[i].posicao, v);
+            grupo_[i] = primeira->second;
+            // Insere o vértice na lista circular das cópias.
+            proximaCopia_[i] = v;
+            if (!nova) {
+                proximaCopia_[i] =
+                    proximaCopia_[primeira->second];
+                proximaCopia_[primeira->second] = v;
+            }
+        }
+
+        std::unordered_map<uint64_t, uint32_t> arestas;
+        for (size_t t = 0; t < indices_.size(); t += 3) {
+            for (size_t i = 0; i < 3; i++) {
+                arestas[chaveDaAresta(
+                    grupo_[indices_[t + i]],
+                    grupo_[indices_[t + (i + 1) % 3]])]++;
+            }
+        }
+        // Usadas por um triângulo só, são bordas; por mais de
+        // dois, a malha não é uma variedade ali.
+        std::vector<bool> grupoTravado(vertices_.size());
+        for (const auto& [chave, usos] : arestas) {
+            if (usos != 2) {
+                grupoTravado[chave >> 32] = true;
+                grupoTravado[chave & 0xFFFFFFFF] = true;
+            }
+        }
+        for (size_t i = 0; i < vertices_.size(); i++) {
+            travado_[i] = grupoTravado[grupo_[i]];
+        }
+    }
+
+    // As cópias de uma posição compartilham a quádrica, com os
+    // planos dos dois lados da costura.
+    void acumularQuadricas() {
+        for (size_t t = 0; t < indices_.size(); t += 3) {
+            glm::vec3 p0 = vertices_[indices_[t]].posicao;
+            glm::vec3 p1 = vertices_[indices_[t + 1]].posicao;
+            glm::vec3 p2 = vertices_[indices_[t + 2]].posicao;
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float dobroDaArea = glm::length(normal);
+            if (dobroDaArea <= 0.0f) {
+                continue;
+            }
+            normal /= dobroDaArea;
+            for (size_t i = 0; i < 3; i++) {
+                quadricas_[grupo_[indices_[t + i]]]
+                    .adicionarPlano(normal,
+                                    -glm::dot(normal, p0),
+                                    dobroDaArea / 2.0f);
+            }
+        }
+    }
+
+    // Um passe colapsa, em ordem de erro, as arestas que não
+    // tocam a vizinhança de um colapso anterior do mesmo
+    // passe, e retorna quantas colapsou. Só as arestas mais
+    // baratas entram; as outras esperam os próximos passes,
+    // com o erro reavaliado, senão um passe só faria colapsos
+    // de todo erro e os níveis seguintes herdariam o maior.
+    size_t passe(size_t alvo) {
+        construirAdjacencia();
+
+        std::vector<Colapso> colapsos;
+        for (size_t t = 0; t < indices_.size(); t += 3) {
+            for (size_t i = 0; i < 3; i++) {
+                uint32_t a = indices_[t + i];
+                uint32_t b = indices_[t + (i + 1) % 3];
+                // Cada aresta interna aparece nos dois
+                // triângulos; basta um sentido em cada.
+                if (!travado_[a] && grupo_[a] != grupo_[b]) {
+                    colapsos.push_back(
+                        {a, b, erroDoColapso(a, b)});
+                }
+            }
+        }
+        std::sort(colapsos.begin(), colapsos.end(),
+                  [](const Colapso& a, const Colapso& b) {
+                      return a.erro < b.erro;
+                  });
+        size_t considerados = static_cast<size_t>(std::ceil(
+            static_cast<double>(colapsos.size()) *
+            kFracaoDeArestasPorPasse));
+        colapsos.resize(considerados);
+
+        std::vector<bool> tocado(vertices_.size());
+        std::vector<std::pair<uint32_t, uint32_t>> pares;
+        size_t numIndices = indices_.size();
+        size_t numColapsos = 0;
+        for (const auto& colapso : colapsos) {
+            if (numIndices <= alvo) {
+                break;
+            }
+            if (!emparelharCopias(colapso.origem,
+                                  colapso.destino, tocado,
+                                  pares)) {
+                continue;
+            }
+
+            for (auto [origem, destino] : pares) {
+                numIndices -= colapsar(origem, destino, tocado);
+            }
+            quadricas_[grupo_[colapso.destino]] +=
+                quadricas_[grupo_[colapso.origem]];
+            erro_ = std::max(
+                erro_,
+                static_cast<float>(std::sqrt(colapso.erro)));
+            numColapsos++;
+        }
+
+        size_t escrito = 0;
+        for (size_t t = 0; t < indices_.size(); t += 3) {
+            if (!degenerado(&indices_[t])) {
+                std::copy_n(&indices_[t], 3,
+                            &indices_[escrito]);
+                escrito += 3;
+            }
+        }
+        indices_.resize(escrito);
+        return numColapsos;
+    }
+
+    // Numa costura, todas as cópias da origem colapsam juntas,
+    // cada uma sobre uma vizinha na posição do destino, para
+    // que a costura continue fechada. Falso se alguma cópia não
+    // puder colapsar.
+    bool emparelharCopias(
+        uint32_t origem,
+        uint32_t destino,
+        const std::vector<bool>& tocado,
+        std::vector<std::pair<uint32_t, uint32_t>>& pares)
+        const {
+        pares.clear();
+        uint32_t copia = origem;
+        do {
+            uint32_t par =
+                copia == origem
+                    ? destino
+                    : vizinhaNoGrupo(copia, grupo_[destino]);
+            if (par == kNenhum || tocado[copia] ||
+                tocado[par] || inverteTriangulos(copia, par)) {
+                return false;
+            }
+            pares.emplace_back(copia, par);
+            copia = proximaCopia_[copia];
+        } while (copia != origem);
+        return true;
+    }
+
+    uint32_t vizinhaNoGrupo(uint32_t vertice,
+                            uint32_t grupo) const {
+        for (uint32_t t : triangulosDe(vertice)) {
+            for (size_t i = 0; i < 3; i++) {
+                uint32_t vizinha = indices_[t * 3 + i];
+                if (grupo_[vizinha] == grupo) {
+                    return vizinha;
+                }
+            }
+        }
+        return kNenhum;
+    }
+
+    // Troca a origem pelo destino nos triângulos dela e marca a
+    // vizinhança como tocada. Retorna quantos índices saem com
+    // os triângulos que ficaram degenerados.
+    size_t colapsar(uint32_t origem,
+                    uint32_t destino,
+                    std::vector<bool>& tocado) {
+        size_t removidos = 0;
+        for (uint32_t t : triangulosDe(origem)) {
+            uint32_t* triangulo = &indices_[t * 3];
+            if (std::find(triangulo, triangulo + 3, destino) !=
+                triangulo + 3) {
+                removidos += 3;
+            }
+            for (size_t i = 0; i < 3; i++) {
+                tocado[triangulo[i]] = true;
+                if (triangulo[i] == origem) {
+                    triangulo[i] = destino;
+                }
+            }
+        }
+        return removidos;
+    }
+
+    double erroDoColapso(uint32_t origem,
+                         uint32_t destino) const {
+        Quadrica soma = quadricas_[grupo_[origem]];
+        soma += quadricas_[grupo_[destino]];
+        return soma.avaliar(vertices_[destino].posicao);
+    }
+
+    // Um triângulo em volta da origem que não contém o destino
+    // não pode virar de lado ao ser esticado até ele.
+    bool inverteTriangulos(uint32_t origem,
+                           uint32_t destino) const {
+        for (uint32_t t : triangulosDe(origem)) {
+            const uint32_t* triangulo = &indices_[t * 3];
+            if (std::find(triangulo, triangulo + 3, destino) !=
+                triangulo + 3) {
+                continue;
+            }
+            std::array<glm::vec3, 3> antes, depois;
+            for (size_t i = 0; i < 3; i++) {
+                antes[i] = vertices_[triangulo[i]].posicao;
+                depois[i] =
+                    triangulo[i] == origem
+                        ? vertices_[destino].posicao
+                        : antes[i];
+            }
+            glm::vec3 normalAntes = glm::cross(
+                antes[1] - antes[0], antes[2] - antes[0]);
+            glm::vec3 normalDepois = glm::cross(
+                depois[1] - depois[0], depois[2] - depois[0]);
+            if (glm::dot(normalAntes, normalDepois) <= 0.0f) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Os triângulos de cada vértice, contíguos em
+    // `triangulos_`, entre `inicioDosTriangulos_[v]` e
+    // `inicioDosTriangulos_[v + 1]`.
+    void construirAdjacencia() {
+        inicioDosTriangulos_.assign(vertices_.size() + 1, 0);
+        for (uint32_t indice : indices_) {
+            inicioDosTriangulos_[indice + 1]++;
+        }
+        for (size_t v = 0; v < vertices_.size(); v++) {
+            inicioDosTriangulos_[v + 1] +=
+                inicioDosTriangulos_[v];
+        }
+        triangulos_.resize(indices_.size());
+        std::vector<uint32_t> preenchidos(
+            inicioDosTriangulos_.begin(),
+            inicioDosTriangulos_.end() - 1);
+        for (size_t i = 0; i < indices_.size(); i++) {
+            triangulos_[preenchidos[indices_[i]]++] =
+                static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    struct Intervalo {
+        const uint32_t* inicio;
+        const uint32_t* fim;
+        const uint32_t* begin() const { return inicio; }
+        const uint32_t* end() const { return fim; }
+    };
+
+    Intervalo triangulosDe(uint32_t vertice) const {
+        return {triangulos_.data() +
+                    inicioDosTriangulos_[vertice],
+                triangulos_.data() +
+                    inicioDosTriangulos_[vertice + 1]};
+    }
+
+    const std::vector<Vertice>& vertices_;
+    std::vector<uint32_t> indices_;
+    // O primeiro vértice com a mesma posição.
+    std::vector<uint32_t> grupo_;
+    std::vector<uint32_t> proximaCopia_;
+    // Nas bordas ou onde a malha não é uma variedade.
+    std::vector<bool> travado_;
+    // Indexadas pelo grupo.
+    std::vector<Quadrica> quadricas_;
+    float erro_ = 0.0f;
+
+    std::vector<uint32_t> inicioDosTriangulos_;
+    std::vector<uint32_t> triangulos_;
+};
+}  // namespace
+
+std::vector<NivelDeDetalhe> gerarNiveisDeDetalhe(
+    const std::vector<Vertice>& vertices,
+    const std::vector<uint32_t>& indices,
+    size_t maximoDeNiveis) {
+    std::vector<NivelDeDetalhe> niveis = {{indices, 0.0f}};
+
+    // Cada nível continua de onde o anterior parou, com as
+    // quádricas acumuladas desde a malha original.
+    Simplificador simplificador(vertices, indices);
+    while (niveis.size() < maximoDeNiveis) {
+        size_t anterior = niveis.back().indices.size();
+        size_t alvo = anterior / 6 * 3;
+        if (alvo < kMinimoDeTriangulos * 3) {
+            break;
+        }
+        simplificador.simplificar(alvo);
+
+        size_t obtido = simplificador.indices().size();
+        if (static_cast<float>(obtido) >
+            static_cast<float>(anterior) *
+                (1.0f - kReducaoMinimaPorNivel)) {
+            break;
+        }
+        NivelDeDetalhe nivel = {
+            otimizarCacheDeVertices(simplificador.indices(),
+                                    vertices.size()),
+            simplificador.erro()};
+        // Com o mesmo erro, o nível anterior nunca seria
+        // escolhido no lugar deste, que tem menos triângulos.
+        if (niveis.size() > 1 &&
+            nivel.erro <= niveis.back().erro) {
+            niveis.back() = std::move(nivel);
+        } else {
+            niveis.push_back(std::move(nivel));
+        }
+    }
+    return niveis;
+}
+
+std::vector<NivelDaMalha> juntarNiveis(
+    const std::vector<NivelDeDetalhe>& niveis,
+    std::vector<uint32_t>& indices) {
+    std::vector<NivelDaMalha> trechos;
+    indices.clear();
+    for (const auto& nivel : niveis) {
+        trechos.push_back(
+            {static_cast<uint32_t>(indices.size()),
+             static_cast<uint32_t>(nivel.indices.size()),
+             nivel.erro, 0, 0});
+        indices.insert(indices.end(), nivel.indices.begin(),
+                       nivel.indices.end());
+    }
+    return trechos;
+}
+}  // namespace smv
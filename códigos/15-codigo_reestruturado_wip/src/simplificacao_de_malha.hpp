@@ -0,0 +1,62 @@
+#ifndef SMV_SIMPLIFICACAO_DE_MALHA_HPP
+#define SMV_SIMPLIFICACAO_DE_MALHA_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "vertice.hpp"
+
+namespace smv {
+// Os triângulos de um nível de detalhe, sobre os mesmos
+// vértices da malha original, e o erro geométrico dele, na
+// unidade das posições.
+struct NivelDeDetalhe {
+    std::vector<uint32_t> indices;
+    float erro;
+};
+
+// Um nível de detalhe guardado junto dos outros: o trecho dele
+// nos índices da malha, que trazem todos os níveis em ordem, do
+// mais detalhado ao menos, e nos meshlets da malha.
+struct NivelDaMalha {
+    uint32_t primeiroIndice;
+    uint32_t numIndices;
+    float erro;
+    uint32_t primeiroMeshlet;
+    uint32_t numMeshlets;
+};
+
+constexpr size_t kMaximoDeNiveisDeDetalhe = 8;
+
+// Gera a cadeia de níveis de detalhe colapsando arestas na
+// ordem do erro das quádricas (Garland e Heckbert). O nível 0
+// é a malha original, e cada nível seguinte tem cerca de
+// metade dos triângulos do anterior. A cadeia para antes de
+// `maximoDeNiveis` quando a malha não reduz mais.
+//
+// Cada vértice é colapsado sobre um vizinho, sem ser movido,
+// então os níveis usam o mesmo buffer de vértices. Para que a
+// malha não rasgue, os vértices das bordas não são colapsados,
+// e os de uma costura de atributos, onde vértices diferentes
+// têm a mesma posição, só colapsam junto com as cópias.
+//
+// O erro de cada nível é a maior raiz do erro quadrático médio
+// entre os colapsos feitos até ele: a distância de um vértice
+// colapsado aos planos dos triângulos originais em volta,
+// ponderados pela área. Depois do nível 1, o erro cresce
+// estritamente de um nível para o outro, para que todos possam
+// ser escolhidos. Os triângulos dos níveis gerados já vêm na
+// ordem otimizada para o cache de vértices.
+std::vector<NivelDeDetalhe> gerarNiveisDeDetalhe(
+    const std::vector<Vertice>& vertices,
+    const std::vector<uint32_t>& indices,
+    size_t maximoDeNiveis = kMaximoDeNiveisDeDetalhe);
+
+// Junta os índices de todos os níveis, em ordem, e retorna o
+// trecho de cada um, ainda sem meshlets.
+std::vector<NivelDaMalha> juntarNiveis(
+    const std::vector<NivelDeDetalhe>& niveis,
+    std::vector<uint32_t>& indices);
+}  // namespace smv
+
+#endif
@@ -0,0 +1,201 @@
+#include "textura_ktx2.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "alocador_de_intervalos.hpp"
+#include "compressao_bc.hpp"
+
+namespace smv {
+namespace {
+// Amostra do descritor básico: o intervalo de bits de um canal
+// dentro do bloco.
+void adicionarAmostra(std::vector<uint32_t>& dfd,
+                      uint32_t primeiroBit,
+                      uint32_t numBits,
+                      uint32_t canal) {
+    dfd.push_back(primeiroBit | (numBits - 1) << 16 |
+                  canal << 24);
+    dfd.push_back(0);
+    dfd.push_back(0);
+    dfd.push_back(std::numeric_limits<uint32_t>::max());
+}
+
+// O descritor de formato básico (Khronos Data Format) que o
+// KTX2 exige, para os formatos BC.
+std::vector<uint32_t> descritorDeFormato(vk::Format formato) {
+    constexpr uint32_t kModeloBc1 = 128;
+    constexpr uint32_t kModeloBc3 = 130;
+    constexpr uint32_t kModeloBc7 = 134;
+    constexpr uint32_t kCanalDeCor = 0;
+    constexpr uint32_t kCanalDeAlfaDoBc3 = 15;
+    constexpr uint32_t kPrimariasBt709 = 1;
+    constexpr uint32_t kTransferenciaLinear = 1;
+    constexpr uint32_t kTransferenciaSrgb = 2;
+
+    uint32_t bytesPorBloco = bytesPorBlocoBc(formato);
+    uint32_t modelo = kModeloBc7;
+    if (formato == vk::Format::eBc1RgbSrgbBlock ||
+        formato == vk::Format::eBc1RgbUnormBlock) {
+        modelo = kModeloBc1;
+    } else if (formato == vk::Format::eBc3SrgbBlock ||
+               formato == vk::Format::eBc3UnormBlock) {
+        modelo = kModeloBc3;
+    }
+    uint32_t numAmostras = modelo == kModeloBc3 ? 2 : 1;
+    bool srgb = formatoDescomprimido(formato) ==
+                vk::Format::eR8G8B8A8Srgb;
+    uint32_t transferencia =
+        srgb ? kTransferenciaSrgb : kTransferenciaLinear;
+
+    std::vector<uint32_t> dfd;
+    // O tamanho total é preenchido no fim.
+    dfd.push_back(0);
+    // Fabricante e tipo do descritor: Khronos, básico.
+    dfd.push_back(0);
+    // Versão 2 e tamanho do bloco do descritor.
+    dfd.push_back(2 | (24 + 16 * numAmostras) << 16);
+    dfd.push_back(modelo | kPrimariasBt709 << 8 |
+                  transferencia << 16);
+    // Dimensões do bloco menos um: 4x4x1x1.
+    dfd.push_back((kLadoDoBlocoBc - 1) |
+                  (kLadoDoBlocoBc - 1) << 8);
+    dfd.push_back(bytesPorBloco);
+    dfd.push_back(0);
+    if (modelo == kModeloBc3) {
+        adicionarAmostra(dfd, 0, 64, kCanalDeAlfaDoBc3);
+        adicionarAmostra(dfd, 64, 64, kCanalDeCor);
+    } else {
+        adicionarAmostra(dfd, 0, bytesPorBloco * 8,
+                         kCanalDeCor);
+    }
+    dfd[0] = static_cast<uint32_t>(dfd.size() *
+                                   sizeof(uint32_t));
+    return dfd;
+}
+}  // namespace
+
+void escreverTexturaKtx2(
+    const std::string& caminho,
+    vk::Format formato,
+    uint32_t largura,
+    uint32_t altura,
+    const std::vector<std::vector<uint8_t>>& niveis) {
+    auto dfd = descritorDeFormato(formato);
+    uint32_t numNiveis = static_cast<uint32_t>(niveis.size());
+
+    CabecalhoKtx2 cabecalho{};
+    cabecalho.identificador = kIdentificadorKtx2;
+    cabecalho.formato = static_cast<uint32_t>(formato);
+    cabecalho.tamanhoDoTipo = 1;
+    cabecalho.largura = largura;
+    cabecalho.altura = altura;
+    cabecalho.numFaces = 1;
+    cabecalho.numNiveis = numNiveis;
+    cabecalho.deslocamentoDoDfd = static_cast<uint32_t>(
+        sizeof(CabecalhoKtx2) + numNiveis * sizeof(NivelKtx2));
+    cabecalho.tamanhoDoDfd =
+        static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+
+    // Os níveis vão do menor para o maior, cada um alinhado ao
+    // tamanho do bloco.
+    uint64_t alinhamento = bytesPorBlocoBc(formato);
+    std::vector<NivelKtx2> indice(numNiveis);
+    uint64_t fim =
+        cabecalho.deslocamentoDoDfd + cabecalho.tamanhoDoDfd;
+    for (uint32_t i = numNiveis; i-- > 0;) {
+        indice[i].deslocamento =
+            alinharParaCima(fim, alinhamento);
+        indice[i].tamanho = niveis[i].size();
+        indice[i].tamanhoDescomprimido = niveis[i].size();
+        fim = indice[i].deslocamento + indice[i].tamanho;
+    }
+
+    std::ofstream arquivo(caminho, std::ios::binary);
+    if (!arquivo) {
+        throw std::runtime_error(
+            "Não foi possível criar o arquivo '" + caminho +
+            "'.");
+    }
+
+    auto escreverEmPosicao = [&arquivo](uint64_t posicao,
+                                        const void* dados,
+                                        size_t tamanho) {
+        // Preenche o espaço de alinhamento com zeros.
+        while (static_cast<uint64_t>(arquivo.tellp()) <
+               posicao) {
+            arquivo.put('\0');
+        }
+        arquivo.write(static_cast<const char*>(dados),
+                      static_cast<std::streamsize>(tamanho));
+    };
+    escreverEmPosicao(0, &cabecalho, sizeof(cabecalho));
+    escreverEmPosicao(sizeof(cabecalho), indice.data(),
+                      indice.size() * sizeof(NivelKtx2));
+    escreverEmPosicao(cabecalho.deslocamentoDoDfd, dfd.data(),
+                      cabecalho.tamanhoDoDfd);
+    for (uint32_t i = numNiveis; i-- > 0;) {
+        escreverEmPosicao(indice[i].deslocamento,
+                          niveis[i].data(), niveis[i].size());
+    }
+
+    if (!arquivo) {
+        throw std::runtime_error(
+            "Não foi possível escrever o arquivo '" + caminho +
+            "'.");
+    }
+}
+
+bool TexturaKtx2::abrir(const std::string& caminho) {
+    if (!arquivo_.abrir(caminho)) {
+        return false;
+    }
+
+    if (arquivo_.tamanho() < sizeof(CabecalhoKtx2) ||
+        cabecalho().identificador != kIdentificadorKtx2) {
+        fechar();
+        throw std::runtime_error("'" + caminho +
+                                 "' não é um arquivo KTX2.");
+    }
+
+    const auto& c = cabecalho();
+    if (c.supercompressao != 0 || c.profundidade > 1 ||
+        c.numCamadas > 1 || c.numFaces != 1 ||
+        c.numNiveis == 0) {
+        fechar();
+        throw std::runtime_error(
+            "'" + caminho +
+            "' não é uma textura 2D sem supercompressão.");
+    }
+
+    uint64_t fimDoIndice =
+        sizeof(CabecalhoKtx2) +
+        uint64_t{c.numNiveis} * sizeof(NivelKtx2);
+    bool truncado = fimDoIndice > arquivo_.tamanho();
+    for (uint32_t i = 0; !truncado && i < c.numNiveis; i++) {
+        const auto& nivel = entradaDoNivel(i);
+        truncado = nivel.deslocamento + nivel.tamanho >
+                   arquivo_.tamanho();
+    }
+    if (truncado) {
+        fechar();
+        throw std::runtime_error("A textura '" + caminho +
+                                 "' está truncada.");
+    }
+
+    return true;
+}
+
+NivelDeTextura TexturaKtx2::nivel(uint32_t indice) const {
+    const auto& entrada = entradaDoNivel(indice);
+    NivelDeTextura nivel;
+    nivel.dados = reinterpret_cast<const uint8_t*>(
+        arquivo_.dados() + entrada.deslocamento);
+    nivel.tamanho = static_cast<size_t>(entrada.tamanho);
+    nivel.largura = std::max(cabecalho().largura >> indice, 1u);
+    nivel.altura = std::max(cabecalho().altura >> indice, 1u);
+    return nivel;
+}
+}  // namespace smv
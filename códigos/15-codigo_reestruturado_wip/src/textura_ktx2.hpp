@@ -0,0 +1,94 @@
+#ifndef SMV_TEXTURA_KTX2_HPP
+#define SMV_TEXTURA_KTX2_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "arquivo_mapeado.hpp"
+
+namespace smv {
+// Cabeçalho de um arquivo KTX2, seguido do índice de níveis,
+// do descritor de formato (DFD) e dos níveis, do menor para o
+// maior. Tudo em little-endian.
+struct CabecalhoKtx2 {
+    std::array<uint8_t, 12> identificador;
+    // Um VkFormat.
+    uint32_t formato;
+    uint32_t tamanhoDoTipo;
+    uint32_t largura;
+    uint32_t altura;
+    uint32_t profundidade;
+    uint32_t numCamadas;
+    uint32_t numFaces;
+    uint32_t numNiveis;
+    uint32_t supercompressao;
+    uint32_t deslocamentoDoDfd;
+    uint32_t tamanhoDoDfd;
+    uint32_t deslocamentoDoKvd;
+    uint32_t tamanhoDoKvd;
+    uint64_t deslocamentoDoSgd;
+    uint64_t tamanhoDoSgd;
+};
+static_assert(sizeof(CabecalhoKtx2) == 80,
+              "O cabeçalho faz parte do formato do arquivo.");
+
+struct NivelKtx2 {
+    uint64_t deslocamento;
+    uint64_t tamanho;
+    uint64_t tamanhoDescomprimido;
+};
+
+constexpr std::array<uint8_t, 12> kIdentificadorKtx2 = {
+    0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n', 0x1a,
+    '\n'};
+
+// Escreve uma textura 2D com os níveis já comprimidos em BC1,
+// BC3 ou BC7, começando pelo nível 0.
+void escreverTexturaKtx2(
+    const std::string& caminho,
+    vk::Format formato,
+    uint32_t largura,
+    uint32_t altura,
+    const std::vector<std::vector<uint8_t>>& niveis);
+
+struct NivelDeTextura {
+    const uint8_t* dados;
+    size_t tamanho;
+    uint32_t largura;
+    uint32_t altura;
+};
+
+// Arquivo KTX2 mapeado em memória. Os níveis apontam direto
+// para o mapeamento, de onde vão para o anel de preparo.
+// Só texturas 2D sem supercompressão são aceitas.
+class TexturaKtx2 {
+  public:
+    // Retorna falso se o arquivo não existir. Lança uma
+    // exceção se ele não for um KTX2 que o motor saiba ler.
+    bool abrir(const std::string& caminho);
+    void fechar() { arquivo_.fechar(); }
+
+    const CabecalhoKtx2& cabecalho() const {
+        return *reinterpret_cast<const CabecalhoKtx2*>(
+            arquivo_.dados());
+    }
+    vk::Format formato() const {
+        return static_cast<vk::Format>(cabecalho().formato);
+    }
+    NivelDeTextura nivel(uint32_t indice) const;
+
+  private:
+    const NivelKtx2& entradaDoNivel(uint32_t indice) const {
+        return reinterpret_cast<const NivelKtx2*>(
+            arquivo_.dados() + sizeof(CabecalhoKtx2))[indice];
+    }
+
+    ArquivoMapeado arquivo_;
+};
+}  // namespace smv
+
+#endif
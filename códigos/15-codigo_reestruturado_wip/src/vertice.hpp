@@ -0,0 +1,54 @@
+#ifndef SMV_VERTICE_HPP
+#define SMV_VERTICE_HPP
+
+#include <glm/glm.hpp>
+#ifndef GLM_ENABLE_EXPERIMENTAL
+#define GLM_ENABLE_EXPERIMENTAL
+#endif
+#include <glm/gtx/hash.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include "layout_de_vertice.hpp"
+
+namespace smv {
+// Na GPU, a posição fica sozinha no fluxo 0 e o resto no fluxo
+// 1, para que os passes só de geometria não busquem os outros
+// atributos.
+constexpr uint32_t kFluxoDePosicao = 0;
+constexpr uint32_t kFluxoDeAtributos = 1;
+
+struct Vertice {
+    glm::vec3 posicao;
+    glm::vec3 cor;
+    glm::vec2 coordTex;
+
+    static constexpr auto campos() {
+        return std::make_tuple(
+            SMV_CAMPO(Vertice, posicao,
+                      vk::Format::eR32G32B32Sfloat,
+                      kFluxoDePosicao),
+            SMV_CAMPO(Vertice, cor,
+                      vk::Format::eR32G32B32Sfloat,
+                      kFluxoDeAtributos),
+            SMV_CAMPO(Vertice, coordTex,
+                      vk::Format::eR32G32Sfloat,
+                      kFluxoDeAtributos));
+    }
+};
+
+inline bool operator==(const Vertice& a, const Vertice& b) {
+    return verticesIguais(a, b);
+}
+}  // namespace smv
+
+namespace std {
+template <>
+struct hash<smv::Vertice> {
+    size_t operator()(smv::Vertice const& vertice) const {
+        return smv::hashDoVertice(vertice);
+    }
+};
+}  // namespace std
+
+#endif
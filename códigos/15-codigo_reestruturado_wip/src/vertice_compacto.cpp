@@ -0,0 +1,132 @@
+#include "vertice_compacto.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace smv {
+namespace {
+template <typename T>
+T normalizar(float valor, float minimo, float extensao) {
+    constexpr float kMaximo =
+        static_cast<float>(std::numeric_limits<T>::max());
+    if (extensao <= 0.0f) {
+        return 0;
+    }
+    float normalizado = (valor - minimo) / extensao;
+    normalizado = std::fmin(std::fmax(normalizado, 0.0f), 1.0f);
+    return static_cast<T>(std::lround(normalizado * kMaximo));
+}
+}  // namespace
+
+Dequantizacao compactarVertices(
+    const Vertice* vertices,
+    uint32_t numVertices,
+    std::vector<VerticeCompacto>& compactos) {
+    glm::vec3 minimo(std::numeric_limits<float>::max());
+    glm::vec3 maximo(std::numeric_limits<float>::lowest());
+    glm::vec2 minimoTex(std::numeric_limits<float>::max());
+    glm::vec2 maximoTex(std::numeric_limits<float>::lowest());
+    for (uint32_t i = 0; i < numVertices; i++) {
+        minimo = glm::min(minimo, vertices[i].posicao);
+        maximo = glm::max(maximo, vertices[i].posicao);
+        minimoTex = glm::min(minimoTex, vertices[i].coordTex);
+        maximoTex = glm::max(maximoTex, vertices[i].coordTex);
+    }
+    glm::vec3 extensao = maximo - minimo;
+    glm::vec2 extensaoTex = maximoTex - minimoTex;
+
+    compactos.resize(numVertices);
+    for (uint32_t i = 0; i < numVertices; i++) {
+        const auto& vertice = vertices[i];
+        auto& compacto = compactos[i];
+        for (int c = 0; c < 3; c++) {
+            compacto.posicao[static_cast<size_t>(c)] =
+                normalizar<uint16_t>(vertice.posicao[c],
+                                     minimo[c], extensao[c]);
+            compacto.cor[static_cast<size_t>(c)] =
+                normalizar<uint8_t>(vertice.cor[c], 0.0f, 1.0f);
+        }
+        compacto.posicao[3] = 0;
+        compacto.cor[3] = std::numeric_limits<uint8_t>::max();
+        for (int c = 0; c < 2; c++) {
+            compacto.coordTex[static_cast<size_t>(c)] =
+                normalizar<uint16_t>(vertice.coordTex[c],
+                                     minimoTex[c],
+                                     extensaoTex[c]);
+        }
+    }
+
+    Dequantizacao dequantizacao;
+    if (numVertices > 0) {
+        dequantizacao.escalaDaPosicao =
+            glm::vec4(extensao, 1.0f);
+        dequantizacao.minimoDaPosicao = glm::vec4(minimo, 0.0f);
+        dequantizacao.coordTex =
+            glm::vec4(extensaoTex.x, extensaoTex.y, minimoTex.x,
+                      minimoTex.y);
+    }
+    return dequantizacao;
+}
+
+namespace {
+template <typename V>
+std::vector<vk::DeviceSize> tamanhosDosFluxos() {
+    std::vector<vk::DeviceSize> tamanhos;
+    for (uint32_t i = 0; i < numAssociacoes<V>(); i++) {
+        tamanhos.push_back(tamanhoDoFluxo<V>(i));
+    }
+    return tamanhos;
+}
+
+template <typename V>
+void separarEmFluxos(const V* vertices,
+                     uint32_t numVertices,
+                     std::vector<std::vector<char>>& fluxos) {
+    fluxos.resize(numAssociacoes<V>());
+    for (uint32_t i = 0; i < numAssociacoes<V>(); i++) {
+        fluxos[i].resize(size_t{numVertices} *
+                         tamanhoDoFluxo<V>(i));
+        copiarFluxo(i, vertices, numVertices,
+                    fluxos[i].data());
+    }
+}
+}  // namespace
+
+std::vector<vk::DeviceSize> tamanhosDosFluxos(
+    FormatoDeVertice formato) {
+    return formato == FormatoDeVertice::eCompacto
+               ? tamanhosDosFluxos<VerticeCompacto>()
+               : tamanhosDosFluxos<Vertice>();
+}
+
+EntradaDeVertices entradaDoFormato(FormatoDeVertice formato) {
+    return formato == FormatoDeVertice::eCompacto
+               ? entradaDeVertices<VerticeCompacto>()
+               : entradaDeVertices<Vertice>();
+}
+
+EntradaDeVertices entradaDoFormato(
+    FormatoDeVertice formato,
+    const std::vector<uint32_t>& associacoes) {
+    return formato == FormatoDeVertice::eCompacto
+               ? entradaDeVertices<VerticeCompacto>(associacoes)
+               : entradaDeVertices<Vertice>(associacoes);
+}
+
+Dequantizacao separarEmFluxos(
+    FormatoDeVertice formato,
+    const Vertice* vertices,
+    uint32_t numVertices,
+    std::vector<std::vector<char>>& fluxos) {
+    if (formato == FormatoDeVertice::eCompleto) {
+        separarEmFluxos(vertices, numVertices, fluxos);
+        return {};
+    }
+
+    std::vector<VerticeCompacto> compactos;
+    auto dequantizacao =
+        compactarVertices(vertices, numVertices, compactos);
+    separarEmFluxos(compactos.data(), numVertices, fluxos);
+    return dequantizacao;
+}
+}  // namespace smv
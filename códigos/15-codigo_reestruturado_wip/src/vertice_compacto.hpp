@@ -0,0 +1,102 @@
+#ifndef SMV_VERTICE_COMPACTO_HPP
+#define SMV_VERTICE_COMPACTO_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "vertice.hpp"
+
+namespace smv {
+enum class FormatoDeVertice {
+    // Vertice, com 32 bytes em floats.
+    eCompleto,
+    // VerticeCompacto, com 16 bytes quantizados.
+    eCompacto,
+};
+
+// Vértice quantizado. A posição e a coordenada de textura são
+// normalizadas entre o mínimo e o máximo da malha, e voltam à
+// escala original no shader com a Dequantizacao da malha.
+struct VerticeCompacto {
+    // O quarto componente só completa o alinhamento, já que
+    // R16G16B16_UNORM raramente é suportado em vértices.
+    std::array<uint16_t, 4> posicao;
+    std::array<uint8_t, 4> cor;
+    std::array<uint16_t, 2> coordTex;
+
+    static constexpr auto campos() {
+        return std::make_tuple(
+            SMV_CAMPO(VerticeCompacto, posicao,
+                      vk::Format::eR16G16B16A16Unorm,
+                      kFluxoDePosicao),
+            SMV_CAMPO(VerticeCompacto, cor,
+                      vk::Format::eR8G8B8A8Unorm,
+                      kFluxoDeAtributos),
+            SMV_CAMPO(VerticeCompacto, coordTex,
+                      vk::Format::eR16G16Unorm,
+                      kFluxoDeAtributos));
+    }
+};
+static_assert(sizeof(VerticeCompacto) == 16,
+              "O vértice compacto deve ter metade do tamanho "
+              "do Vertice.");
+
+inline bool operator==(const VerticeCompacto& a,
+                       const VerticeCompacto& b) {
+    return verticesIguais(a, b);
+}
+
+// Vai nas push constants de cada desenho. O shader calcula
+// `normalizado * escala + minimo`, e os valores padrão deixam
+// os vértices completos como estão.
+struct Dequantizacao {
+    glm::vec4 escalaDaPosicao = glm::vec4(1.0f);
+    glm::vec4 minimoDaPosicao = glm::vec4(0.0f);
+    // xy: escala, zw: mínimo.
+    glm::vec4 coordTex = glm::vec4(1.0f, 1.0f, 0.0f, 0.0f);
+};
+
+Dequantizacao compactarVertices(
+    const Vertice* vertices,
+    uint32_t numVertices,
+    std::vector<VerticeCompacto>& compactos);
+
+inline vk::DeviceSize tamanhoDoVertice(
+    FormatoDeVertice formato) {
+    return formato == FormatoDeVertice::eCompacto
+               ? sizeof(VerticeCompacto)
+               : sizeof(Vertice);
+}
+
+// Tamanho de um vértice em cada fluxo do formato.
+std::vector<vk::DeviceSize> tamanhosDosFluxos(
+    FormatoDeVertice formato);
+
+// As descrições de entrada do formato. Com `associacoes`, só
+// as dos fluxos listados.
+EntradaDeVertices entradaDoFormato(FormatoDeVertice formato);
+EntradaDeVertices entradaDoFormato(
+    FormatoDeVertice formato,
+    const std::vector<uint32_t>& associacoes);
+
+// Converte os vértices para o formato, compactando-os se for o
+// caso, e separa cada fluxo num vetor de bytes próprio.
+Dequantizacao separarEmFluxos(
+    FormatoDeVertice formato,
+    const Vertice* vertices,
+    uint32_t numVertices,
+    std::vector<std::vector<char>>& fluxos);
+}  // namespace smv
+
+namespace std {
+template <>
+struct hash<smv::VerticeCompacto> {
+    size_t operator()(
+        smv::VerticeCompacto const& vertice) const {
+        return smv::hashDoVertice(vertice);
+    }
+};
+}  // namespace std
+
+#endif
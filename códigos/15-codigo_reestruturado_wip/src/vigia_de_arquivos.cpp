@@ -0,0 +1,109 @@
+#include "vigia_de_arquivos.hpp"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace smv {
+#ifdef __linux__
+bool VigiaDeArquivos::vigiar(const std::string& pasta) {
+    parar();
+
+    descritor_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (descritor_ < 0) {
+        return false;
+    }
+    // Editores que salvam num arquivo temporário e o renomeiam
+    // geram IN_MOVED_TO em vez de IN_CLOSE_WRITE.
+    if (inotify_add_watch(descritor_, pasta.c_str(),
+                          IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        parar();
+        return false;
+    }
+    return true;
+}
+
+void VigiaDeArquivos::parar() {
+    if (descritor_ >= 0) {
+        close(descritor_);
+        descritor_ = -1;
+    }
+}
+
+std::vector<std::string> VigiaDeArquivos::modificados() {
+    std::vector<std::string> nomes;
+    if (descritor_ < 0) {
+        return nomes;
+    }
+
+    alignas(inotify_event) char eventos[4096];
+    while (true) {
+        ssize_t lidos =
+            read(descritor_, eventos, sizeof(eventos));
+        if (lidos <= 0) {
+            break;
+        }
+        for (size_t deslocamento = 0;
+             deslocamento < static_cast<size_t>(lidos);) {
+            auto evento =
+                reinterpret_cast<const inotify_event*>(
+                    eventos + deslocamento);
+            if (evento->len > 0) {
+                std::string nome = evento->name;
+                if (std::find(nomes.begin(), nomes.end(),
+                              nome) == nomes.end()) {
+                    nomes.push_back(nome);
+                }
+            }
+            deslocamento += sizeof(inotify_event) + evento->len;
+        }
+    }
+    return nomes;
+}
+#else
+bool VigiaDeArquivos::vigiar(const std::string& pasta) {
+    std::error_code erro;
+    if (!std::filesystem::is_directory(pasta, erro)) {
+        return false;
+    }
+    pasta_ = pasta;
+    datas_.clear();
+    // A primeira consulta só registra as datas atuais.
+    modificados();
+    return true;
+}
+
+void VigiaDeArquivos::parar() {
+    pasta_.clear();
+    datas_.clear();
+}
+
+std::vector<std::string> VigiaDeArquivos::modificados() {
+    std::vector<std::string> nomes;
+    if (pasta_.empty()) {
+        return nomes;
+    }
+
+    std::error_code erro;
+    for (const auto& entrada :
+         std::filesystem::directory_iterator(pasta_, erro)) {
+        auto data = entrada.last_write_time(erro);
+        if (erro) {
+            continue;
+        }
+        auto nome = entrada.path().filename().string();
+        auto anterior = datas_.find(nome);
+        if (anterior == datas_.end()) {
+            datas_.emplace(nome, data);
+        } else if (anterior->second != data) {
+            anterior->second = data;
+            nomes.push_back(nome);
+        }
+    }
+    return nomes;
+}
+#endif
+}  // namespace smv
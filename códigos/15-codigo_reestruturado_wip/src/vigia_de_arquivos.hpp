@@ -0,0 +1,43 @@
+#ifndef SMV_VIGIA_DE_ARQUIVOS_HPP
+#define SMV_VIGIA_DE_ARQUIVOS_HPP
+
+#include <string>
+#include <vector>
+
+#ifndef __linux__
+#include <filesystem>
+#include <unordered_map>
+#endif
+
+namespace smv {
+// Avisa quais arquivos de uma pasta foram escritos. No Linux
+// usa inotify; nos outros sistemas compara as datas de
+// modificação a cada consulta.
+class VigiaDeArquivos {
+  public:
+    VigiaDeArquivos() = default;
+    VigiaDeArquivos(const VigiaDeArquivos&) = delete;
+    VigiaDeArquivos& operator=(const VigiaDeArquivos&) = delete;
+    ~VigiaDeArquivos() { parar(); }
+
+    // Retorna falso se a pasta não puder ser vigiada.
+    bool vigiar(const std::string& pasta);
+    void parar();
+
+    // Os nomes, sem a pasta, dos arquivos escritos desde a
+    // última consulta. Não bloqueia.
+    std::vector<std::string> modificados();
+
+  private:
+#ifdef __linux__
+    int descritor_ = -1;
+#else
+    std::filesystem::path pasta_;
+    std::unordered_map<std::string,
+                       std::filesystem::file_time_type>
+        datas_;
+#endif
+};
+}  // namespace smv
+
+#endif